@@ -0,0 +1,111 @@
+#include "glt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "stb_image.h"
+
+// bc_encode_bench [image] - encoder throughput in megapixels per second,
+// without an image a 2048x2048 gradient with noise is used
+
+#define SYNTHETIC_SIZE 2048
+#define MIN_SECONDS 0.5
+
+static double now_seconds(void);
+
+static unsigned char *make_synthetic(int size);
+
+int main(int argc, char **argv) {
+    int width = SYNTHETIC_SIZE, height = SYNTHETIC_SIZE;
+    unsigned char *rgba = NULL;
+    if (argc > 1) {
+        int channels = 0;
+        rgba = stbi_load(argv[1], &width, &height, &channels, 4);
+        if (!rgba) {
+            fprintf(stderr, "can't load '%s': %s\n", argv[1], stbi_failure_reason());
+            return EXIT_FAILURE;
+        }
+    } else {
+        rgba = make_synthetic(SYNTHETIC_SIZE);
+    }
+    if (!rgba) {
+        return EXIT_FAILURE;
+    }
+
+    static const struct {
+        const char *name;
+        GLenum format;
+    } formats[] = {
+        {"BC1", GL_COMPRESSED_RGB_S3TC_DXT1_EXT},
+        {"BC3", GL_COMPRESSED_RGBA_S3TC_DXT5_EXT},
+        {"BC7", GL_COMPRESSED_RGBA_BPTC_UNORM},
+    };
+    static const char *qualities[GLT_BC_QUALITY__COUNT] = {"fast", "high"};
+    static const int threads[] = {1, 0};
+
+    unsigned char *blocks = malloc(glt_bc_encoded_size(GL_COMPRESSED_RGBA_BPTC_UNORM, width, height));
+    if (!blocks) {
+        free(rgba);
+        return EXIT_FAILURE;
+    }
+
+    const double megapixels = (double) width * (double) height / 1e6;
+    printf("%dx%d (%.2f MP)\n", width, height, megapixels);
+    printf("%-6s %-6s %-8s %10s\n", "format", "mode", "threads", "MP/s");
+
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f) {
+        for (int q = 0; q < GLT_BC_QUALITY__COUNT; ++q) {
+            for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t) {
+                int runs = 0;
+                const double start = now_seconds();
+                double elapsed = 0.0;
+                do {
+                    glt_bc_encode(formats[f].format, rgba, width, height, blocks, (glt_bc_quality_e) q, threads[t]);
+                    runs++;
+                    elapsed = now_seconds() - start;
+                } while (elapsed < MIN_SECONDS);
+
+                printf(
+                    "%-6s %-6s %-8s %10.1f\n", formats[f].name, qualities[q],
+                    threads[t] == 1 ? "1" : "all", megapixels * runs / elapsed
+                );
+            }
+        }
+    }
+
+    glt_bc_shutdown();
+    free(blocks);
+    free(rgba);
+    return EXIT_SUCCESS;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static unsigned char *make_synthetic(int size) {
+    unsigned char *rgba = malloc((size_t) size * (size_t) size * 4);
+    if (!rgba) {
+        return NULL;
+    }
+
+    uint32_t seed = 0x12345678u;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            const int noise = (int) (seed >> 28) - 8;
+            unsigned char *p = rgba + ((size_t) y * (size_t) size + (size_t) x) * 4;
+            const int r = x * 255 / size + noise;
+            const int g = y * 255 / size + noise;
+            const int b = (x + y) * 127 / size;
+            p[0] = (unsigned char) (r < 0 ? 0 : r > 255 ? 255 : r);
+            p[1] = (unsigned char) (g < 0 ? 0 : g > 255 ? 255 : g);
+            p[2] = (unsigned char) b;
+            p[3] = (unsigned char) (255 - b);
+        }
+    }
+    return rgba;
+}
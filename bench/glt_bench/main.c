@@ -0,0 +1,578 @@
+#include "glt.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stb_image.h"
+
+// glt_bench [--json path] [--time seconds] [--texture path] [filter] - hot-path microbenchmarks
+// on a headless context, so it runs on llvmpipe without a display; filter keeps the benchmarks
+// whose name contains it, --json writes the results for tracking across releases
+
+#define TARGET_SIZE 256
+#define DEFAULT_SECONDS 0.5
+#define MAX_RESULTS 32
+
+#define DRAWS_PER_BATCH 1000
+#define UNIFORMS_PER_BATCH 1000
+#define UNIFORM_ARRAY_SIZE 64
+#define UPLOAD_SIZE (1024 * 1024)
+#define UPLOADS_PER_BATCH 16
+#define STREAM_RING_SIZE (8 * UPLOAD_SIZE)
+#define MATH_ELEMENTS 10000
+
+typedef struct {
+    const char *name;
+    uint64_t ops;
+    double seconds;
+    // 0 for benchmarks that don't move data
+    double bytes;
+} result_t;
+
+typedef struct {
+    result_t results[MAX_RESULTS];
+    int count;
+    double min_seconds;
+    const char *filter;
+} bench_t;
+
+// one batch of work, ops and bytes of a batch are passed to run()
+typedef void (*batch_fn)(void *ctx);
+
+typedef struct {
+    glt_shader_t *shader;
+    glt_vertex_array_t *vao;
+    glt_vertex_buffer_t *vbo;
+    GLint color_loc;
+    GLint values_loc;
+    GLfloat values[UNIFORM_ARRAY_SIZE * 4];
+} draw_ctx_t;
+
+typedef struct {
+    glt_vertex_buffer_t *buffer;
+    unsigned char *data;
+    GLintptr stream_offset;
+} buffer_ctx_t;
+
+typedef struct {
+    unsigned char *file;
+    size_t file_size;
+    unsigned char *pixels;
+    int width;
+    int height;
+    GLuint texture;
+    glt_texture_options_t options;
+} texture_ctx_t;
+
+typedef struct {
+    unsigned serial;
+} shader_ctx_t;
+
+typedef struct {
+    glt_mat4_t view_proj;
+    glt_mat4_t *matrices;
+    glt_mat4_t *out;
+    glt_vec3_t *points;
+    glt_vec3_t *transformed;
+    glt_vec3_t *translations;
+    glt_quat_t *rotations;
+    glt_vec3_t *scales;
+} math_ctx_t;
+
+static const char *vertex_src =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 a_pos;\n"
+    "void main() { gl_Position = vec4(a_pos, 0.0, 1.0); }\n";
+
+static const char *fragment_src =
+    "#version 330 core\n"
+    "uniform vec4 u_color;\n"
+    "uniform vec4 u_values[64];\n"
+    "out vec4 frag_color;\n"
+    "void main() { frag_color = u_color + u_values[int(gl_FragCoord.x) % 64]; }\n";
+
+// helper funcs
+
+static bool parse_args(int argc, char **argv, bench_t *bench, const char **json_path, const char **texture_path);
+
+static bool enabled(const bench_t *bench, const char *name);
+
+static void run(bench_t *bench, const char *name, batch_fn fn, void *ctx, uint64_t ops, double bytes);
+
+static void print_results(const bench_t *bench);
+
+static bool write_json(const bench_t *bench, const char *path);
+
+static void write_string(FILE *f, const char *s);
+
+static void draw_batch(void *ctx);
+
+static void draw_state_batch(void *ctx);
+
+static void uniform_name_batch(void *ctx);
+
+static void uniform_loc_batch(void *ctx);
+
+static void uniform_array_batch(void *ctx);
+
+static void buffer_set_data_batch(void *ctx);
+
+static void buffer_sub_data_batch(void *ctx);
+
+static void buffer_stream_batch(void *ctx);
+
+static void texture_decode_batch(void *ctx);
+
+static void texture_upload_batch(void *ctx);
+
+static void texture_load_batch(void *ctx);
+
+static void shader_build_batch(void *ctx);
+
+static void transform_points_batch(void *ctx);
+
+static void mul_array_batch(void *ctx);
+
+static void premul_array_batch(void *ctx);
+
+static void compose_trs_batch(void *ctx);
+
+static void bench_draws(bench_t *bench);
+
+static void bench_buffers(bench_t *bench);
+
+static void bench_textures(bench_t *bench, const char *path);
+
+static void bench_shaders(bench_t *bench);
+
+static void bench_math(bench_t *bench);
+
+int main(int argc, char **argv) {
+    bench_t bench = {0};
+    bench.min_seconds = DEFAULT_SECONDS;
+    const char *json_path = NULL;
+    const char *texture_path = GLT_BENCH_TEXTURE;
+    if (!parse_args(argc, argv, &bench, &json_path, &texture_path)) {
+        fprintf(stderr, "usage: %s [--json path] [--time seconds] [--texture path] [filter]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const glt_window_options_t options = {GLT_WINDOW_MODE_HEADLESS};
+    glt_window_t *window = glt_window_create_ex(TARGET_SIZE, TARGET_SIZE, "glt_bench", 4, 5, &options);
+    if (!window) {
+        window = glt_window_create_ex(TARGET_SIZE, TARGET_SIZE, "glt_bench", 3, 3, &options);
+    }
+    if (!window) {
+        fprintf(stderr, "can't create a headless context\n");
+        return EXIT_FAILURE;
+    }
+    printf("%s, %s\n", (const char *) glGetString(GL_RENDERER), (const char *) glGetString(GL_VERSION));
+
+    bench_draws(&bench);
+    bench_buffers(&bench);
+    bench_textures(&bench, texture_path);
+    bench_shaders(&bench);
+    bench_math(&bench);
+
+    print_results(&bench);
+    bool ok = true;
+    if (json_path) {
+        ok = write_json(&bench, json_path);
+    }
+
+    glt_window_destroy(window);
+    glt_bc_shutdown();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// helper funcs
+
+static bool parse_args(int argc, char **argv, bench_t *bench, const char **json_path, const char **texture_path) {
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--json") == 0 && has_value) {
+            *json_path = argv[++i];
+        } else if (strcmp(argv[i], "--time") == 0 && has_value) {
+            bench->min_seconds = atof(argv[++i]);
+            if (bench->min_seconds <= 0.0) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--texture") == 0 && has_value) {
+            *texture_path = argv[++i];
+        } else if (argv[i][0] != '-' && !bench->filter) {
+            bench->filter = argv[i];
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool enabled(const bench_t *bench, const char *name) {
+    return !bench->filter || strstr(name, bench->filter);
+}
+
+static void run(bench_t *bench, const char *name, batch_fn fn, void *ctx, uint64_t ops, double bytes) {
+    if (!enabled(bench, name) || bench->count == MAX_RESULTS) {
+        return;
+    }
+
+    // one untimed batch so first-use costs (shader variants, allocations) stay out of the numbers;
+    // each batch ends in glFinish so queued GPU work is part of its time
+    fn(ctx);
+    glFinish();
+
+    uint64_t batches = 0;
+    const double start = glt_time_now();
+    double elapsed = 0.0;
+    do {
+        fn(ctx);
+        glFinish();
+        batches++;
+        elapsed = glt_time_now() - start;
+    } while (elapsed < bench->min_seconds);
+
+    result_t *result = &bench->results[bench->count++];
+    result->name = name;
+    result->ops = batches * ops;
+    result->seconds = elapsed;
+    result->bytes = (double) batches * bytes;
+}
+
+static void print_results(const bench_t *bench) {
+    printf("%-24s %14s %12s %12s\n", "benchmark", "ops/s", "ns/op", "MB/s");
+    for (int i = 0; i < bench->count; ++i) {
+        const result_t *r = &bench->results[i];
+        printf("%-24s %14.1f %12.1f", r->name, (double) r->ops / r->seconds, r->seconds * 1e9 / (double) r->ops);
+        if (r->bytes > 0.0) {
+            printf(" %12.1f\n", r->bytes / r->seconds / 1e6);
+        } else {
+            printf(" %12s\n", "-");
+        }
+    }
+}
+
+static bool write_json(const bench_t *bench, const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "can't open '%s' for writing\n", path);
+        return false;
+    }
+
+    fprintf(f, "{\n  \"benchmark\": \"glt_bench\",\n  \"renderer\": ");
+    write_string(f, (const char *) glGetString(GL_RENDERER));
+    fprintf(f, ",\n  \"gl_version\": ");
+    write_string(f, (const char *) glGetString(GL_VERSION));
+    fprintf(f, ",\n  \"min_seconds\": %g,\n  \"results\": [\n", bench->min_seconds);
+
+    for (int i = 0; i < bench->count; ++i) {
+        const result_t *r = &bench->results[i];
+        fprintf(f, "    {\"name\": ");
+        write_string(f, r->name);
+        fprintf(
+            f, ", \"iterations\": %llu, \"seconds\": %.6f, \"ops_per_second\": %.3f, \"ns_per_op\": %.3f",
+            (unsigned long long) r->ops, r->seconds, (double) r->ops / r->seconds, r->seconds * 1e9 / (double) r->ops
+        );
+        if (r->bytes > 0.0) {
+            fprintf(f, ", \"mb_per_second\": %.3f", r->bytes / r->seconds / 1e6);
+        }
+        fprintf(f, "}%s\n", i + 1 < bench->count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+
+    const bool ok = !ferror(f);
+    if (fclose(f) != 0 || !ok) {
+        fprintf(stderr, "failed to write '%s'\n", path);
+        return false;
+    }
+    return true;
+}
+
+static void write_string(FILE *f, const char *s) {
+    fputc('"', f);
+    for (; s && *s; ++s) {
+        const unsigned char c = (unsigned char) *s;
+        if (c == '"' || c == '\\') {
+            fputc('\\', f);
+            fputc(c, f);
+        } else if (c < 0x20) {
+            fprintf(f, "\\u%04x", c);
+        } else {
+            fputc(c, f);
+        }
+    }
+    fputc('"', f);
+}
+
+static void draw_batch(void *ctx) {
+    const draw_ctx_t *draw = ctx;
+    glt_shader_use(draw->shader);
+    glt_vertex_array_bind(draw->vao);
+    for (int i = 0; i < DRAWS_PER_BATCH; ++i) {
+        glt_draw_arrays(GL_TRIANGLES, 0, 3);
+    }
+}
+
+static void draw_state_batch(void *ctx) {
+    const draw_ctx_t *draw = ctx;
+    for (int i = 0; i < DRAWS_PER_BATCH; ++i) {
+        glt_shader_use(draw->shader);
+        glt_vertex_array_bind(draw->vao);
+        glt_shader_set_vec4_loc(draw->shader, draw->color_loc, (GLfloat) i, 0.f, 0.f, 1.f);
+        glt_draw_arrays(GL_TRIANGLES, 0, 3);
+    }
+}
+
+static void uniform_name_batch(void *ctx) {
+    const draw_ctx_t *draw = ctx;
+    for (int i = 0; i < UNIFORMS_PER_BATCH; ++i) {
+        glt_shader_set_vec4(draw->shader, "u_color", (GLfloat) i, 0.f, 0.f, 1.f);
+    }
+}
+
+static void uniform_loc_batch(void *ctx) {
+    const draw_ctx_t *draw = ctx;
+    for (int i = 0; i < UNIFORMS_PER_BATCH; ++i) {
+        glt_shader_set_vec4_loc(draw->shader, draw->color_loc, (GLfloat) i, 0.f, 0.f, 1.f);
+    }
+}
+
+static void uniform_array_batch(void *ctx) {
+    draw_ctx_t *draw = ctx;
+    for (int i = 0; i < UNIFORMS_PER_BATCH / UNIFORM_ARRAY_SIZE; ++i) {
+        draw->values[0] = (GLfloat) i;
+        glt_shader_set_vec4_array_loc(draw->shader, draw->values_loc, UNIFORM_ARRAY_SIZE, draw->values);
+    }
+}
+
+static void buffer_set_data_batch(void *ctx) {
+    buffer_ctx_t *buffer = ctx;
+    for (int i = 0; i < UPLOADS_PER_BATCH; ++i) {
+        buffer->data[0] = (unsigned char) i;
+        glt_vertex_buffer_set_data(buffer->buffer, buffer->data, UPLOAD_SIZE);
+    }
+}
+
+static void buffer_sub_data_batch(void *ctx) {
+    buffer_ctx_t *buffer = ctx;
+    for (int i = 0; i < UPLOADS_PER_BATCH; ++i) {
+        buffer->data[0] = (unsigned char) i;
+        glt_vertex_buffer_set_sub_data(buffer->buffer, 0, buffer->data, UPLOAD_SIZE);
+    }
+}
+
+static void buffer_stream_batch(void *ctx) {
+    // a ring written through unsynchronized mappings, orphaned on wrap
+    buffer_ctx_t *buffer = ctx;
+    glt_vertex_buffer_bind(buffer->buffer);
+    for (int i = 0; i < UPLOADS_PER_BATCH; ++i) {
+        if (buffer->stream_offset + UPLOAD_SIZE > STREAM_RING_SIZE) {
+            glBufferData(GL_ARRAY_BUFFER, STREAM_RING_SIZE, NULL, GL_STREAM_DRAW);
+            buffer->stream_offset = 0;
+        }
+        void *dst = glMapBufferRange(
+            GL_ARRAY_BUFFER, buffer->stream_offset, UPLOAD_SIZE,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT
+        );
+        if (dst) {
+            memcpy(dst, buffer->data, UPLOAD_SIZE);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        buffer->stream_offset += UPLOAD_SIZE;
+    }
+    glt_vertex_buffer_unbind();
+}
+
+static void texture_decode_batch(void *ctx) {
+    const texture_ctx_t *texture = ctx;
+    int width = 0, height = 0, channels = 0;
+    stbi_image_free(stbi_load_from_memory(texture->file, (int) texture->file_size, &width, &height, &channels, 4));
+}
+
+static void texture_upload_batch(void *ctx) {
+    const texture_ctx_t *texture = ctx;
+    glBindTexture(GL_TEXTURE_2D, texture->texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture->width, texture->height, GL_RGBA, GL_UNSIGNED_BYTE, texture->pixels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+static void texture_load_batch(void *ctx) {
+    const texture_ctx_t *texture = ctx;
+    glt_texture_destroy(glt_texture_load_from_memory_ex(texture->file, texture->file_size, &texture->options));
+}
+
+static void shader_build_batch(void *ctx) {
+    // a new constant each time so driver shader caches can't answer from the last build
+    shader_ctx_t *shader = ctx;
+    char src[512];
+    snprintf(
+        src, sizeof(src),
+        "#version 330 core\n"
+        "out vec4 frag_color;\n"
+        "void main() { frag_color = vec4(%u.0 / 4294967295.0, gl_FragCoord.xy / 256.0, 1.0); }\n",
+        shader->serial++
+    );
+    glt_shader_destroy(glt_shader_prog_create_src(vertex_src, src));
+}
+
+static void transform_points_batch(void *ctx) {
+    math_ctx_t *math = ctx;
+    glt_mat4_transform_points(&math->view_proj, math->points, math->transformed, MATH_ELEMENTS);
+}
+
+static void mul_array_batch(void *ctx) {
+    math_ctx_t *math = ctx;
+    glt_mat4_mul_array(math->matrices, math->matrices, math->out, MATH_ELEMENTS);
+}
+
+static void premul_array_batch(void *ctx) {
+    math_ctx_t *math = ctx;
+    glt_mat4_premul_array(&math->view_proj, math->matrices, math->out, MATH_ELEMENTS);
+}
+
+static void compose_trs_batch(void *ctx) {
+    math_ctx_t *math = ctx;
+    glt_mat4_compose_trs_array(math->translations, math->rotations, math->scales, math->out, MATH_ELEMENTS);
+}
+
+static void bench_draws(bench_t *bench) {
+    // one-pixel triangles keep rasterization out of the submission numbers
+    const GLfloat px = 2.f / TARGET_SIZE;
+    const GLfloat vertices[] = {-1.f, -1.f, -1.f + px, -1.f, -1.f, -1.f + px};
+
+    draw_ctx_t draw = {0};
+    draw.shader = glt_shader_prog_create_src(vertex_src, fragment_src);
+    draw.vao = glt_vertex_array_create();
+    draw.vbo = glt_vertex_buffer_create(vertices, sizeof(vertices), GL_STATIC_DRAW);
+    if (!draw.shader || !draw.vao || !draw.vbo) {
+        fprintf(stderr, "can't create draw resources, skipping draw and uniform benchmarks\n");
+    } else {
+        glt_vertex_array_attrib_pointerf(draw.vao, draw.vbo, 0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), NULL);
+        draw.color_loc = glt_shader_get_uniform_loc(draw.shader, "u_color");
+        draw.values_loc = glt_shader_get_uniform_loc(draw.shader, "u_values");
+
+        run(bench, "draw_calls", draw_batch, &draw, DRAWS_PER_BATCH, 0.0);
+        run(bench, "draw_calls_state_change", draw_state_batch, &draw, DRAWS_PER_BATCH, 0.0);
+        run(bench, "uniform_by_name", uniform_name_batch, &draw, UNIFORMS_PER_BATCH, 0.0);
+        run(bench, "uniform_by_location", uniform_loc_batch, &draw, UNIFORMS_PER_BATCH, 0.0);
+        // ops are vec4s here too, so the three uniform rates compare directly
+        run(
+            bench, "uniform_batched", uniform_array_batch, &draw,
+            UNIFORMS_PER_BATCH / UNIFORM_ARRAY_SIZE * UNIFORM_ARRAY_SIZE, 0.0
+        );
+    }
+
+    glt_vertex_buffer_destroy(draw.vbo);
+    glt_vertex_array_destroy(draw.vao);
+    glt_shader_destroy(draw.shader);
+}
+
+static void bench_buffers(bench_t *bench) {
+    buffer_ctx_t buffer = {0};
+    buffer.data = calloc(UPLOAD_SIZE, 1);
+    buffer.buffer = glt_vertex_buffer_create(NULL, UPLOAD_SIZE, GL_DYNAMIC_DRAW);
+    glt_vertex_buffer_t *ring = glt_vertex_buffer_create(NULL, STREAM_RING_SIZE, GL_STREAM_DRAW);
+    if (!buffer.data || !buffer.buffer || !ring) {
+        fprintf(stderr, "can't create buffers, skipping buffer benchmarks\n");
+    } else {
+        const double bytes = (double) UPLOAD_SIZE * UPLOADS_PER_BATCH;
+        run(bench, "buffer_set_data", buffer_set_data_batch, &buffer, UPLOADS_PER_BATCH, bytes);
+        run(bench, "buffer_sub_data", buffer_sub_data_batch, &buffer, UPLOADS_PER_BATCH, bytes);
+
+        buffer_ctx_t stream = buffer;
+        stream.buffer = ring;
+        run(bench, "buffer_streaming", buffer_stream_batch, &stream, UPLOADS_PER_BATCH, bytes);
+    }
+
+    glt_vertex_buffer_destroy(ring);
+    glt_vertex_buffer_destroy(buffer.buffer);
+    free(buffer.data);
+}
+
+static void bench_textures(bench_t *bench, const char *path) {
+    texture_ctx_t texture = {0};
+    FILE *f = fopen(path, "rb");
+    if (f) {
+        fseek(f, 0, SEEK_END);
+        const long size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        texture.file = size > 0 ? malloc((size_t) size) : NULL;
+        if (texture.file && fread(texture.file, 1, (size_t) size, f) == (size_t) size) {
+            texture.file_size = (size_t) size;
+        }
+        fclose(f);
+    }
+    int channels = 0;
+    if (texture.file_size > 0) {
+        texture.pixels = stbi_load_from_memory(
+            texture.file, (int) texture.file_size, &texture.width, &texture.height, &channels, 4
+        );
+    }
+    if (!texture.pixels) {
+        fprintf(stderr, "can't load '%s', skipping texture benchmarks\n", path);
+        free(texture.file);
+        return;
+    }
+
+    glGenTextures(1, &texture.texture);
+    glBindTexture(GL_TEXTURE_2D, texture.texture);
+    // glTexStorage2D needs 4.2, the upload target must also exist on the 3.3 fallback context
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, texture.width, texture.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    const double bytes = (double) texture.width * (double) texture.height * 4.0;
+    run(bench, "texture_decode", texture_decode_batch, &texture, 1, bytes);
+    run(bench, "texture_upload", texture_upload_batch, &texture, 1, bytes);
+    run(bench, "texture_load", texture_load_batch, &texture, 1, bytes);
+    texture.options.compression = GLT_TEXTURE_COMPRESSION_BC1;
+    run(bench, "texture_load_bc1", texture_load_batch, &texture, 1, bytes);
+
+    glDeleteTextures(1, &texture.texture);
+    stbi_image_free(texture.pixels);
+    free(texture.file);
+}
+
+static void bench_shaders(bench_t *bench) {
+    shader_ctx_t shader = {0};
+    run(bench, "shader_compile_link", shader_build_batch, &shader, 1, 0.0);
+}
+
+static void bench_math(bench_t *bench) {
+    math_ctx_t math = {0};
+    math.matrices = malloc(MATH_ELEMENTS * sizeof(glt_mat4_t));
+    math.out = malloc(MATH_ELEMENTS * sizeof(glt_mat4_t));
+    math.points = malloc(MATH_ELEMENTS * sizeof(glt_vec3_t));
+    math.transformed = malloc(MATH_ELEMENTS * sizeof(glt_vec3_t));
+    math.translations = malloc(MATH_ELEMENTS * sizeof(glt_vec3_t));
+    math.rotations = malloc(MATH_ELEMENTS * sizeof(glt_quat_t));
+    math.scales = malloc(MATH_ELEMENTS * sizeof(glt_vec3_t));
+    if (!math.matrices || !math.out || !math.points || !math.transformed
+        || !math.translations || !math.rotations || !math.scales) {
+        fprintf(stderr, "can't allocate math arrays, skipping math benchmarks\n");
+    } else {
+        glt_mat4_perspective(60.f * GLT_DEG2RAD, 1.f, 0.1f, 100.f, &math.view_proj);
+        for (int i = 0; i < MATH_ELEMENTS; ++i) {
+            const float f = (float) i / MATH_ELEMENTS;
+            math.translations[i] = (glt_vec3_t) {f, 1.f - f, f * 0.5f};
+            math.rotations[i] = glt_quat_from_axis_angle((glt_vec3_t) {f, 1.f, 0.5f}, f * GLT_PI);
+            math.scales[i] = (glt_vec3_t) {1.f, 1.f + f, 1.f};
+            math.points[i] = math.translations[i];
+        }
+        glt_mat4_compose_trs_array(math.translations, math.rotations, math.scales, math.matrices, MATH_ELEMENTS);
+
+        run(bench, "math_transform_points", transform_points_batch, &math, MATH_ELEMENTS, 0.0);
+        run(bench, "math_mat4_mul_array", mul_array_batch, &math, MATH_ELEMENTS, 0.0);
+        run(bench, "math_mat4_premul_array", premul_array_batch, &math, MATH_ELEMENTS, 0.0);
+        run(bench, "math_compose_trs", compose_trs_batch, &math, MATH_ELEMENTS, 0.0);
+    }
+
+    free(math.scales);
+    free(math.rotations);
+    free(math.translations);
+    free(math.transformed);
+    free(math.points);
+    free(math.out);
+    free(math.matrices);
+}
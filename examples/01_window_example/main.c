@@ -12,6 +12,8 @@
 
 #define BG_COLOR GLT_WHITE
 
+#define STATS_INTERVAL 1.0
+
 int main() {
     int exit_code = EXIT_SUCCESS;
     glt_window_t *window = NULL;
@@ -29,6 +31,9 @@ int main() {
 
     glt_window_set_clear_color(GLT_UNPACK_COLOR(BG_COLOR), 1.f);
 
+    glt_frame_clock_t *clock = glt_window_get_clock(window);
+    double next_stats = STATS_INTERVAL;
+
     while (!glt_window_should_close(window)) {
         glt_window_process_input(window);
 
@@ -36,6 +41,16 @@ int main() {
 
         glt_window_swap_buffers(window);
         glt_window_poll_events();
+
+        if (glt_frame_clock_get_time(clock) >= next_stats) {
+            glt_frame_stats_t stats;
+            glt_frame_clock_get_stats(clock, &stats);
+            glt_log(
+                GLT_LOG_INFO, "%.1f fps, frame min %.2f / avg %.2f / p99 %.2f ms",
+                stats.fps, stats.min_ms, stats.avg_ms, stats.p99_ms
+            );
+            next_stats += STATS_INTERVAL;
+        }
     }
 
 cleanup:
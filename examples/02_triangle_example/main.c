@@ -105,7 +105,7 @@ int main() {
 
         glt_shader_use(shader);
         glt_vertex_array_bind(vao);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glt_draw_arrays(GL_TRIANGLES, 0, 3);
         glt_vertex_array_unbind();
 
         glt_window_swap_buffers(window);
@@ -97,12 +97,11 @@ int main() {
         glt_window_process_input(window);
         glt_window_clear();
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, glt_texture_get_id(texture));
+        glt_texture_bind(texture, 0);
 
         glt_shader_use(shader);
         glt_vertex_array_bind(vao);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glt_draw_arrays(GL_TRIANGLES, 0, 3);
         glt_vertex_array_unbind();
 
         glt_window_swap_buffers(window);
@@ -4,7 +4,28 @@
 #include "glt_vertex_buffer.h"
 #include "glt_vertex_array.h"
 #include "glt_shader.h"
+#include "glt_draw.h"
+#include "glt_framebuffer.h"
+#include "glt_render_graph.h"
+#include "glt_dynamic_resolution.h"
+#include "glt_capture.h"
 #include "glt_window.h"
+#include "glt_time.h"
+#include "glt_gpu_profiler.h"
+#include "glt_trace.h"
+#include "glt_stats.h"
+#include "glt_sampler.h"
 #include "glt_texture.h"
+#include "glt_texture_loader.h"
+#include "glt_texture_cache.h"
+#include "glt_texture_streamer.h"
+#include "glt_uploader.h"
+#include "glt_atlas.h"
+#include "glt_bundle.h"
+#include "glt_bc.h"
+#include "glt_image.h"
 #include "glt_color.h"
+#include "glt_math.h"
+#include "glt_hierarchy.h"
+#include "glt_debug.h"
 #include "glt_log.h"
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "glad/glad.h"
+
+// packs many images into the layers of one GL_TEXTURE_2D_ARRAY (sampler2DArray in GLSL,
+// sample with vec3(uv, layer))
+
+typedef struct glt_atlas_t glt_atlas_t;
+
+typedef struct {
+    GLsizei page_size; // width and height of each layer, 0 -> 2048
+    GLsizei padding;   // edge pixels extruded around every image, also bounds the mip count
+    GLint max_pages;   // 0 -> GL_MAX_ARRAY_TEXTURE_LAYERS
+} glt_atlas_desc_t;
+
+typedef struct {
+    GLuint texture;
+    GLint layer;
+    GLfloat u0, v0;
+    GLfloat u1, v1;
+    GLsizei width;
+    GLsizei height;
+} glt_atlas_region_t;
+
+// desc may be NULL for the defaults (2048, 4 px padding)
+glt_atlas_t *glt_atlas_create(const glt_atlas_desc_t *desc);
+
+void glt_atlas_destroy(glt_atlas_t *atlas);
+
+// images are kept on the CPU until glt_atlas_build, returns the region index or -1
+int glt_atlas_add_path(glt_atlas_t *atlas, const char *path);
+
+int glt_atlas_add_pixels(glt_atlas_t *atlas, const unsigned char *rgba, GLsizei width, GLsizei height);
+
+// packs every added image, uploads the pages and frees the CPU copies; on failure the images are kept
+bool glt_atlas_build(glt_atlas_t *atlas);
+
+// valid after glt_atlas_build
+const glt_atlas_region_t *glt_atlas_get_region(const glt_atlas_t *atlas, int index);
+
+int glt_atlas_get_region_count(const glt_atlas_t *atlas);
+
+GLuint glt_atlas_get_texture(const glt_atlas_t *atlas);
+
+GLint glt_atlas_get_page_count(const glt_atlas_t *atlas);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "glad/glad.h"
+
+// CPU block-compression codecs, surfaces are RGBA8 with rows in storage order
+
+// S3TC enums are extension-only, glad is generated for core 4.6
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT 0x8C4E
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+typedef enum {
+    GLT_BC_QUALITY_FAST = 0,
+    GLT_BC_QUALITY_HIGH,
+    GLT_BC_QUALITY__COUNT
+} glt_bc_quality_e;
+
+// S3TC (BC1-3) and unsigned RGTC (BC4/5)
+bool glt_bc_can_decode(GLenum format);
+
+// BC1 without punch-through alpha, BC3 and BC7 (mode 6 only), linear and sRGB
+bool glt_bc_can_encode(GLenum format);
+
+size_t glt_bc_encoded_size(GLenum format, GLsizei width, GLsizei height);
+
+// rgba receives width * height * 4 bytes, BC4/5 decode to (r, 0, 0, 255) / (r, g, 0, 255)
+bool glt_bc_decode(GLenum format, const unsigned char *src, GLsizei width, GLsizei height, unsigned char *rgba);
+
+// dst receives glt_bc_encoded_size bytes; edge blocks repeat the last row / column;
+// n_threads <= 0 uses every core, 1 encodes on the calling thread only; helpers come from a
+// worker pool shared by all calls and started on first use
+bool glt_bc_encode(
+    GLenum format, const unsigned char *rgba, GLsizei width, GLsizei height,
+    unsigned char *dst, glt_bc_quality_e quality, int n_threads
+);
+
+// joins the shared worker pool; call before exit or unloading the library, a later encode starts it again
+void glt_bc_shutdown(void);
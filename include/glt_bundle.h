@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "glad/glad.h"
+#include "glt_shader.h"
+#include "glt_texture.h"
+#include "glt_vertex_buffer.h"
+
+// read-only asset bundle written by the glt_pack tool; the file is memory mapped
+// and uploads read straight from the mapping
+
+typedef struct glt_bundle_t glt_bundle_t;
+
+typedef enum {
+    GLT_BUNDLE_BLOB = 0,
+    GLT_BUNDLE_TEXTURE,
+    GLT_BUNDLE_SHADER,
+    GLT_BUNDLE_VERTICES,
+    GLT_BUNDLE_INDICES,
+    GLT_BUNDLE__COUNT
+} glt_bundle_entry_type_e;
+
+typedef struct {
+    const char *name;
+    glt_bundle_entry_type_e type;
+    // points into the mapping, valid until glt_bundle_close
+    const void *data;
+    size_t size;
+    // texture internal format, shader stage or index type
+    GLenum format;
+    GLsizei width;
+    GLsizei height;
+    GLint levels;
+} glt_bundle_entry_t;
+
+glt_bundle_t *glt_bundle_open(const char *path);
+
+void glt_bundle_close(glt_bundle_t *bundle);
+
+size_t glt_bundle_get_entry_count(const glt_bundle_t *bundle);
+
+bool glt_bundle_get_entry(const glt_bundle_t *bundle, size_t index, glt_bundle_entry_t *out);
+
+bool glt_bundle_find(const glt_bundle_t *bundle, const char *name, glt_bundle_entry_t *out);
+
+// stored mips are uploaded as they are, options == NULL means defaults
+glt_texture_t *glt_bundle_load_texture(const glt_bundle_t *bundle, const char *name, const glt_texture_options_t *options);
+
+// returns a compiled shader object of the entry's stage, 0 on failure
+GLuint glt_bundle_compile_shader(const glt_bundle_t *bundle, const char *name);
+
+glt_shader_t *glt_bundle_load_shader(const glt_bundle_t *bundle, const char *vertex_name, const char *fragment_name);
+
+// vertex and index entries; any entry's bytes can back a buffer
+glt_vertex_buffer_t *glt_bundle_load_buffer(const glt_bundle_t *bundle, const char *name, GLenum usage);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "glt_window.h"
+
+// reads the window's back buffer into a ring of pixel buffers and maps each one only once its
+// fence signaled, frames later; encoding and file writes run on a background thread, so
+// capturing never waits on the GPU or the disk
+
+typedef struct glt_capture_t glt_capture_t;
+
+typedef enum {
+    GLT_CAPTURE_PNG = 0,
+    // RGBA8 rows top to bottom without a header; sequences go to one file, ffmpeg's rawvideo input
+    GLT_CAPTURE_RAW,
+    GLT_CAPTURE__COUNT
+} glt_capture_format_e;
+
+// zero-initialized options are the defaults
+typedef struct {
+    // pixel buffers in flight, 0 means 3
+    int ring_size;
+    // frames waiting for the encoder before sequence frames get dropped, 0 means 8
+    int max_pending;
+} glt_capture_options_t;
+
+typedef struct {
+    uint64_t captured;
+    // sequence frames skipped because the ring or the encoder was full
+    uint64_t dropped;
+    uint64_t written;
+    uint64_t failed;
+} glt_capture_stats_t;
+
+// options == NULL means defaults; needs the window's context current
+glt_capture_t *glt_capture_create(glt_window_t *window, const glt_capture_options_t *options);
+
+// finishes every pending capture first
+void glt_capture_destroy(glt_capture_t *capture);
+
+// captures the next frame passed to glt_capture_frame into path
+bool glt_capture_screenshot(glt_capture_t *capture, const char *path, glt_capture_format_e format);
+
+// captures every frame until stopped; PNG paths hold exactly one %d conversion for the frame index
+// ("shots/frame_%05d.png", %% for a literal percent sign), raw frames are appended to the one file at path
+bool glt_capture_start_sequence(glt_capture_t *capture, const char *path, glt_capture_format_e format);
+
+void glt_capture_stop_sequence(glt_capture_t *capture);
+
+bool glt_capture_is_recording(const glt_capture_t *capture);
+
+// call once per frame after rendering and before glt_window_swap_buffers
+void glt_capture_frame(glt_capture_t *capture);
+
+// blocks until everything captured so far is written
+void glt_capture_flush(glt_capture_t *capture);
+
+void glt_capture_get_stats(const glt_capture_t *capture, glt_capture_stats_t *stats);
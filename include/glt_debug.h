@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "glad/glad.h"
+
+// routes KHR_debug output (OpenGL 4.3) into glt_log; each message id is logged a few times and
+// then muted in the driver, and a per-second budget caps bursts, so a message repeated every draw
+// never turns the callback into a hot spot. Groups and labels show up in captures (RenderDoc,
+// apitrace) and work without a debug context; every helper is a no-op below OpenGL 4.3
+
+// zero-initialized options are the defaults
+typedef struct {
+    // GL_DEBUG_SEVERITY_NOTIFICATION / LOW / MEDIUM / HIGH, 0 means GL_DEBUG_SEVERITY_LOW
+    GLenum min_severity;
+    // times one message id is logged before it gets muted, 0 means 3
+    int max_repeats;
+    // messages logged per second over all ids, 0 means 50
+    int max_per_second;
+    // messages arrive inside the offending call (slower, but a breakpoint in a sink shows the stack)
+    bool synchronous;
+} glt_debug_options_t;
+
+// for the current context, which should be a debug context (glt_window_options_t.debug);
+// options == NULL means defaults; the repeat counts start over, driver mutes don't carry across contexts
+bool glt_debug_enable(const glt_debug_options_t *options);
+
+void glt_debug_disable(void);
+
+// mutes the ids that reached max_repeats in the current context; glt_window_swap_buffers calls it
+void glt_debug_end_frame(void);
+
+// messages not logged because of max_repeats or max_per_second
+uint64_t glt_debug_get_suppressed(void);
+
+void glt_debug_push_group(const char *name);
+
+void glt_debug_pop_group(void);
+
+// identifier is GL_TEXTURE, GL_BUFFER, GL_PROGRAM, GL_SHADER, GL_FRAMEBUFFER, GL_VERTEX_ARRAY, ...
+void glt_debug_label(GLenum identifier, GLuint name, const char *label);
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "glad/glad.h"
+
+// thin wrappers over the glDraw* calls that feed the draw counters in glt_stats
+
+void glt_draw_arrays(GLenum mode, GLint first, GLsizei count);
+
+void glt_draw_arrays_instanced(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+
+// offset is in bytes into the bound element buffer
+void glt_draw_elements(GLenum mode, GLsizei count, GLenum type, size_t offset);
+
+void glt_draw_elements_instanced(GLenum mode, GLsizei count, GLenum type, size_t offset, GLsizei instances);
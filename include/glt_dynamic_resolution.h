@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "glad/glad.h"
+#include "glt_framebuffer.h"
+#include "glt_window.h"
+
+// renders the scene into an offscreen target at a fraction of the window's framebuffer size and
+// upscales it into the window; the fraction follows the scene's GPU time, dropping as soon as it
+// runs over budget and climbing back slowly once there is headroom, so it doesn't oscillate
+
+typedef struct glt_dynamic_resolution_t glt_dynamic_resolution_t;
+
+typedef enum {
+    // both are one fullscreen pass whose taps are clamped to the rendered region
+    GLT_UPSCALE_BILINEAR = 0,
+    // bilinear plus a 5-tap sharpen clamped to the neighbourhood
+    GLT_UPSCALE_SHARPEN,
+    GLT_UPSCALE__COUNT
+} glt_upscale_filter_e;
+
+// zero-initialized options are the defaults
+typedef struct {
+    // GPU budget of the scene, 0 means 1000 / 60 ms
+    double target_ms;
+    // per-axis scale range, 0 means 0.5 and 1
+    float min_scale;
+    float max_scale;
+    // the scale only grows while the GPU time stays below target_ms * (1 - headroom), 0 means 0.15
+    float headroom;
+    // frames between two scale changes, covering the frames the GPU timings lag behind; 0 means 8
+    int cooldown_frames;
+    glt_upscale_filter_e filter;
+    // GLT_UPSCALE_SHARPEN strength in (0, 1], 0 means 0.5
+    float sharpness;
+    // 0 means GL_RGBA8 and GL_DEPTH24_STENCIL8
+    GLenum color_format;
+    GLenum depth_format;
+} glt_dynamic_resolution_options_t;
+
+// options == NULL means defaults; needs the window's context current
+glt_dynamic_resolution_t *glt_dynamic_resolution_create(glt_window_t *window, const glt_dynamic_resolution_options_t *options);
+
+void glt_dynamic_resolution_destroy(glt_dynamic_resolution_t *dynres);
+
+// adapts the scale to the latest GPU timings and the window's framebuffer size, binds the scene
+// target with the viewport covering the render size and starts timing
+void glt_dynamic_resolution_begin(glt_dynamic_resolution_t *dynres);
+
+// clears the render area only, glClear would cover the whole target
+void glt_dynamic_resolution_clear(const glt_dynamic_resolution_t *dynres, float r, float g, float b, float a);
+
+// stops timing and upscales into the window's framebuffer, which is left bound with a full viewport
+void glt_dynamic_resolution_end(glt_dynamic_resolution_t *dynres);
+
+// adaptive by default; disabling keeps the current scale
+void glt_dynamic_resolution_set_adaptive(glt_dynamic_resolution_t *dynres, bool adaptive);
+
+// clamped to the options' range
+void glt_dynamic_resolution_set_scale(glt_dynamic_resolution_t *dynres, float scale);
+
+float glt_dynamic_resolution_get_scale(const glt_dynamic_resolution_t *dynres);
+
+void glt_dynamic_resolution_get_render_size(const glt_dynamic_resolution_t *dynres, int *width, int *height);
+
+// smoothed GPU time of the scene, 0 until the first timings are back
+double glt_dynamic_resolution_get_gpu_ms(const glt_dynamic_resolution_t *dynres);
+
+// sized for max_scale; only the render size region at the origin holds the frame
+const glt_framebuffer_t *glt_dynamic_resolution_get_framebuffer(const glt_dynamic_resolution_t *dynres);
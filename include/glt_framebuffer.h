@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "glad/glad.h"
+#include "glt_sampler.h"
+#include "glt_texture.h"
+
+// render targets with optional MSAA; multisampled framebuffers draw into renderbuffers and are
+// resolved with a blit into single-sampled attachments, which are the ones that get sampled
+
+#define GLT_FRAMEBUFFER_MAX_COLOR 4
+
+typedef struct glt_framebuffer_t glt_framebuffer_t;
+
+// recycles attachments between framebuffers and across resizes, keyed by format, size and samples
+typedef struct glt_framebuffer_pool_t glt_framebuffer_pool_t;
+
+typedef struct {
+    // sized internal format (GL_RGBA8, GL_DEPTH24_STENCIL8, ...), 0 leaves the attachment out
+    GLenum format;
+    // renderbuffers can't be sampled but skip the texture setup; multisampled attachments always are
+    bool renderbuffer;
+    // contents are only needed during the pass: dropped by glt_framebuffer_discard and not resolved
+    bool transient;
+} glt_attachment_desc_t;
+
+typedef struct {
+    GLsizei width;
+    GLsizei height;
+    // values <= 1 disable MSAA, larger ones are clamped to GL_MAX_SAMPLES
+    GLsizei samples;
+    glt_attachment_desc_t color[GLT_FRAMEBUFFER_MAX_COLOR];
+    // depth or depth-stencil format
+    glt_attachment_desc_t depth;
+    // for the textures returned by glt_framebuffer_get_texture
+    glt_sampler_desc_t sampler;
+} glt_framebuffer_desc_t;
+
+// pool may be NULL, the framebuffer then owns its attachments; a pool has to outlive its framebuffers
+glt_framebuffer_t *glt_framebuffer_create(const glt_framebuffer_desc_t *desc, glt_framebuffer_pool_t *pool);
+
+void glt_framebuffer_destroy(glt_framebuffer_t *framebuffer);
+
+// swaps every attachment for one of the new size, contents are lost; the framebuffer objects stay
+bool glt_framebuffer_resize(glt_framebuffer_t *framebuffer, GLsizei width, GLsizei height);
+
+// binds for drawing and sets the viewport; NULL binds framebuffer 0, headless windows draw
+// into glt_window_get_framebuffer instead
+void glt_framebuffer_bind(const glt_framebuffer_t *framebuffer);
+
+// clears every color attachment to the color and depth / stencil to 1 / 0
+void glt_framebuffer_clear(const glt_framebuffer_t *framebuffer, float r, float g, float b, float a);
+
+// blits the multisampled attachments into the sampled ones and invalidates the former,
+// no-op without MSAA; leaves the framebuffer bound for drawing
+void glt_framebuffer_resolve(glt_framebuffer_t *framebuffer);
+
+// invalidates the transient attachments, call once the pass no longer needs them so tiled GPUs
+// skip writing them back; needs GL 4.3 or ARB_invalidate_subdata, no-op otherwise
+void glt_framebuffer_discard(const glt_framebuffer_t *framebuffer);
+
+// blits resolved color attachment 0 into dst_fbo scaled to dst_width x dst_height, leaves dst_fbo bound
+void glt_framebuffer_blit(
+    const glt_framebuffer_t *framebuffer, GLuint dst_fbo, GLsizei dst_width, GLsizei dst_height, GLenum filter
+);
+
+// same for the src_width x src_height region at the origin
+void glt_framebuffer_blit_region(
+    const glt_framebuffer_t *framebuffer, GLsizei src_width, GLsizei src_height,
+    GLuint dst_fbo, GLsizei dst_width, GLsizei dst_height, GLenum filter
+);
+
+// resolved color attachment, NULL for renderbuffers and missing attachments; owned by the framebuffer
+// and replaced by glt_framebuffer_resize
+const glt_texture_t *glt_framebuffer_get_texture(const glt_framebuffer_t *framebuffer, int index);
+
+const glt_texture_t *glt_framebuffer_get_depth_texture(const glt_framebuffer_t *framebuffer);
+
+// the framebuffer drawn into, multisampled with MSAA
+GLuint glt_framebuffer_get_id(const glt_framebuffer_t *framebuffer);
+
+GLsizei glt_framebuffer_get_width(const glt_framebuffer_t *framebuffer);
+
+GLsizei glt_framebuffer_get_height(const glt_framebuffer_t *framebuffer);
+
+GLsizei glt_framebuffer_get_samples(const glt_framebuffer_t *framebuffer);
+
+// attachments idle for more than max_idle_frames pool frames are deleted, 0 means 2
+glt_framebuffer_pool_t *glt_framebuffer_pool_create(unsigned max_idle_frames);
+
+// deletes the idle attachments, framebuffers using the pool must be destroyed first
+void glt_framebuffer_pool_destroy(glt_framebuffer_pool_t *pool);
+
+// call once per frame: ages idle attachments and deletes the expired ones
+void glt_framebuffer_pool_end_frame(glt_framebuffer_pool_t *pool);
+
+// idle attachments waiting for reuse
+size_t glt_framebuffer_pool_get_count(const glt_framebuffer_pool_t *pool);
+
+size_t glt_framebuffer_pool_get_memory_size(const glt_framebuffer_pool_t *pool);
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "glad/glad.h"
+
+#define GLT_GPU_PROFILER_FRAMES_DEFAULT 4
+#define GLT_GPU_PROFILER_SCOPES_DEFAULT 64
+#define GLT_GPU_PROFILER_MAX_DEPTH 16
+
+// times named GPU scopes with GL_TIMESTAMP queries; results are read back frames later,
+// only once the driver reports them available, so profiling never stalls the pipeline
+
+typedef struct glt_gpu_profiler_t glt_gpu_profiler_t;
+
+// per-frame totals of a scope, accumulated over every harvested frame it appeared in
+typedef struct {
+    const char *name;
+    uint64_t frames;
+    uint64_t calls;
+    double last_ms;
+    // exponential moving average
+    double avg_ms;
+    double min_ms;
+    double max_ms;
+} glt_gpu_scope_stats_t;
+
+// one scope instance of a harvested frame, times relative to the frame's start
+typedef struct {
+    const char *name;
+    int depth;
+    double start_ms;
+    double duration_ms;
+} glt_gpu_event_t;
+
+// frames_in_flight and max_scopes <= 0 use the defaults; needs a current context
+glt_gpu_profiler_t *glt_gpu_profiler_create(int frames_in_flight, int max_scopes);
+
+void glt_gpu_profiler_destroy(glt_gpu_profiler_t *profiler);
+
+// disabled profilers issue no queries, toggling takes effect at the next frame
+void glt_gpu_profiler_set_enabled(glt_gpu_profiler_t *profiler, bool enabled);
+
+// harvests finished frames, then starts recording a new one
+void glt_gpu_profiler_begin_frame(glt_gpu_profiler_t *profiler);
+
+void glt_gpu_profiler_end_frame(glt_gpu_profiler_t *profiler);
+
+// scopes nest; names are copied on first use and may come from temporary buffers
+void glt_gpu_profiler_push(glt_gpu_profiler_t *profiler, const char *name);
+
+void glt_gpu_profiler_pop(glt_gpu_profiler_t *profiler);
+
+size_t glt_gpu_profiler_get_scope_count(const glt_gpu_profiler_t *profiler);
+
+bool glt_gpu_profiler_get_scope(const glt_gpu_profiler_t *profiler, size_t index, glt_gpu_scope_stats_t *stats);
+
+// events of the most recently harvested frame in submission order, valid until the next begin_frame
+const glt_gpu_event_t *glt_gpu_profiler_get_timeline(const glt_gpu_profiler_t *profiler, size_t *count);
+
+// index of the frame the timeline belongs to, counting begin_frame calls; UINT64_MAX before the first
+uint64_t glt_gpu_profiler_get_timeline_frame(const glt_gpu_profiler_t *profiler);
+
+// when the timeline's frame started on the GPU, converted to glt_time_now seconds
+double glt_gpu_profiler_get_timeline_start(const glt_gpu_profiler_t *profiler);
+
+// GPU time from begin_frame to end_frame of the most recently harvested frame
+double glt_gpu_profiler_get_frame_ms(const glt_gpu_profiler_t *profiler);
+
+// frames whose queries weren't available when their slot came around again
+uint64_t glt_gpu_profiler_get_dropped_frames(const glt_gpu_profiler_t *profiler);
+
+void glt_gpu_profiler_print_timeline(const glt_gpu_profiler_t *profiler, FILE *out);
+
+void glt_gpu_profiler_print_stats(const glt_gpu_profiler_t *profiler, FILE *out);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "glad/glad.h"
+#include "glt_math.h"
+
+// parent / child transforms stored as arrays per component in depth-first order, so a parent
+// always precedes its children; setting a local transform flags the node and its ancestors, and
+// glt_hierarchy_update skips every subtree without changes, recomputing only the flagged nodes
+// and their descendants. Local matrices are composed in batches over runs of dirty nodes
+
+typedef struct glt_hierarchy_t glt_hierarchy_t;
+
+// stable for the node's lifetime, ids of removed nodes get reused
+typedef int glt_node_t;
+
+#define GLT_NODE_NONE (-1)
+
+// capacity is a hint, 0 means 1024
+glt_hierarchy_t *glt_hierarchy_create(int capacity);
+
+void glt_hierarchy_destroy(glt_hierarchy_t *hierarchy);
+
+// identity local transform; parent == GLT_NODE_NONE adds a root
+glt_node_t glt_hierarchy_add(glt_hierarchy_t *hierarchy, glt_node_t parent);
+
+// removes the node and its subtree; every id in it is invalid at once and gets reused after the next update
+void glt_hierarchy_remove(glt_hierarchy_t *hierarchy, glt_node_t node);
+
+// keeps the local transform, so the world transform follows the new parent; fails on cycles
+bool glt_hierarchy_set_parent(glt_hierarchy_t *hierarchy, glt_node_t node, glt_node_t parent);
+
+glt_node_t glt_hierarchy_get_parent(const glt_hierarchy_t *hierarchy, glt_node_t node);
+
+bool glt_hierarchy_is_valid(const glt_hierarchy_t *hierarchy, glt_node_t node);
+
+void glt_hierarchy_set_local(
+    glt_hierarchy_t *hierarchy, glt_node_t node, glt_vec3_t translation, glt_quat_t rotation, glt_vec3_t scale
+);
+
+void glt_hierarchy_set_translation(glt_hierarchy_t *hierarchy, glt_node_t node, glt_vec3_t translation);
+
+void glt_hierarchy_set_rotation(glt_hierarchy_t *hierarchy, glt_node_t node, glt_quat_t rotation);
+
+void glt_hierarchy_set_scale(glt_hierarchy_t *hierarchy, glt_node_t node, glt_vec3_t scale);
+
+void glt_hierarchy_get_local(
+    const glt_hierarchy_t *hierarchy, glt_node_t node, glt_vec3_t *translation, glt_quat_t *rotation, glt_vec3_t *scale
+);
+
+// brings the world matrices up to date, returns how many were recomputed
+int glt_hierarchy_update(glt_hierarchy_t *hierarchy);
+
+// as of the last update; NULL for invalid nodes
+const glt_mat4_t *glt_hierarchy_get_world(const glt_hierarchy_t *hierarchy, glt_node_t node);
+
+// live nodes
+int glt_hierarchy_get_count(const glt_hierarchy_t *hierarchy);
+
+// highest id + 1, the number of matrices an output indexed by node id has to hold
+int glt_hierarchy_get_id_count(const glt_hierarchy_t *hierarchy);
+
+// the two outputs below index by node id and only see world matrices that changed since either
+// of them was last called, so use one of them once per frame after glt_hierarchy_update
+
+// writes the changed matrices to out[node], e.g. persistently mapped instance memory; returns how many
+int glt_hierarchy_write_changed(glt_hierarchy_t *hierarchy, glt_mat4_t *out);
+
+// uploads the changed matrices to buffer at offset + node * sizeof(glt_mat4_t) with one write over
+// the changed id range; the buffer holds glt_hierarchy_get_id_count matrices
+// and the GL_COPY_WRITE_BUFFER binding is left as it was
+bool glt_hierarchy_upload(glt_hierarchy_t *hierarchy, GLuint buffer, GLintptr offset);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// CPU pixel kernels on 8-bit channels with tightly packed rows,
+// SSSE3 / AVX2 variants are picked at runtime from what the CPU supports
+
+typedef enum {
+    GLT_IMAGE_SIMD_NONE = 0,
+    GLT_IMAGE_SIMD_SSSE3,
+    GLT_IMAGE_SIMD_AVX2,
+    GLT_IMAGE_SIMD__COUNT
+} glt_image_simd_e;
+
+typedef enum {
+    GLT_IMAGE_FILTER_BOX = 0,
+    GLT_IMAGE_FILTER_LANCZOS3,
+    GLT_IMAGE_FILTER__COUNT
+} glt_image_filter_e;
+
+glt_image_simd_e glt_image_get_simd(void);
+
+// caps the kernels in use (levels the CPU lacks are ignored), not thread safe against running kernels
+void glt_image_set_simd(glt_image_simd_e max_level);
+
+void glt_image_flip_vertical(unsigned char *pixels, int width, int height, int channels);
+
+// count pixels, buffers must not overlap
+void glt_image_rgb_to_rgba(const unsigned char *rgb, unsigned char *rgba, size_t count);
+
+void glt_image_premultiply_alpha(unsigned char *rgba, size_t count);
+
+// count channel values, alpha included if it's in the buffer
+void glt_image_srgb_to_linear(const unsigned char *src, float *dst, size_t count);
+
+void glt_image_linear_to_srgb(const float *src, unsigned char *dst, size_t count);
+
+// largest size within max_size x max_size with the same aspect ratio, never upscales
+void glt_image_fit(int width, int height, int max_size, int *out_width, int *out_height);
+
+// RGBA8 only; srgb filters color in linear light, alpha is always linear; returns a malloc'd image
+unsigned char *glt_image_resize(
+    const unsigned char *rgba, int width, int height,
+    int dst_width, int dst_height, glt_image_filter_e filter, bool srgb
+);
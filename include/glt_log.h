@@ -1,5 +1,9 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 typedef enum {
     GLT_LOG_INFO = 0,
     GLT_LOG_WARNING,
@@ -8,4 +12,50 @@ typedef enum {
     GLT_LOG__COUNT
 } glt_log_level_e;
 
-void glt_log(glt_log_level_e level, const char *msg, ...);
\ No newline at end of file
+// messages below this level compile away together with their arguments, FATAL is always kept
+#ifndef GLT_LOG_MIN_LEVEL
+#define GLT_LOG_MIN_LEVEL GLT_LOG_INFO
+#endif
+
+// longer messages are truncated
+#define GLT_LOG_MESSAGE_SIZE 512
+
+#define glt_log(level, ...) \
+    do { \
+        if ((level) >= GLT_LOG_MIN_LEVEL || (level) == GLT_LOG_FATAL) { \
+            glt_log_write((level), __VA_ARGS__); \
+        } \
+    } while (0)
+
+// message without the level prefix or a newline, called from the logging thread in async mode;
+// sinks must not log themselves
+typedef void (*glt_log_sink_fn)(glt_log_level_e level, const char *message, void *user);
+
+// use glt_log; FATAL flushes every sink and exits
+#if defined(__GNUC__)
+__attribute__((format(printf, 2, 3)))
+#endif
+void glt_log_write(glt_log_level_e level, const char *msg, ...);
+
+// INFO / WARNING to stdout, ERROR / FATAL to stderr; on by default
+void glt_log_set_console(bool enabled);
+
+// appends to path, NULL closes the current file
+bool glt_log_set_file(const char *path);
+
+bool glt_log_add_sink(glt_log_sink_fn sink, void *user);
+
+void glt_log_remove_sink(glt_log_sink_fn sink, void *user);
+
+// from here on messages go through a lock-free ring of capacity records (0 means 1024, rounded
+// up to a power of two) that a background thread drains into the sinks; full rings drop messages
+bool glt_log_start_async(size_t capacity);
+
+// drains the ring and joins the thread, messages are written synchronously again; runs at exit
+void glt_log_stop_async(void);
+
+// blocks until every message logged before the call reached the sinks
+void glt_log_flush(void);
+
+// messages lost to a full ring
+uint64_t glt_log_get_dropped(void);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stddef.h>
+
 #define GLT_PI 3.14159265358979323846f
 #define GLT_DEG2RAD (GLT_PI / 180.f)
 #define GLT_RAD2DEG (180.f / GLT_PI)
@@ -22,6 +24,20 @@ typedef struct {
     float w;
 } glt_vec4_t;
 
+// x, y, z vector part and w scalar part, normalized for rotations
+typedef struct {
+    _Alignas(16) float x;
+    float y;
+    float z;
+    float w;
+} glt_quat_t;
+
+// column-major like GLSL, m[column][row], so &m.m[0][0] goes straight to glt_shader_set_mat4;
+// aligned for the SIMD paths, which load whole columns
+typedef struct {
+    _Alignas(16) float m[4][4];
+} glt_mat4_t;
+
 typedef struct {
     float pos[3];
     float color[3];
@@ -30,4 +46,61 @@ typedef struct {
 
 float glt_clamp(float val, float min_val, float max_val);
 
-float glt_lepr(float a, float b, float t);
\ No newline at end of file
+float glt_lepr(float a, float b, float t);
+
+// matrix and quaternion functions run on cglm's SSE / NEON paths where the target has them;
+// outputs may alias inputs
+
+void glt_mat4_identity(glt_mat4_t *out);
+
+void glt_mat4_mul(const glt_mat4_t *a, const glt_mat4_t *b, glt_mat4_t *out);
+
+// general inverse, no check for singular matrices
+void glt_mat4_inverse(const glt_mat4_t *m, glt_mat4_t *out);
+
+void glt_mat4_transpose(const glt_mat4_t *m, glt_mat4_t *out);
+
+// translation * rotation * scale
+void glt_mat4_from_trs(const glt_vec3_t *translation, const glt_quat_t *rotation, const glt_vec3_t *scale, glt_mat4_t *out);
+
+// right-handed with depth in [-1, 1], like OpenGL; fovy in radians
+void glt_mat4_perspective(float fovy, float aspect, float near_z, float far_z, glt_mat4_t *out);
+
+void glt_mat4_look_at(const glt_vec3_t *eye, const glt_vec3_t *center, const glt_vec3_t *up, glt_mat4_t *out);
+
+// w = 1, no perspective divide
+glt_vec3_t glt_mat4_transform_point(const glt_mat4_t *m, glt_vec3_t point);
+
+glt_quat_t glt_quat_identity(void);
+
+// axis doesn't need to be normalized, angle in radians
+glt_quat_t glt_quat_from_axis_angle(glt_vec3_t axis, float angle);
+
+// rotates by b first, then by a
+glt_quat_t glt_quat_mul(glt_quat_t a, glt_quat_t b);
+
+glt_quat_t glt_quat_normalize(glt_quat_t q);
+
+glt_quat_t glt_quat_slerp(glt_quat_t a, glt_quat_t b, float t);
+
+void glt_quat_to_mat4(glt_quat_t q, glt_mat4_t *out);
+
+// batch versions for thousands of elements per call: the loop stays inside glt with the constant
+// operand's columns kept in registers; in and out may be the same array
+
+// out[i] = m * (in[i], 1), no perspective divide
+void glt_mat4_transform_points(const glt_mat4_t *m, const glt_vec3_t *in, glt_vec3_t *out, size_t count);
+
+// out[i] = m * in[i]
+void glt_mat4_transform_vec4s(const glt_mat4_t *m, const glt_vec4_t *in, glt_vec4_t *out, size_t count);
+
+// out[i] = a[i] * b[i]
+void glt_mat4_mul_array(const glt_mat4_t *a, const glt_mat4_t *b, glt_mat4_t *out, size_t count);
+
+// out[i] = a * b[i], e.g. view-projection times model matrices
+void glt_mat4_premul_array(const glt_mat4_t *a, const glt_mat4_t *b, glt_mat4_t *out, size_t count);
+
+// out[i] = translation[i] * rotation[i] * scale[i] from separate arrays; scale == NULL means 1
+void glt_mat4_compose_trs_array(
+    const glt_vec3_t *translation, const glt_quat_t *rotation, const glt_vec3_t *scale, glt_mat4_t *out, size_t count
+);
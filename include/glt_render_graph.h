@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "glad/glad.h"
+#include "glt_framebuffer.h"
+#include "glt_texture.h"
+
+// passes declare what they read and write each frame; executing the graph culls passes nothing
+// depends on, hands transient resources with disjoint lifetimes the same texture / buffer and
+// issues glMemoryBarrier only where shader image / storage writes are read afterwards
+
+typedef struct glt_render_graph_t glt_render_graph_t;
+
+// per-frame handles, -1 is invalid
+typedef int glt_rg_resource_t;
+
+typedef int glt_rg_pass_t;
+
+typedef enum {
+    // draws into the color / depth attachments it writes, bound as one framebuffer
+    GLT_RG_PASS_RASTER = 0,
+    GLT_RG_PASS_COMPUTE,
+    GLT_RG_PASS__COUNT
+} glt_rg_pass_type_e;
+
+typedef enum {
+    GLT_RG_USAGE_SAMPLED = 0,
+    GLT_RG_USAGE_COLOR_ATTACHMENT,
+    GLT_RG_USAGE_DEPTH_ATTACHMENT,
+    // image load / store
+    GLT_RG_USAGE_STORAGE_IMAGE,
+    GLT_RG_USAGE_STORAGE_BUFFER,
+    GLT_RG_USAGE_UNIFORM_BUFFER,
+    GLT_RG_USAGE_VERTEX_BUFFER,
+    GLT_RG_USAGE_INDEX_BUFFER,
+    GLT_RG_USAGE_INDIRECT_BUFFER,
+    // glBufferSubData, glCopy*, glReadPixels and friends
+    GLT_RG_USAGE_TRANSFER,
+    GLT_RG_USAGE__COUNT
+} glt_rg_usage_e;
+
+typedef struct {
+    GLsizei width;
+    GLsizei height;
+    // sized internal format
+    GLenum format;
+} glt_rg_texture_desc_t;
+
+typedef void (*glt_rg_execute_fn)(glt_render_graph_t *graph, void *user);
+
+typedef struct {
+    size_t passes;
+    size_t culled_passes;
+    size_t resources;
+    // textures and buffers backing the transient resources
+    size_t textures;
+    size_t buffers;
+    size_t memory_size;
+    size_t barriers;
+} glt_render_graph_info_t;
+
+glt_render_graph_t *glt_render_graph_create(void);
+
+void glt_render_graph_destroy(glt_render_graph_t *graph);
+
+// drops the last frame's passes and resources, keeps their storage for reuse
+void glt_render_graph_reset(glt_render_graph_t *graph);
+
+// names aren't copied and have to outlive the frame
+glt_rg_resource_t glt_render_graph_create_texture(glt_render_graph_t *graph, const char *name, const glt_rg_texture_desc_t *desc);
+
+glt_rg_resource_t glt_render_graph_create_buffer(glt_render_graph_t *graph, const char *name, GLsizeiptr size);
+
+// imported resources live outside the graph, passes writing them are never culled
+glt_rg_resource_t glt_render_graph_import_texture(glt_render_graph_t *graph, const char *name, const glt_texture_t *texture);
+
+glt_rg_resource_t glt_render_graph_import_buffer(glt_render_graph_t *graph, const char *name, GLuint buffer);
+
+// passes run in the order they are added
+glt_rg_pass_t glt_render_graph_add_pass(
+    glt_render_graph_t *graph, const char *name, glt_rg_pass_type_e type, glt_rg_execute_fn execute, void *user
+);
+
+void glt_render_graph_read(glt_render_graph_t *graph, glt_rg_pass_t pass, glt_rg_resource_t resource, glt_rg_usage_e usage);
+
+// color attachments get GL_COLOR_ATTACHMENT0 + i in the order the pass declares their writes
+void glt_render_graph_write(glt_render_graph_t *graph, glt_rg_pass_t pass, glt_rg_resource_t resource, glt_rg_usage_e usage);
+
+// keeps a pass that works outside the graph (drawing to the window, readbacks) from being culled
+void glt_render_graph_set_side_effects(glt_render_graph_t *graph, glt_rg_pass_t pass);
+
+// culls, assigns storage and runs the live passes; raster passes with attachments find their
+// framebuffer bound and the viewport set, others the framebuffer that was bound before
+bool glt_render_graph_execute(glt_render_graph_t *graph);
+
+// the texture / buffer behind a resource, valid during the passes between its first and last use
+const glt_texture_t *glt_render_graph_get_texture(const glt_render_graph_t *graph, glt_rg_resource_t resource);
+
+GLuint glt_render_graph_get_buffer(const glt_render_graph_t *graph, glt_rg_resource_t resource);
+
+// of the last execute
+void glt_render_graph_get_info(const glt_render_graph_t *graph, glt_render_graph_info_t *info);
+
+// passes with their state and accesses, resources with their lifetime and storage
+void glt_render_graph_print(const glt_render_graph_t *graph, FILE *out);
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "glad/glad.h"
+
+typedef enum {
+    GLT_SAMPLER_FILTER_TRILINEAR = 0,
+    GLT_SAMPLER_FILTER_BILINEAR,
+    GLT_SAMPLER_FILTER_NEAREST,
+    GLT_SAMPLER_FILTER__COUNT
+} glt_sampler_filter_e;
+
+typedef enum {
+    GLT_SAMPLER_WRAP_REPEAT = 0,
+    GLT_SAMPLER_WRAP_CLAMP_TO_EDGE,
+    GLT_SAMPLER_WRAP_MIRRORED_REPEAT,
+    GLT_SAMPLER_WRAP__COUNT
+} glt_sampler_wrap_e;
+
+// zero-initialized desc is repeat + trilinear without anisotropy
+typedef struct {
+    glt_sampler_filter_e filter;
+    glt_sampler_wrap_e wrap;
+    // values <= 1 disable anisotropic filtering, larger ones are clamped to the GL maximum
+    float anisotropy;
+} glt_sampler_desc_t;
+
+// one shared sampler object per unique desc, NULL means defaults; owned by the cache, don't delete
+GLuint glt_sampler_get(const glt_sampler_desc_t *desc);
+
+// samplers are cached per share group, the one of the context current on the calling thread;
+// glt_window_t sets it with its context, call this when making contexts current by other means
+void glt_sampler_set_group(const void *group);
+
+const void *glt_sampler_get_group(void);
+
+// deletes the current group's samplers, must run while one of its contexts is still current
+void glt_sampler_cache_clear(void);
+
+size_t glt_sampler_cache_get_count(void);
@@ -57,6 +57,10 @@ void glt_shader_set_vec3_loc(const glt_shader_t *shader, GLint loc, GLfloat x, G
 void glt_shader_set_vec4(const glt_shader_t* shader, const char* name, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
 void glt_shader_set_vec4_loc(const glt_shader_t* shader, GLint loc, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
 
+// count vec4s from values, one upload for the whole uniform array
+void glt_shader_set_vec4_array(const glt_shader_t *shader, const char *name, GLsizei count, const GLfloat *values);
+void glt_shader_set_vec4_array_loc(const glt_shader_t *shader, GLint loc, GLsizei count, const GLfloat *values);
+
 // matrices (float)
 
 void glt_shader_set_mat2(const glt_shader_t *shader, const char *name, const GLfloat *m2x2);
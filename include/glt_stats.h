@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+// submission counters incremented by the glt modules, snapshotted once per frame by
+// glt_window_swap_buffers, plus live counts of the GL objects glt created
+
+typedef enum {
+    GLT_STAT_DRAW_CALLS = 0,
+    GLT_STAT_VERTICES,
+    GLT_STAT_INSTANCES,
+    GLT_STAT_PROGRAM_BINDS,
+    GLT_STAT_VERTEX_ARRAY_BINDS,
+    GLT_STAT_BUFFER_BINDS,
+    GLT_STAT_TEXTURE_BINDS,
+    GLT_STAT_UNIFORM_UPLOADS,
+    GLT_STAT_BUFFER_UPLOADS,
+    GLT_STAT_BUFFER_UPLOAD_BYTES,
+    GLT_STAT_TEXTURE_UPLOADS,
+    GLT_STAT_TEXTURE_UPLOAD_BYTES,
+    GLT_STAT__COUNT
+} glt_stat_e;
+
+typedef enum {
+    GLT_RESOURCE_BUFFER = 0,
+    GLT_RESOURCE_VERTEX_ARRAY,
+    GLT_RESOURCE_TEXTURE,
+    GLT_RESOURCE_PROGRAM,
+    GLT_RESOURCE_RENDERBUFFER,
+    GLT_RESOURCE_FRAMEBUFFER,
+    GLT_RESOURCE__COUNT
+} glt_resource_e;
+
+typedef struct {
+    uint64_t counters[GLT_STAT__COUNT];
+} glt_frame_counters_t;
+
+// bytes are estimates of GPU storage, 0 for objects without storage of their own
+typedef struct {
+    int64_t count;
+    int64_t bytes;
+} glt_resource_usage_t;
+
+// counters are relaxed atomics, safe to bump from any thread
+void glt_stats_add(glt_stat_e stat, uint64_t value);
+
+void glt_stats_track_resource(glt_resource_e resource, int64_t count, int64_t bytes);
+
+// moves the running counters into the last-frame snapshot and resets them
+void glt_stats_end_frame(void);
+
+// counters of the last completed frame
+void glt_stats_get_frame(glt_frame_counters_t *counters);
+
+// counters of the frame in progress
+void glt_stats_get_current(glt_frame_counters_t *counters);
+
+uint64_t glt_stats_get(glt_stat_e stat);
+
+void glt_stats_get_resource(glt_resource_e resource, glt_resource_usage_t *usage);
+
+const char *glt_stats_get_name(glt_stat_e stat);
+
+const char *glt_stats_get_resource_name(glt_resource_e resource);
+
+// last frame's counters and the live resources
+void glt_stats_print(FILE *out);
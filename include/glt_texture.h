@@ -1,15 +1,80 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #include "glad/glad.h"
+#include "glt_bc.h"
+#include "glt_sampler.h"
 
 typedef struct glt_texture_t glt_texture_t;
 
+typedef enum {
+    GLT_TEXTURE_READY = 0,
+    GLT_TEXTURE_PENDING,
+    GLT_TEXTURE_FAILED,
+    GLT_TEXTURE__COUNT
+} glt_texture_state_e;
+
+typedef enum {
+    GLT_TEXTURE_COMPRESSION_NONE = 0,
+    // BC1 for opaque images, BC3 otherwise
+    GLT_TEXTURE_COMPRESSION_AUTO,
+    GLT_TEXTURE_COMPRESSION_BC1,
+    GLT_TEXTURE_COMPRESSION_BC3,
+    GLT_TEXTURE_COMPRESSION_BC7,
+    GLT_TEXTURE_COMPRESSION__COUNT
+} glt_texture_compression_e;
+
+// zero-initialized options are the glt_texture_load defaults
+typedef struct {
+    // 0 builds the full chain; stored container chains are only ever truncated
+    GLint mip_levels;
+    // decoded RGB(A) images only, containers keep their stored format
+    bool srgb;
+    // decoded images larger than this are downscaled before upload, 0 keeps the full size
+    GLsizei max_size;
+    bool premultiply_alpha;
+    // decoded RGB(A) images are block-compressed on the CPU, mips included; falls back
+    // to RGBA8 if the driver lacks the format
+    glt_texture_compression_e compression;
+    glt_bc_quality_e compression_quality;
+    glt_sampler_desc_t sampler;
+} glt_texture_options_t;
+
+// KTX2 / DDS files upload their stored mip chain as is; their rows aren't flipped
+// like decoded images are, so they keep the container's top-left origin
 glt_texture_t *glt_texture_load(const char *path);
 
+glt_texture_t *glt_texture_load_from_memory(const void *data, size_t size);
+
+// storage is immutable on OpenGL 4.2+, options == NULL means defaults
+glt_texture_t *glt_texture_load_ex(const char *path, const glt_texture_options_t *options);
+
+glt_texture_t *glt_texture_load_from_memory_ex(const void *data, size_t size, const glt_texture_options_t *options);
+
+// textures acquired from a glt_texture_cache_t are released instead
 void glt_texture_destroy(glt_texture_t *texture);
 
+// while the texture is pending, returns the id of its loader's placeholder
 GLuint glt_texture_get_id(const glt_texture_t *texture);
 
+// shared sampler from glt_sampler_get, texture objects carry no sampling state of their own
+GLuint glt_texture_get_sampler(const glt_texture_t *texture);
+
+// binds texture and sampler to the unit; NULL clears the unit
+void glt_texture_bind(const glt_texture_t *texture, GLuint unit);
+
+// binds count textures to consecutive units starting at first with one call each for textures and samplers
+void glt_texture_bind_many(const glt_texture_t *const *textures, GLuint first, GLsizei count);
+
 GLsizei glt_texture_get_width(const glt_texture_t *texture);
 
 GLsizei glt_texture_get_height(const glt_texture_t *texture);
+
+glt_texture_state_e glt_texture_get_state(const glt_texture_t *texture);
+
+bool glt_texture_is_ready(const glt_texture_t *texture);
+
+// estimated GPU memory of the whole mip chain, 0 while pending
+size_t glt_texture_get_memory_size(const glt_texture_t *texture);
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "glt_texture.h"
+
+// shares textures by canonical path; unreferenced textures stay resident until the
+// cache exceeds its budget, then the least recently released ones are destroyed.
+// every acquire returns its own handle onto the shared GL texture
+
+typedef struct glt_texture_cache_t glt_texture_cache_t;
+
+// budget is in bytes of estimated GPU memory, 0 keeps nothing unreferenced
+glt_texture_cache_t *glt_texture_cache_create(size_t budget);
+
+// destroys every cached texture, including ones still referenced
+void glt_texture_cache_destroy(glt_texture_cache_t *cache);
+
+// adds a reference, loads on a miss; release with glt_texture_cache_release or glt_texture_destroy
+glt_texture_t *glt_texture_cache_acquire(glt_texture_cache_t *cache, const char *path);
+
+// NULL options are the zero-initialized defaults; options that change the pixels are cached
+// separately, the sampler only applies to the returned handle
+glt_texture_t *glt_texture_cache_acquire_ex(
+    glt_texture_cache_t *cache, const char *path, const glt_texture_options_t *options
+);
+
+void glt_texture_cache_release(glt_texture_cache_t *cache, glt_texture_t *texture);
+
+void glt_texture_cache_set_budget(glt_texture_cache_t *cache, size_t budget);
+
+// destroys unreferenced textures until usage fits the budget
+void glt_texture_cache_trim(glt_texture_cache_t *cache);
+
+size_t glt_texture_cache_get_usage(const glt_texture_cache_t *cache);
+
+size_t glt_texture_cache_get_count(const glt_texture_cache_t *cache);
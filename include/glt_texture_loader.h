@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "glt_texture.h"
+
+#define GLT_TEXTURE_UPLOAD_BUDGET_DEFAULT ((size_t) 8 << 20)
+
+// decodes images on a worker pool and uploads them through a pixel unpack buffer
+// from glt_texture_loader_update, which must be called on the GL thread
+
+typedef struct glt_texture_loader_t glt_texture_loader_t;
+
+// n_threads <= 0 picks a default, upload_budget == 0 uses GLT_TEXTURE_UPLOAD_BUDGET_DEFAULT
+glt_texture_loader_t *glt_texture_loader_create(int n_threads, size_t upload_budget);
+
+// textures still pending become GLT_TEXTURE_FAILED
+void glt_texture_loader_destroy(glt_texture_loader_t *loader);
+
+// returned texture is owned by the caller and is pending until uploaded
+glt_texture_t *glt_texture_load_async(glt_texture_loader_t *loader, const char *path);
+
+// uploads at most upload_budget bytes of decoded pixels, call once per frame
+void glt_texture_loader_update(glt_texture_loader_t *loader);
+
+void glt_texture_loader_set_budget(glt_texture_loader_t *loader, size_t upload_budget);
+
+size_t glt_texture_loader_get_pending(const glt_texture_loader_t *loader);
+
+GLuint glt_texture_loader_get_placeholder(const glt_texture_loader_t *loader);
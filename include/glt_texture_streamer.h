@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "glt_texture.h"
+
+#define GLT_TEXTURE_STREAM_BUDGET_DEFAULT ((size_t) 256 << 20)
+
+// streams mip levels on demand: a texture becomes ready with its coarse levels, finer ones are
+// uploaded once they are requested for a large enough screen size, and textures holding levels
+// finer than they were last requested for lose them when resident memory exceeds the budget;
+// glt_texture_streamer_update must be called on the GL thread
+
+typedef struct glt_texture_streamer_t glt_texture_streamer_t;
+
+// n_threads <= 0 picks a default, budget == 0 uses GLT_TEXTURE_STREAM_BUDGET_DEFAULT
+glt_texture_streamer_t *glt_texture_streamer_create(int n_threads, size_t budget);
+
+// pending textures become GLT_TEXTURE_FAILED, ready ones keep the levels they have
+void glt_texture_streamer_destroy(glt_texture_streamer_t *streamer);
+
+// decoded images keep their mip chain in memory to stream it again after eviction; KTX2 / DDS
+// stream their stored chain; compression is ignored; the texture id changes whenever the
+// storage is resized, so query it every frame
+glt_texture_t *glt_texture_stream(
+    glt_texture_streamer_t *streamer, const char *path, const glt_texture_options_t *options
+);
+
+// size in pixels the texture covers on screen this frame, the largest request per frame wins
+void glt_texture_streamer_request(
+    glt_texture_streamer_t *streamer, glt_texture_t *texture, float screen_width, float screen_height
+);
+
+// uploads requested levels within the upload budget and evicts over the residency budget, call once per frame
+void glt_texture_streamer_update(glt_texture_streamer_t *streamer);
+
+void glt_texture_streamer_set_budget(glt_texture_streamer_t *streamer, size_t budget);
+
+// 0 uses GLT_TEXTURE_UPLOAD_BUDGET_DEFAULT
+void glt_texture_streamer_set_upload_budget(glt_texture_streamer_t *streamer, size_t upload_budget);
+
+// bytes of GPU storage held by streamed textures
+size_t glt_texture_streamer_get_usage(const glt_texture_streamer_t *streamer);
+
+size_t glt_texture_streamer_get_pending(const glt_texture_streamer_t *streamer);
+
+GLuint glt_texture_streamer_get_placeholder(const glt_texture_streamer_t *streamer);
+
+// finest level that can be sampled, 0 is full resolution; -1 while pending
+GLint glt_texture_streamer_get_resident_level(const glt_texture_t *texture);
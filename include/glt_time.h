@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GLT_FRAME_CLOCK_SAMPLES 240
+#define GLT_FIXED_STEP_MAX_DEFAULT 8
+
+// monotonic seconds from an arbitrary origin
+double glt_time_now(void);
+
+// same clock in nanoseconds
+uint64_t glt_time_now_ns(void);
+
+// sleeps while the OS scheduler can be trusted to wake up in time, then spins to the deadline;
+// the margin adapts to the overshoot observed on this thread
+void glt_time_sleep_until(double deadline);
+
+void glt_time_sleep(double seconds);
+
+typedef struct glt_frame_clock_t glt_frame_clock_t;
+
+// frame times in milliseconds over the last GLT_FRAME_CLOCK_SAMPLES frames
+typedef struct {
+    double min_ms;
+    double avg_ms;
+    double p99_ms;
+    double max_ms;
+    double fps;
+    size_t samples;
+} glt_frame_stats_t;
+
+glt_frame_clock_t *glt_frame_clock_create(void);
+
+void glt_frame_clock_destroy(glt_frame_clock_t *clock);
+
+// ends a frame: waits out the frame limit if one is set, returns the seconds since the previous tick
+double glt_frame_clock_tick(glt_frame_clock_t *clock);
+
+// frames per second, 0 disables the limiter; meant for running without vsync
+void glt_frame_clock_set_limit(glt_frame_clock_t *clock, double fps);
+
+double glt_frame_clock_get_limit(const glt_frame_clock_t *clock);
+
+double glt_frame_clock_get_delta(const glt_frame_clock_t *clock);
+
+// seconds since the clock was created
+double glt_frame_clock_get_time(const glt_frame_clock_t *clock);
+
+uint64_t glt_frame_clock_get_frame_count(const glt_frame_clock_t *clock);
+
+void glt_frame_clock_get_stats(const glt_frame_clock_t *clock, glt_frame_stats_t *stats);
+
+void glt_frame_clock_reset_stats(glt_frame_clock_t *clock);
+
+// fixed-timestep updates; set step, the rest may stay zero-initialized
+typedef struct {
+    double step;
+    // 0 uses GLT_FIXED_STEP_MAX_DEFAULT, time past it is dropped instead of piling up
+    int max_steps;
+    double accumulator;
+} glt_fixed_step_t;
+
+// adds the frame time and returns how many steps of fixed->step to run
+int glt_fixed_step_advance(glt_fixed_step_t *fixed, double delta);
+
+// fraction of a step left over in [0, 1), to interpolate between the last two simulated states
+double glt_fixed_step_get_alpha(const glt_fixed_step_t *fixed);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "glt_gpu_profiler.h"
+
+// CPU zones recorded into per-thread lock-free rings and written as Chrome trace-event JSON
+// (chrome://tracing, Perfetto); the macros compile out unless GLT_TRACE_ENABLED is defined,
+// which the GLT_TRACE CMake option does
+
+typedef struct {
+    const char *name;
+    uint64_t start;
+} glt_trace_zone_t;
+
+#define GLT_TRACE_CONCAT_(a, b) a##b
+#define GLT_TRACE_CONCAT(a, b) GLT_TRACE_CONCAT_(a, b)
+
+#ifdef GLT_TRACE_ENABLED
+#if defined(__GNUC__) || defined(__clang__)
+// closes when the enclosing block is left; name must outlive the trace, a string literal is typical
+#define GLT_ZONE(name) \
+    glt_trace_zone_t GLT_TRACE_CONCAT(glt_zone_, __LINE__) __attribute__((cleanup(glt_trace_zone_end))) \
+        = glt_trace_zone_begin(name)
+#else
+#define GLT_ZONE(name) ((void) 0)
+#endif
+#define GLT_ZONE_BEGIN(var, name) glt_trace_zone_t var = glt_trace_zone_begin(name)
+#define GLT_ZONE_END(var) glt_trace_zone_end(&(var))
+#define GLT_TRACE_THREAD_NAME(name) glt_trace_set_thread_name(name)
+#else
+#define GLT_ZONE(name) ((void) 0)
+#define GLT_ZONE_BEGIN(var, name) ((void) 0)
+#define GLT_ZONE_END(var) ((void) 0)
+#define GLT_TRACE_THREAD_NAME(name) ((void) 0)
+#endif
+
+#define GLT_TRACE_RING_CAPACITY 16384
+
+glt_trace_zone_t glt_trace_zone_begin(const char *name);
+
+// records the zone; events are dropped while the thread's ring is full or tracing is paused
+void glt_trace_zone_end(glt_trace_zone_t *zone);
+
+// label for the calling thread's track, copied
+void glt_trace_set_thread_name(const char *name);
+
+// copy of name that lives as long as the process, for zone names built or freed at runtime
+const char *glt_trace_intern(const char *name);
+
+// recording is on by default, pausing keeps what was collected
+void glt_trace_set_active(bool active);
+
+bool glt_trace_is_active(void);
+
+// moves every thread's recorded zones into the trace, call regularly so rings don't fill up;
+// rings of exited threads are handed to new threads once collected
+void glt_trace_collect(void);
+
+// appends the profiler's latest harvested frame on a separate GPU track, once per harvested frame
+void glt_trace_add_gpu_frame(const glt_gpu_profiler_t *profiler);
+
+// collects, then writes everything recorded so far
+bool glt_trace_write_json(const char *path);
+
+// drops collected events, thread names stay
+void glt_trace_clear(void);
+
+// events lost to full rings since the last clear
+uint64_t glt_trace_get_dropped(void);
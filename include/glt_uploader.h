@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "glt_texture.h"
+#include "glt_window.h"
+
+// a thread with a hidden context sharing the window's objects, so buffer and texture creation
+// stays off the render thread; every upload ends in a fence and is handed back by
+// glt_uploader_update only once the GPU finished it, never by waiting on the render thread
+
+typedef struct glt_uploader_t glt_uploader_t;
+
+// runs on the upload thread with the shared context current; VAOs and framebuffers created
+// there are not visible to the window's context
+typedef void (*glt_upload_fn)(void *user);
+
+// runs on the render thread in glt_uploader_update, objects are ready to use from here on;
+// rebind any object that was already bound on the render thread before it changed
+typedef void (*glt_upload_done_fn)(void *user);
+
+// call on the window's thread with its context current
+glt_uploader_t *glt_uploader_create(glt_window_t *window);
+
+// finishes every queued upload and runs its done callback first
+void glt_uploader_destroy(glt_uploader_t *uploader);
+
+// either callback may be NULL
+bool glt_uploader_submit(glt_uploader_t *uploader, glt_upload_fn upload, glt_upload_done_fn done, void *user);
+
+// GLT_TEXTURE_PENDING until an update after the upload finished; options == NULL means defaults
+glt_texture_t *glt_uploader_load_texture(glt_uploader_t *uploader, const char *path, const glt_texture_options_t *options);
+
+// call once per frame: completes uploads whose fences signaled, in submission order; returns their count
+size_t glt_uploader_update(glt_uploader_t *uploader);
+
+// blocks until everything submitted so far is complete
+void glt_uploader_finish(glt_uploader_t *uploader);
+
+// submitted and not yet completed
+size_t glt_uploader_get_pending(const glt_uploader_t *uploader);
@@ -12,8 +12,12 @@ void glt_vertex_buffer_bind(const glt_vertex_buffer_t *buffer);
 
 void glt_vertex_buffer_unbind(void);
 
+// reallocates the storage, which also orphans what pending draws still read
 void glt_vertex_buffer_set_data(glt_vertex_buffer_t *buffer, const void *data, GLsizeiptr size);
 
+// updates a range in place, offset + size must fit the current size
+void glt_vertex_buffer_set_sub_data(glt_vertex_buffer_t *buffer, GLintptr offset, const void *data, GLsizeiptr size);
+
 GLuint glt_vertex_buffer_get_id(const glt_vertex_buffer_t *buffer);
 
 GLsizeiptr glt_vertex_buffer_get_size(const glt_vertex_buffer_t *buffer);
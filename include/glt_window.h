@@ -1,32 +1,161 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#include "glad/glad.h"
+#include "glt_time.h"
 
 typedef struct glt_window_t glt_window_t;
 
+typedef enum {
+    GLT_WINDOW_MODE_VISIBLE = 0,
+    // no display needed: an EGL surfaceless context where glt was built with EGL, an invisible
+    // GLFW window otherwise; rendering goes to an offscreen framebuffer that stays bound
+    GLT_WINDOW_MODE_HEADLESS,
+    GLT_WINDOW_MODE__COUNT
+} glt_window_mode_e;
+
+typedef enum {
+    GLT_EVENT_KEY = 0,
+    GLT_EVENT_CHAR,
+    GLT_EVENT_MOUSE_BUTTON,
+    GLT_EVENT_MOUSE_MOVE,
+    GLT_EVENT_SCROLL,
+    GLT_EVENT_RESIZE,
+    GLT_EVENT_FOCUS,
+    GLT_EVENT_CLOSE,
+    GLT_EVENT__COUNT
+} glt_event_type_e;
+
+// key, button, action and mods values are GLFW's (GLFW_KEY_*, GLFW_PRESS, ...)
+typedef struct {
+    glt_event_type_e type;
+    // glt_time_now() when the event was received
+    double time;
+    union {
+        struct {
+            int key;
+            int scancode;
+            int action;
+            int mods;
+        } key;
+        struct {
+            uint32_t codepoint;
+        } character;
+        struct {
+            int button;
+            int action;
+            int mods;
+            double x;
+            double y;
+        } mouse_button;
+        struct {
+            double x;
+            double y;
+        } mouse_move;
+        struct {
+            double dx;
+            double dy;
+        } scroll;
+        // framebuffer pixels
+        struct {
+            int width;
+            int height;
+        } resize;
+        struct {
+            bool focused;
+        } focus;
+    };
+} glt_event_t;
+
+// consecutive mouse moves are merged, the oldest events go first once the ring is full
+#define GLT_WINDOW_EVENT_CAPACITY 256
+
+// zero-initialized options are the glt_window_create defaults
+typedef struct {
+    glt_window_mode_e mode;
+    // debug context with its output routed into glt_log through glt_debug_enable (OpenGL 4.3)
+    bool debug;
+} glt_window_options_t;
+
 glt_window_t *glt_window_create(int width, int height, const char *title, int major_ver, int minor_ver);
 
+glt_window_t *glt_window_create_ex(
+    int width, int height, const char *title, int major_ver, int minor_ver,
+    const glt_window_options_t *options
+);
+
+// hidden context sharing window's objects (buffers, textures, shaders, samplers, syncs; not VAOs or
+// framebuffers), to make current on another thread; call on window's thread, which keeps its context.
+// A debug window's shared context is a debug context too, call glt_debug_enable once it is current
+glt_window_t *glt_window_create_shared(const glt_window_t *window);
+
 void glt_window_destroy(glt_window_t *window);
 
-// returns GLFWwindow *
+// returns GLFWwindow *, NULL for EGL headless windows
 void *glt_window_get_handle(const glt_window_t *window);
 
+bool glt_window_is_headless(const glt_window_t *window);
+
+// applies to the current context, a no-op for headless EGL contexts and without one
 void glt_window_set_vsync(bool enabled);
 
 bool glt_window_should_close(const glt_window_t *window);
 
+void glt_window_set_should_close(glt_window_t *window, bool close);
+
 void glt_window_process_input(const glt_window_t *window);
 
+// also ticks the window's frame clock, so the frame limiter waits here
 void glt_window_swap_buffers(const glt_window_t *window);
 
 void glt_window_poll_events(void);
 
+// oldest queued event of the window, false once the queue is empty
+bool glt_window_next_event(glt_window_t *window, glt_event_t *event);
+
+// events lost to a full queue since the window was created
+uint64_t glt_window_get_dropped_events(const glt_window_t *window);
+
+// on demand, glt_window_wait_frame sleeps until an event arrives or a redraw is requested;
+// max_wait > 0 also wakes it for a frame after that many seconds, e.g. for a blinking cursor
+void glt_window_set_on_demand(glt_window_t *window, bool enabled, double max_wait);
+
+bool glt_window_is_on_demand(const glt_window_t *window);
+
+// marks the window for one more frame, safe from any thread
+void glt_window_request_redraw(glt_window_t *window);
+
+// processes pending events and returns whether a frame should be drawn; continuous windows
+// always draw, on-demand ones block until there's a reason to (headless windows never block)
+bool glt_window_wait_frame(glt_window_t *window);
+
 void glt_window_set_clear_color(float r, float g, float b, float a);
 
 void glt_window_clear(void);
 
+// NULL releases the calling thread's context
 void glt_window_set_current(glt_window_t *window);
 
 int glt_window_get_width(const glt_window_t *window);
 
 int glt_window_get_height(const glt_window_t *window);
+
+// in pixels, differs from the window size on scaled displays
+void glt_window_get_framebuffer_size(const glt_window_t *window, int *width, int *height);
+
+// the offscreen framebuffer of headless windows, 0 (the default framebuffer) otherwise
+GLuint glt_window_get_framebuffer(const glt_window_t *window);
+
+// whole framebuffer as RGBA8, top row first; rgba holds width * height * 4 bytes of the framebuffer size
+bool glt_window_read_pixels(const glt_window_t *window, unsigned char *rgba);
+
+// ticked once per glt_window_swap_buffers
+glt_frame_clock_t *glt_window_get_clock(const glt_window_t *window);
+
+// seconds between the last two swaps
+double glt_window_get_delta_time(const glt_window_t *window);
+
+// frames per second, 0 disables; pair it with glt_window_set_vsync(false)
+void glt_window_set_frame_limit(glt_window_t *window, double fps);
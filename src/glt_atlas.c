@@ -0,0 +1,514 @@
+#include "glt_atlas.h"
+#include "glt_texture_internal.h"
+#include "glt_image.h"
+#include "glt_stats.h"
+#include "glt_log.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "stb_image.h"
+
+#define ATLAS_LOG(level, msg, ...)    glt_log(level, "[ATLAS]: " msg, ##__VA_ARGS__)
+
+#define DEFAULT_PAGE_SIZE 2048
+#define DEFAULT_PADDING 4
+
+typedef struct {
+    int x;
+    int y;
+    int width;
+} skyline_node_t;
+
+typedef struct {
+    skyline_node_t *nodes;
+    int count;
+} skyline_t;
+
+typedef struct {
+    unsigned char *pixels; // RGBA8, bottom row first
+    int width;
+    int height;
+} atlas_image_t;
+
+struct glt_atlas_t {
+    GLsizei page_size;
+    GLsizei padding;
+    GLint max_pages;
+    GLint max_level;
+    GLint align;
+
+    atlas_image_t *images;
+    glt_atlas_region_t *regions;
+    int count;
+    int capacity;
+
+    GLuint texture;
+    GLint pages;
+};
+
+// helper funcs
+
+static int add_image(glt_atlas_t *atlas, unsigned char *pixels, int width, int height);
+
+static int compare_by_height(const atlas_image_t *images, int a, int b);
+
+static bool pack(glt_atlas_t *atlas, skyline_t *skylines, int *order);
+
+static bool skyline_init(skyline_t *sky, int size);
+
+static bool skyline_insert(skyline_t *sky, int size, int w, int h, int *out_x, int *out_y);
+
+static int skyline_fit(const skyline_t *sky, int index, int size, int w, int h);
+
+static void blit_extruded(unsigned char *page, int page_size, const atlas_image_t *img, int x, int y, int pad);
+
+static bool upload(glt_atlas_t *atlas);
+
+static size_t texture_bytes(const glt_atlas_t *atlas);
+
+static int align_up(int v, int a);
+
+// public funcs
+
+glt_atlas_t *glt_atlas_create(const glt_atlas_desc_t *desc) {
+    glt_atlas_t *atlas = calloc(1, sizeof(glt_atlas_t));
+    if (!atlas) {
+        ATLAS_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+
+    atlas->page_size = desc && desc->page_size > 0 ? desc->page_size : DEFAULT_PAGE_SIZE;
+    atlas->padding = desc ? desc->padding : DEFAULT_PADDING;
+    atlas->max_pages = desc ? desc->max_pages : 0;
+    if (atlas->padding < 0) {
+        atlas->padding = 0;
+    }
+
+    // a texel of the last level may span at most `padding` base texels, so neighbours never bleed
+    atlas->max_level = 0;
+    while ((1 << (atlas->max_level + 1)) <= atlas->padding) {
+        atlas->max_level++;
+    }
+    atlas->align = 1 << atlas->max_level;
+
+    return atlas;
+}
+
+void glt_atlas_destroy(glt_atlas_t *atlas) {
+    if (!atlas) {
+        return;
+    }
+    for (int i = 0; i < atlas->count; ++i) {
+        free(atlas->images[i].pixels);
+    }
+    if (atlas->texture) {
+        glDeleteTextures(1, &atlas->texture);
+        glt_stats_track_resource(GLT_RESOURCE_TEXTURE, -1, -(int64_t) texture_bytes(atlas));
+    }
+    free(atlas->images);
+    free(atlas->regions);
+    free(atlas);
+}
+
+int glt_atlas_add_path(glt_atlas_t *atlas, const char *path) {
+    if (!atlas || !path) {
+        return -1;
+    }
+
+    int width = 0, height = 0, channels = 0;
+    unsigned char *data = stbi_load(path, &width, &height, &channels, 4);
+    if (!data) {
+        ATLAS_LOG(GLT_LOG_ERROR, "failed to load image '%s'", path);
+        return -1;
+    }
+    // flipped here rather than through stbi's per-thread flag, which would leak into later decodes
+    glt_image_flip_vertical(data, width, height, 4);
+
+    // stbi memory comes from malloc unless STBI_MALLOC is overridden
+    const int index = add_image(atlas, data, width, height);
+    if (index < 0) {
+        stbi_image_free(data);
+    }
+    return index;
+}
+
+int glt_atlas_add_pixels(glt_atlas_t *atlas, const unsigned char *rgba, GLsizei width, GLsizei height) {
+    if (!atlas || !rgba || width <= 0 || height <= 0) {
+        return -1;
+    }
+
+    const size_t size = (size_t) width * (size_t) height * 4;
+    unsigned char *copy = malloc(size);
+    if (!copy) {
+        ATLAS_LOG(GLT_LOG_ERROR, "failed to allocate %zu bytes", size);
+        return -1;
+    }
+    memcpy(copy, rgba, size);
+
+    const int index = add_image(atlas, copy, width, height);
+    if (index < 0) {
+        free(copy);
+    }
+    return index;
+}
+
+bool glt_atlas_build(glt_atlas_t *atlas) {
+    if (!atlas || atlas->count == 0) {
+        return false;
+    }
+    if (atlas->texture) {
+        ATLAS_LOG(GLT_LOG_ERROR, "atlas is already built");
+        return false;
+    }
+
+    GLint max_layers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &max_layers);
+    if (atlas->max_pages <= 0 || atlas->max_pages > max_layers) {
+        atlas->max_pages = max_layers;
+    }
+
+    int *order = malloc(atlas->count * sizeof(int));
+    skyline_t *skylines = calloc(atlas->max_pages, sizeof(skyline_t));
+    if (!order || !skylines) {
+        ATLAS_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        free(order);
+        free(skylines);
+        return false;
+    }
+
+    bool ok = pack(atlas, skylines, order);
+    if (ok) {
+        ok = upload(atlas);
+    }
+
+    for (int i = 0; i < atlas->max_pages; ++i) {
+        free(skylines[i].nodes);
+    }
+    free(skylines);
+    free(order);
+
+    if (!ok) {
+        // the images stay with the atlas, so the build can be retried
+        return false;
+    }
+    for (int i = 0; i < atlas->count; ++i) {
+        free(atlas->images[i].pixels);
+        atlas->images[i].pixels = NULL;
+    }
+
+    return true;
+}
+
+const glt_atlas_region_t *glt_atlas_get_region(const glt_atlas_t *atlas, int index) {
+    if (!atlas || index < 0 || index >= atlas->count) {
+        return NULL;
+    }
+    return &atlas->regions[index];
+}
+
+int glt_atlas_get_region_count(const glt_atlas_t *atlas) {
+    return atlas ? atlas->count : 0;
+}
+
+GLuint glt_atlas_get_texture(const glt_atlas_t *atlas) {
+    return atlas ? atlas->texture : 0;
+}
+
+GLint glt_atlas_get_page_count(const glt_atlas_t *atlas) {
+    return atlas ? atlas->pages : 0;
+}
+
+// helper funcs
+
+static int add_image(glt_atlas_t *atlas, unsigned char *pixels, int width, int height) {
+    if (atlas->texture) {
+        ATLAS_LOG(GLT_LOG_ERROR, "can't add images to a built atlas");
+        return -1;
+    }
+
+    // same slot size pack() reserves
+    const int slot_w = align_up(width + 2 * atlas->padding, atlas->align);
+    const int slot_h = align_up(height + 2 * atlas->padding, atlas->align);
+    if (slot_w > atlas->page_size || slot_h > atlas->page_size) {
+        ATLAS_LOG(GLT_LOG_ERROR, "image %dx%d doesn't fit a %d page", width, height, atlas->page_size);
+        return -1;
+    }
+
+    if (atlas->count == atlas->capacity) {
+        const int cap = atlas->capacity ? atlas->capacity * 2 : 64;
+        atlas_image_t *images = realloc(atlas->images, cap * sizeof(atlas_image_t));
+        if (!images) {
+            ATLAS_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+            return -1;
+        }
+        atlas->images = images;
+
+        glt_atlas_region_t *regions = realloc(atlas->regions, cap * sizeof(glt_atlas_region_t));
+        if (!regions) {
+            ATLAS_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+            return -1;
+        }
+        atlas->regions = regions;
+        atlas->capacity = cap;
+    }
+
+    atlas->images[atlas->count].pixels = pixels;
+    atlas->images[atlas->count].width = width;
+    atlas->images[atlas->count].height = height;
+    memset(&atlas->regions[atlas->count], 0, sizeof(glt_atlas_region_t));
+    return atlas->count++;
+}
+
+static int compare_by_height(const atlas_image_t *images, int a, int b) {
+    const atlas_image_t *ia = &images[a];
+    const atlas_image_t *ib = &images[b];
+    if (ia->height != ib->height) {
+        return ib->height - ia->height;
+    }
+    return ib->width - ia->width;
+}
+
+static bool pack(glt_atlas_t *atlas, skyline_t *skylines, int *order) {
+    for (int i = 0; i < atlas->count; ++i) {
+        order[i] = i;
+    }
+    // tallest first keeps the skyline flat
+    for (int i = 1; i < atlas->count; ++i) {
+        const int cur = order[i];
+        int j = i - 1;
+        while (j >= 0 && compare_by_height(atlas->images, order[j], cur) > 0) {
+            order[j + 1] = order[j];
+            --j;
+        }
+        order[j + 1] = cur;
+    }
+
+    const int size = atlas->page_size;
+    const int pad = atlas->padding;
+    atlas->pages = 0;
+
+    for (int i = 0; i < atlas->count; ++i) {
+        const int index = order[i];
+        const atlas_image_t *img = &atlas->images[index];
+        const int w = align_up(img->width + 2 * pad, atlas->align);
+        const int h = align_up(img->height + 2 * pad, atlas->align);
+
+        int page = 0, x = 0, y = 0;
+        for (; page < atlas->pages; ++page) {
+            if (skyline_insert(&skylines[page], size, w, h, &x, &y)) {
+                break;
+            }
+        }
+        if (page == atlas->pages) {
+            if (atlas->pages == atlas->max_pages) {
+                ATLAS_LOG(GLT_LOG_ERROR, "out of pages (%d)", atlas->max_pages);
+                return false;
+            }
+            if (!skyline_init(&skylines[page], size)) {
+                ATLAS_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+                return false;
+            }
+            atlas->pages++;
+            if (!skyline_insert(&skylines[page], size, w, h, &x, &y)) {
+                return false;
+            }
+        }
+
+        glt_atlas_region_t *region = &atlas->regions[index];
+        region->layer = page;
+        region->width = img->width;
+        region->height = img->height;
+        // reuse u0/v0 as pixel position until upload
+        region->u0 = (GLfloat) (x + pad);
+        region->v0 = (GLfloat) (y + pad);
+    }
+
+    return true;
+}
+
+static bool skyline_init(skyline_t *sky, int size) {
+    sky->nodes = malloc(size * sizeof(skyline_node_t));
+    if (!sky->nodes) {
+        return false;
+    }
+    sky->nodes[0].x = 0;
+    sky->nodes[0].y = 0;
+    sky->nodes[0].width = size;
+    sky->count = 1;
+    return true;
+}
+
+static bool skyline_insert(skyline_t *sky, int size, int w, int h, int *out_x, int *out_y) {
+    int best = -1, best_top = size + 1, best_width = size + 1;
+    for (int i = 0; i < sky->count; ++i) {
+        const int y = skyline_fit(sky, i, size, w, h);
+        if (y < 0) {
+            continue;
+        }
+        // bottom-left: lowest top edge, then the narrowest segment
+        if (y + h < best_top || (y + h == best_top && sky->nodes[i].width < best_width)) {
+            best = i;
+            best_top = y + h;
+            best_width = sky->nodes[i].width;
+        }
+    }
+    if (best < 0) {
+        return false;
+    }
+
+    const int x = sky->nodes[best].x;
+    const int y = best_top - h;
+
+    // insert the new segment and trim the ones it shadows
+    memmove(&sky->nodes[best + 1], &sky->nodes[best], (sky->count - best) * sizeof(skyline_node_t));
+    sky->nodes[best].x = x;
+    sky->nodes[best].y = y + h;
+    sky->nodes[best].width = w;
+    sky->count++;
+
+    for (int i = best + 1; i < sky->count; ++i) {
+        skyline_node_t *prev = &sky->nodes[i - 1];
+        skyline_node_t *node = &sky->nodes[i];
+        if (node->x >= prev->x + prev->width) {
+            break;
+        }
+        const int shrink = prev->x + prev->width - node->x;
+        node->x += shrink;
+        node->width -= shrink;
+        if (node->width > 0) {
+            break;
+        }
+        memmove(node, node + 1, (sky->count - i - 1) * sizeof(skyline_node_t));
+        sky->count--;
+        --i;
+    }
+
+    for (int i = 0; i + 1 < sky->count; ++i) {
+        if (sky->nodes[i].y == sky->nodes[i + 1].y) {
+            sky->nodes[i].width += sky->nodes[i + 1].width;
+            memmove(&sky->nodes[i + 1], &sky->nodes[i + 2], (sky->count - i - 2) * sizeof(skyline_node_t));
+            sky->count--;
+            --i;
+        }
+    }
+
+    *out_x = x;
+    *out_y = y;
+    return true;
+}
+
+static int skyline_fit(const skyline_t *sky, int index, int size, int w, int h) {
+    const int x = sky->nodes[index].x;
+    if (x + w > size) {
+        return -1;
+    }
+
+    int y = 0;
+    int left = w;
+    for (int i = index; left > 0; ++i) {
+        if (i == sky->count) {
+            return -1;
+        }
+        if (sky->nodes[i].y > y) {
+            y = sky->nodes[i].y;
+        }
+        if (y + h > size) {
+            return -1;
+        }
+        left -= sky->nodes[i].width;
+    }
+    return y;
+}
+
+static void blit_extruded(unsigned char *page, int page_size, const atlas_image_t *img, int x, int y, int pad) {
+    const size_t page_stride = (size_t) page_size * 4;
+    const size_t row_bytes = (size_t) img->width * 4;
+
+    for (int row = -pad; row < img->height + pad; ++row) {
+        const int src_row = row < 0 ? 0 : row >= img->height ? img->height - 1 : row;
+        const unsigned char *src = img->pixels + (size_t) src_row * row_bytes;
+        unsigned char *dst = page + (size_t) (y + row) * page_stride + (size_t) x * 4;
+
+        memcpy(dst, src, row_bytes);
+        for (int i = 1; i <= pad; ++i) {
+            memcpy(dst - (size_t) i * 4, src, 4);
+            memcpy(dst + row_bytes + (size_t) (i - 1) * 4, src + row_bytes - 4, 4);
+        }
+    }
+}
+
+static bool upload(glt_atlas_t *atlas) {
+    const int size = atlas->page_size;
+    const size_t page_bytes = (size_t) size * (size_t) size * 4;
+    unsigned char *page = malloc(page_bytes);
+    if (!page) {
+        ATLAS_LOG(GLT_LOG_ERROR, "failed to allocate %zu bytes", page_bytes);
+        return false;
+    }
+
+    glGenTextures(1, &atlas->texture);
+    if (!atlas->texture) {
+        ATLAS_LOG(GLT_LOG_ERROR, "failed to create texture");
+        free(page);
+        return false;
+    }
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlas->texture);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(
+        GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER,
+        atlas->max_level > 0 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR
+    );
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glt_texture_allocate(GL_TEXTURE_2D_ARRAY, atlas->max_level + 1, GL_RGBA8, size, size, atlas->pages);
+
+    GLint prev_unpack = 0;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prev_unpack);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    const GLfloat inv = 1.f / (GLfloat) size;
+    for (GLint layer = 0; layer < atlas->pages; ++layer) {
+        memset(page, 0, page_bytes);
+        for (int i = 0; i < atlas->count; ++i) {
+            glt_atlas_region_t *region = &atlas->regions[i];
+            if (region->layer != layer) {
+                continue;
+            }
+            const int x = (int) region->u0;
+            const int y = (int) region->v0;
+            blit_extruded(page, size, &atlas->images[i], x, y, atlas->padding);
+
+            region->texture = atlas->texture;
+            region->u0 = (GLfloat) x * inv;
+            region->v0 = (GLfloat) y * inv;
+            region->u1 = (GLfloat) (x + region->width) * inv;
+            region->v1 = (GLfloat) (y + region->height) * inv;
+        }
+        glTexSubImage3D(
+            GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, size, size, 1,
+            GL_RGBA, GL_UNSIGNED_BYTE, page
+        );
+        glt_stats_add(GLT_STAT_TEXTURE_UPLOADS, 1);
+        glt_stats_add(GLT_STAT_TEXTURE_UPLOAD_BYTES, page_bytes);
+    }
+
+    if (atlas->max_level > 0) {
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prev_unpack);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    free(page);
+    glt_stats_track_resource(GLT_RESOURCE_TEXTURE, 1, (int64_t) texture_bytes(atlas));
+    return true;
+}
+
+static size_t texture_bytes(const glt_atlas_t *atlas) {
+    return glt_texture_mip_chain_bytes(atlas->page_size, atlas->page_size, 4, atlas->max_level + 1) * (size_t) atlas->pages;
+}
+
+static int align_up(int v, int a) {
+    return (v + a - 1) / a * a;
+}
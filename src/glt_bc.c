@@ -0,0 +1,810 @@
+#include "glt_bc.h"
+#include "glt_job_queue.h"
+#include "glt_trace.h"
+#include "glt_log.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define GLT_BC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#define BC_LOG(level, msg, ...)    glt_log(level, "[BC]: " msg, ##__VA_ARGS__)
+
+// block rows per encode job
+#define SLICE_ROWS 8
+
+typedef struct {
+    GLenum format;
+    const unsigned char *rgba;
+    GLsizei width;
+    GLsizei height;
+    unsigned char *dst;
+    glt_bc_quality_e quality;
+    GLsizei first_row;
+    GLsizei rows;
+} encode_slice_t;
+
+// one glt_bc_encode call; the caller and the queued runners claim slices until none are left
+typedef struct {
+    encode_slice_t *slices;
+    GLsizei count;
+    atomic_int next;
+    atomic_int done;
+    // the caller plus queued runners, the last one frees the batch
+    atomic_int refs;
+    pthread_mutex_t mutex;
+    pthread_cond_t finished;
+} encode_batch_t;
+
+// created on the first parallel encode and kept until glt_bc_shutdown, so mips don't pay thread startup;
+// runners are pushed under the mutex so shutdown never destroys the queue mid-push
+static glt_job_queue_t *workers = NULL;
+static pthread_mutex_t workers_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const int bc7_weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// helper funcs
+
+static void decode_color_block(const unsigned char *block, unsigned char out[64], bool allow_punchthrough);
+
+static void decode_alpha_block(const unsigned char *block, unsigned char out[16]);
+
+static void decode_block(GLenum format, const unsigned char *block, unsigned char out[64]);
+
+static void unpack_565(uint16_t c, unsigned char rgb[3]);
+
+static size_t encoded_block_bytes(GLenum format);
+
+static void claim_slices(encode_batch_t *batch);
+
+static void run_slices(void *user);
+
+static void release_batch(encode_batch_t *batch);
+
+static void encode_slice(void *user);
+
+static void fetch_block(const unsigned char *rgba, GLsizei width, GLsizei height, GLsizei bx, GLsizei by, unsigned char px[64]);
+
+static void bounding_box(const unsigned char px[64], int lo[4], int hi[4]);
+
+static void principal_axis(const unsigned char px[64], int channels, float mean[4], float axis[4]);
+
+static void color_endpoints(const unsigned char px[64], glt_bc_quality_e quality, int channels, float e0[4], float e1[4]);
+
+static void encode_color_block(const unsigned char px[64], unsigned char out[8], glt_bc_quality_e quality);
+
+static void encode_alpha_block(const unsigned char px[64], unsigned char out[8]);
+
+static void encode_bc7_block(const unsigned char px[64], unsigned char out[16], glt_bc_quality_e quality);
+
+static uint16_t pack_565(const float c[3]);
+
+static void nearest_color_indices(const unsigned char px[64], unsigned char palette[4][4], int indices[16]);
+
+static void put_bits(unsigned char *block, int *pos, uint32_t value, int count);
+
+// public funcs
+
+bool glt_bc_can_decode(GLenum format) {
+    switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_RED_RGTC1:
+        case GL_COMPRESSED_RG_RGTC2:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool glt_bc_can_encode(GLenum format) {
+    return encoded_block_bytes(format) != 0;
+}
+
+size_t glt_bc_encoded_size(GLenum format, GLsizei width, GLsizei height) {
+    if (width <= 0 || height <= 0) {
+        return 0;
+    }
+    return (size_t) ((width + 3) / 4) * (size_t) ((height + 3) / 4) * encoded_block_bytes(format);
+}
+
+bool glt_bc_encode(
+    GLenum format, const unsigned char *rgba, GLsizei width, GLsizei height,
+    unsigned char *dst, glt_bc_quality_e quality, int n_threads
+) {
+    if (!rgba || !dst || width <= 0 || height <= 0 || !glt_bc_can_encode(format) || quality >= GLT_BC_QUALITY__COUNT) {
+        return false;
+    }
+    GLT_ZONE("glt_bc_encode");
+
+    const GLsizei block_rows = (height + 3) / 4;
+    const GLsizei slice_count = (block_rows + SLICE_ROWS - 1) / SLICE_ROWS;
+    encode_batch_t *batch = malloc(sizeof(encode_batch_t));
+    encode_slice_t *slices = malloc((size_t) slice_count * sizeof(encode_slice_t));
+    if (!batch || !slices) {
+        BC_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        free(batch);
+        free(slices);
+        return false;
+    }
+    for (GLsizei i = 0; i < slice_count; ++i) {
+        slices[i] = (encode_slice_t) {
+            .format = format,
+            .rgba = rgba,
+            .width = width,
+            .height = height,
+            .dst = dst,
+            .quality = quality,
+            .first_row = i * SLICE_ROWS,
+            .rows = block_rows - i * SLICE_ROWS < SLICE_ROWS ? block_rows - i * SLICE_ROWS : SLICE_ROWS,
+        };
+    }
+    batch->slices = slices;
+    batch->count = slice_count;
+    atomic_init(&batch->next, 0);
+    atomic_init(&batch->done, 0);
+    atomic_init(&batch->refs, 1);
+    pthread_mutex_init(&batch->mutex, NULL);
+    pthread_cond_init(&batch->finished, NULL);
+
+    if (n_threads != 1 && slice_count > 1) {
+        pthread_mutex_lock(&workers_mutex);
+        if (!workers) {
+            workers = glt_job_queue_create(0);
+        }
+        // the calling thread encodes too, so runners beyond slice_count - 1 would find nothing
+        int runners = n_threads > 1 ? n_threads - 1 : glt_job_queue_get_thread_count(workers);
+        if (runners > slice_count - 1) {
+            runners = slice_count - 1;
+        }
+        for (int i = 0; i < runners; ++i) {
+            atomic_fetch_add(&batch->refs, 1);
+            if (!glt_job_queue_push(workers, run_slices, batch)) {
+                atomic_fetch_sub(&batch->refs, 1);
+                break;
+            }
+        }
+        pthread_mutex_unlock(&workers_mutex);
+    }
+
+    // runners still queued behind other work find nothing left and only drop their reference
+    claim_slices(batch);
+    pthread_mutex_lock(&batch->mutex);
+    while (atomic_load(&batch->done) < batch->count) {
+        pthread_cond_wait(&batch->finished, &batch->mutex);
+    }
+    pthread_mutex_unlock(&batch->mutex);
+    release_batch(batch);
+    return true;
+}
+
+void glt_bc_shutdown(void) {
+    pthread_mutex_lock(&workers_mutex);
+    glt_job_queue_t *queue = workers;
+    workers = NULL;
+    pthread_mutex_unlock(&workers_mutex);
+
+    // queued runners still drain, encodes already waiting on them finish normally
+    glt_job_queue_destroy(queue);
+}
+
+bool glt_bc_decode(GLenum format, const unsigned char *src, GLsizei width, GLsizei height, unsigned char *rgba) {
+    if (!src || !rgba || width <= 0 || height <= 0 || !glt_bc_can_decode(format)) {
+        return false;
+    }
+
+    const bool small_blocks =
+            format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT ||
+            format == GL_COMPRESSED_SRGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT ||
+            format == GL_COMPRESSED_RED_RGTC1;
+    const size_t block_bytes = small_blocks ? 8 : 16;
+
+    unsigned char texels[64];
+    for (GLsizei by = 0; by < height; by += 4) {
+        for (GLsizei bx = 0; bx < width; bx += 4) {
+            decode_block(format, src, texels);
+            src += block_bytes;
+
+            const int rows = height - by < 4 ? height - by : 4;
+            const int cols = width - bx < 4 ? width - bx : 4;
+            for (int y = 0; y < rows; ++y) {
+                unsigned char *dst = rgba + ((size_t) (by + y) * (size_t) width + (size_t) bx) * 4;
+                memcpy(dst, texels + y * 16, (size_t) cols * 4);
+            }
+        }
+    }
+    return true;
+}
+
+// helper funcs
+
+static void decode_block(GLenum format, const unsigned char *block, unsigned char out[64]) {
+    unsigned char channel[16];
+
+    switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+            decode_color_block(block, out, true);
+            for (int i = 0; i < 16; ++i) {
+                out[i * 4 + 3] = 255;
+            }
+            break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+            decode_color_block(block, out, true);
+            break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+            decode_color_block(block + 8, out, false);
+            for (int i = 0; i < 16; ++i) {
+                const int nibble = (block[i / 2] >> ((i & 1) * 4)) & 0xF;
+                out[i * 4 + 3] = (unsigned char) (nibble * 17);
+            }
+            break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+            decode_color_block(block + 8, out, false);
+            decode_alpha_block(block, channel);
+            for (int i = 0; i < 16; ++i) {
+                out[i * 4 + 3] = channel[i];
+            }
+            break;
+        case GL_COMPRESSED_RED_RGTC1:
+            decode_alpha_block(block, channel);
+            for (int i = 0; i < 16; ++i) {
+                out[i * 4 + 0] = channel[i];
+                out[i * 4 + 1] = 0;
+                out[i * 4 + 2] = 0;
+                out[i * 4 + 3] = 255;
+            }
+            break;
+        case GL_COMPRESSED_RG_RGTC2:
+            decode_alpha_block(block, channel);
+            for (int i = 0; i < 16; ++i) {
+                out[i * 4 + 0] = channel[i];
+                out[i * 4 + 2] = 0;
+                out[i * 4 + 3] = 255;
+            }
+            decode_alpha_block(block + 8, channel);
+            for (int i = 0; i < 16; ++i) {
+                out[i * 4 + 1] = channel[i];
+            }
+            break;
+        default:
+            memset(out, 0, 64);
+            break;
+    }
+}
+
+static void decode_color_block(const unsigned char *block, unsigned char out[64], bool allow_punchthrough) {
+    const uint16_t c0 = (uint16_t) (block[0] | block[1] << 8);
+    const uint16_t c1 = (uint16_t) (block[2] | block[3] << 8);
+    const uint32_t indices = (uint32_t) block[4] | (uint32_t) block[5] << 8 |
+                             (uint32_t) block[6] << 16 | (uint32_t) block[7] << 24;
+
+    unsigned char palette[4][4];
+    unpack_565(c0, palette[0]);
+    unpack_565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+
+    if (c0 > c1 || !allow_punchthrough) {
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (unsigned char) ((2 * palette[0][c] + palette[1][c] + 1) / 3);
+            palette[3][c] = (unsigned char) ((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+        }
+    } else {
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (unsigned char) ((palette[0][c] + palette[1][c]) / 2);
+            palette[3][c] = 0;
+        }
+        palette[3][3] = 0;
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        memcpy(out + i * 4, palette[(indices >> (i * 2)) & 3], 4);
+    }
+}
+
+static void decode_alpha_block(const unsigned char *block, unsigned char out[16]) {
+    unsigned char palette[8];
+    palette[0] = block[0];
+    palette[1] = block[1];
+
+    if (palette[0] > palette[1]) {
+        for (int i = 1; i < 7; ++i) {
+            palette[i + 1] = (unsigned char) (((7 - i) * palette[0] + i * palette[1] + 3) / 7);
+        }
+    } else {
+        for (int i = 1; i < 5; ++i) {
+            palette[i + 1] = (unsigned char) (((5 - i) * palette[0] + i * palette[1] + 2) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i) {
+        indices |= (uint64_t) block[2 + i] << (8 * i);
+    }
+    for (int i = 0; i < 16; ++i) {
+        out[i] = palette[(indices >> (3 * i)) & 7];
+    }
+}
+
+static void unpack_565(uint16_t c, unsigned char rgb[3]) {
+    const int r = (c >> 11) & 31;
+    const int g = (c >> 5) & 63;
+    const int b = c & 31;
+    rgb[0] = (unsigned char) ((r << 3) | (r >> 2));
+    rgb[1] = (unsigned char) ((g << 2) | (g >> 4));
+    rgb[2] = (unsigned char) ((b << 3) | (b >> 2));
+}
+
+static size_t encoded_block_bytes(GLenum format) {
+    switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+            return 8;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+static void claim_slices(encode_batch_t *batch) {
+    for (int i = atomic_fetch_add(&batch->next, 1); i < batch->count; i = atomic_fetch_add(&batch->next, 1)) {
+        encode_slice(&batch->slices[i]);
+        if (atomic_fetch_add(&batch->done, 1) + 1 == batch->count) {
+            pthread_mutex_lock(&batch->mutex);
+            pthread_cond_signal(&batch->finished);
+            pthread_mutex_unlock(&batch->mutex);
+        }
+    }
+}
+
+static void run_slices(void *user) {
+    encode_batch_t *batch = user;
+    claim_slices(batch);
+    release_batch(batch);
+}
+
+static void release_batch(encode_batch_t *batch) {
+    if (atomic_fetch_sub(&batch->refs, 1) != 1) {
+        return;
+    }
+    pthread_cond_destroy(&batch->finished);
+    pthread_mutex_destroy(&batch->mutex);
+    free(batch->slices);
+    free(batch);
+}
+
+static void encode_slice(void *user) {
+    const encode_slice_t *slice = user;
+    const size_t block_bytes = encoded_block_bytes(slice->format);
+    const GLsizei blocks_x = (slice->width + 3) / 4;
+
+    unsigned char px[64];
+    for (GLsizei row = slice->first_row; row < slice->first_row + slice->rows; ++row) {
+        unsigned char *out = slice->dst + (size_t) row * (size_t) blocks_x * block_bytes;
+        for (GLsizei bx = 0; bx < blocks_x; ++bx, out += block_bytes) {
+            fetch_block(slice->rgba, slice->width, slice->height, bx * 4, row * 4, px);
+
+            switch (slice->format) {
+                case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+                case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+                    encode_color_block(px, out, slice->quality);
+                    break;
+                case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+                case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+                    encode_alpha_block(px, out);
+                    encode_color_block(px, out + 8, slice->quality);
+                    break;
+                default:
+                    encode_bc7_block(px, out, slice->quality);
+                    break;
+            }
+        }
+    }
+}
+
+static void fetch_block(const unsigned char *rgba, GLsizei width, GLsizei height, GLsizei bx, GLsizei by, unsigned char px[64]) {
+    // full interior blocks are four 16 byte row copies
+    if (bx + 4 <= width && by + 4 <= height) {
+        for (int y = 0; y < 4; ++y) {
+            memcpy(px + y * 16, rgba + ((size_t) (by + y) * (size_t) width + (size_t) bx) * 4, 16);
+        }
+        return;
+    }
+
+    for (int y = 0; y < 4; ++y) {
+        const GLsizei sy = by + y < height ? by + y : height - 1;
+        for (int x = 0; x < 4; ++x) {
+            const GLsizei sx = bx + x < width ? bx + x : width - 1;
+            memcpy(px + (y * 4 + x) * 4, rgba + ((size_t) sy * (size_t) width + (size_t) sx) * 4, 4);
+        }
+    }
+}
+
+static void bounding_box(const unsigned char px[64], int lo[4], int hi[4]) {
+#ifdef GLT_BC_SSE2
+    __m128i mn = _mm_loadu_si128((const __m128i *) px);
+    __m128i mx = mn;
+    for (int i = 1; i < 4; ++i) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (px + i * 16));
+        mn = _mm_min_epu8(mn, v);
+        mx = _mm_max_epu8(mx, v);
+    }
+    // fold the four texels per register down to one
+    mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 8));
+    mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 8));
+    mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 4));
+    mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 4));
+
+    const uint32_t lo_bits = (uint32_t) _mm_cvtsi128_si32(mn);
+    const uint32_t hi_bits = (uint32_t) _mm_cvtsi128_si32(mx);
+    for (int c = 0; c < 4; ++c) {
+        lo[c] = (int) ((lo_bits >> (c * 8)) & 0xFF);
+        hi[c] = (int) ((hi_bits >> (c * 8)) & 0xFF);
+    }
+#else
+    for (int c = 0; c < 4; ++c) {
+        lo[c] = 255;
+        hi[c] = 0;
+    }
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            const int v = px[i * 4 + c];
+            lo[c] = v < lo[c] ? v : lo[c];
+            hi[c] = v > hi[c] ? v : hi[c];
+        }
+    }
+#endif
+}
+
+static void principal_axis(const unsigned char px[64], int channels, float mean[4], float axis[4]) {
+    float cov[4][4] = {{0}};
+    for (int c = 0; c < 4; ++c) {
+        mean[c] = 0.f;
+        axis[c] = 0.f;
+    }
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < channels; ++c) {
+            mean[c] += px[i * 4 + c];
+        }
+    }
+    for (int c = 0; c < channels; ++c) {
+        mean[c] /= 16.f;
+    }
+    for (int i = 0; i < 16; ++i) {
+        float d[4];
+        for (int c = 0; c < channels; ++c) {
+            d[c] = px[i * 4 + c] - mean[c];
+        }
+        for (int a = 0; a < channels; ++a) {
+            for (int b = a; b < channels; ++b) {
+                cov[a][b] += d[a] * d[b];
+            }
+        }
+    }
+
+    // power iteration seeded with the widest channel
+    int widest = 0;
+    for (int c = 1; c < channels; ++c) {
+        widest = cov[c][c] > cov[widest][widest] ? c : widest;
+    }
+    axis[widest] = 1.f;
+    for (int iter = 0; iter < 8; ++iter) {
+        float next[4] = {0};
+        for (int a = 0; a < channels; ++a) {
+            for (int b = 0; b < channels; ++b) {
+                next[a] += (a <= b ? cov[a][b] : cov[b][a]) * axis[b];
+            }
+        }
+        float length = 0.f;
+        for (int c = 0; c < channels; ++c) {
+            length += next[c] * next[c];
+        }
+        if (length < 1e-12f) {
+            return;
+        }
+        length = 1.f / sqrtf(length);
+        for (int c = 0; c < channels; ++c) {
+            axis[c] = next[c] * length;
+        }
+    }
+}
+
+static void color_endpoints(const unsigned char px[64], glt_bc_quality_e quality, int channels, float e0[4], float e1[4]) {
+    for (int c = 0; c < 4; ++c) {
+        e0[c] = 255.f;
+        e1[c] = 255.f;
+    }
+
+    if (quality == GLT_BC_QUALITY_FAST) {
+        int lo[4], hi[4];
+        bounding_box(px, lo, hi);
+
+        // orient the box diagonal along the colors' correlation with green
+        int cov[4] = {0};
+        for (int i = 0; i < 16; ++i) {
+            const int g = 2 * px[i * 4 + 1] - lo[1] - hi[1];
+            for (int c = 0; c < channels; ++c) {
+                cov[c] += (2 * px[i * 4 + c] - lo[c] - hi[c]) * g;
+            }
+        }
+        for (int c = 0; c < channels; ++c) {
+            // inset by 1/16 of the range, extremes are rarely hit after interpolation
+            const float inset = (float) (hi[c] - lo[c]) / 16.f;
+            const float a = (float) hi[c] - inset;
+            const float b = (float) lo[c] + inset;
+            e0[c] = cov[c] < 0 ? b : a;
+            e1[c] = cov[c] < 0 ? a : b;
+        }
+        return;
+    }
+
+    float mean[4], axis[4];
+    principal_axis(px, channels, mean, axis);
+
+    float t_min = 0.f, t_max = 0.f;
+    for (int i = 0; i < 16; ++i) {
+        float t = 0.f;
+        for (int c = 0; c < channels; ++c) {
+            t += (px[i * 4 + c] - mean[c]) * axis[c];
+        }
+        t_min = t < t_min ? t : t_min;
+        t_max = t > t_max ? t : t_max;
+    }
+    for (int c = 0; c < channels; ++c) {
+        const float a = mean[c] + axis[c] * t_max;
+        const float b = mean[c] + axis[c] * t_min;
+        e0[c] = a < 0.f ? 0.f : a > 255.f ? 255.f : a;
+        e1[c] = b < 0.f ? 0.f : b > 255.f ? 255.f : b;
+    }
+}
+
+static void encode_color_block(const unsigned char px[64], unsigned char out[8], glt_bc_quality_e quality) {
+    float e0[4], e1[4];
+    color_endpoints(px, quality, 3, e0, e1);
+
+    uint16_t c0 = pack_565(e0);
+    uint16_t c1 = pack_565(e1);
+    int indices[16];
+    unsigned char palette[4][4];
+
+    for (int pass = 0; pass < (quality == GLT_BC_QUALITY_HIGH ? 2 : 1); ++pass) {
+        if (c0 < c1) {
+            const uint16_t t = c0;
+            c0 = c1;
+            c1 = t;
+        }
+        unpack_565(c0, palette[0]);
+        unpack_565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (unsigned char) ((2 * palette[0][c] + palette[1][c] + 1) / 3);
+            palette[3][c] = (unsigned char) ((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+        }
+        nearest_color_indices(px, palette, indices);
+
+        if (pass == 1 || quality != GLT_BC_QUALITY_HIGH || c0 == c1) {
+            break;
+        }
+
+        // least-squares endpoints for the chosen indices, then pick indices once more
+        static const float weight0[4] = {1.f, 0.f, 2.f / 3.f, 1.f / 3.f};
+        float aa = 0.f, bb = 0.f, ab = 0.f, ax[3] = {0}, bx[3] = {0};
+        for (int i = 0; i < 16; ++i) {
+            const float a = weight0[indices[i]];
+            const float b = 1.f - a;
+            aa += a * a;
+            bb += b * b;
+            ab += a * b;
+            for (int c = 0; c < 3; ++c) {
+                ax[c] += a * px[i * 4 + c];
+                bx[c] += b * px[i * 4 + c];
+            }
+        }
+        const float det = aa * bb - ab * ab;
+        if (det < 1e-6f) {
+            break;
+        }
+        for (int c = 0; c < 3; ++c) {
+            const float a = (ax[c] * bb - bx[c] * ab) / det;
+            const float b = (bx[c] * aa - ax[c] * ab) / det;
+            e0[c] = a < 0.f ? 0.f : a > 255.f ? 255.f : a;
+            e1[c] = b < 0.f ? 0.f : b > 255.f ? 255.f : b;
+        }
+        c0 = pack_565(e0);
+        c1 = pack_565(e1);
+    }
+
+    uint32_t bits = 0;
+    if (c0 != c1) {
+        for (int i = 0; i < 16; ++i) {
+            bits |= (uint32_t) indices[i] << (i * 2);
+        }
+    }
+
+    out[0] = (unsigned char) (c0 & 0xFF);
+    out[1] = (unsigned char) (c0 >> 8);
+    out[2] = (unsigned char) (c1 & 0xFF);
+    out[3] = (unsigned char) (c1 >> 8);
+    out[4] = (unsigned char) (bits & 0xFF);
+    out[5] = (unsigned char) ((bits >> 8) & 0xFF);
+    out[6] = (unsigned char) ((bits >> 16) & 0xFF);
+    out[7] = (unsigned char) (bits >> 24);
+}
+
+static void encode_alpha_block(const unsigned char px[64], unsigned char out[8]) {
+    int lo = 255, hi = 0;
+    for (int i = 0; i < 16; ++i) {
+        const int a = px[i * 4 + 3];
+        lo = a < lo ? a : lo;
+        hi = a > hi ? a : hi;
+    }
+
+    out[0] = (unsigned char) hi;
+    out[1] = (unsigned char) lo;
+
+    // eight-value mode, ramp position p from lo (p = 0, index 1) to hi (p = 7, index 0)
+    uint64_t bits = 0;
+    if (hi > lo) {
+        const int range = hi - lo;
+        for (int i = 0; i < 16; ++i) {
+            const int p = ((px[i * 4 + 3] - lo) * 7 + range / 2) / range;
+            const uint64_t index = p == 7 ? 0 : p == 0 ? 1 : (uint64_t) (8 - p);
+            bits |= index << (3 * i);
+        }
+    }
+    for (int i = 0; i < 6; ++i) {
+        out[2 + i] = (unsigned char) ((bits >> (8 * i)) & 0xFF);
+    }
+}
+
+static void encode_bc7_block(const unsigned char px[64], unsigned char out[16], glt_bc_quality_e quality) {
+    float e[2][4];
+    color_endpoints(px, quality, 4, e[0], e[1]);
+
+    // mode 6: RGBA 7.7.7.7 endpoints with a shared lsb (p-bit) each, 4-bit indices
+    int q[2][4], p[2], v[2][4];
+    for (int k = 0; k < 2; ++k) {
+        float best_error = -1.f;
+        for (int pbit = 0; pbit < 2; ++pbit) {
+            int cq[4];
+            float error = 0.f;
+            for (int c = 0; c < 4; ++c) {
+                int n = (int) ((e[k][c] - (float) pbit) / 2.f + 0.5f);
+                n = n < 0 ? 0 : n > 127 ? 127 : n;
+                cq[c] = n;
+                const float d = (float) ((n << 1) | pbit) - e[k][c];
+                error += d * d;
+            }
+            if (best_error < 0.f || error < best_error) {
+                best_error = error;
+                p[k] = pbit;
+                memcpy(q[k], cq, sizeof(cq));
+            }
+        }
+        for (int c = 0; c < 4; ++c) {
+            v[k][c] = (q[k][c] << 1) | p[k];
+        }
+    }
+
+    int d[4], dd = 0;
+    for (int c = 0; c < 4; ++c) {
+        d[c] = v[1][c] - v[0][c];
+        dd += d[c] * d[c];
+    }
+
+    int indices[16];
+    for (int i = 0; i < 16; ++i) {
+        int index = 0;
+        if (dd > 0) {
+            int dot = 0;
+            for (int c = 0; c < 4; ++c) {
+                dot += (px[i * 4 + c] - v[0][c]) * d[c];
+            }
+            const float t = (float) dot / (float) dd * 15.f;
+            index = t <= 0.f ? 0 : t >= 15.f ? 15 : (int) (t + 0.5f);
+        }
+
+        // the weights aren't evenly spaced, check the neighbours against the real palette
+        if (quality == GLT_BC_QUALITY_HIGH && dd > 0) {
+            int best = index, best_error = -1;
+            for (int j = index - 1; j <= index + 1; ++j) {
+                if (j < 0 || j > 15) {
+                    continue;
+                }
+                int error = 0;
+                for (int c = 0; c < 4; ++c) {
+                    const int value = ((64 - bc7_weights[j]) * v[0][c] + bc7_weights[j] * v[1][c] + 32) >> 6;
+                    error += (value - px[i * 4 + c]) * (value - px[i * 4 + c]);
+                }
+                if (best_error < 0 || error < best_error) {
+                    best_error = error;
+                    best = j;
+                }
+            }
+            index = best;
+        }
+        indices[i] = index;
+    }
+
+    // the anchor index is stored without its msb, so it has to be below 8
+    if (indices[0] >= 8) {
+        for (int c = 0; c < 4; ++c) {
+            const int t = q[0][c];
+            q[0][c] = q[1][c];
+            q[1][c] = t;
+        }
+        const int t = p[0];
+        p[0] = p[1];
+        p[1] = t;
+        for (int i = 0; i < 16; ++i) {
+            indices[i] = 15 - indices[i];
+        }
+    }
+
+    memset(out, 0, 16);
+    int pos = 0;
+    put_bits(out, &pos, 1u << 6, 7);
+    for (int c = 0; c < 4; ++c) {
+        put_bits(out, &pos, (uint32_t) q[0][c], 7);
+        put_bits(out, &pos, (uint32_t) q[1][c], 7);
+    }
+    put_bits(out, &pos, (uint32_t) p[0], 1);
+    put_bits(out, &pos, (uint32_t) p[1], 1);
+    put_bits(out, &pos, (uint32_t) indices[0], 3);
+    for (int i = 1; i < 16; ++i) {
+        put_bits(out, &pos, (uint32_t) indices[i], 4);
+    }
+}
+
+static uint16_t pack_565(const float c[3]) {
+    const int r = (int) (c[0] * 31.f / 255.f + 0.5f);
+    const int g = (int) (c[1] * 63.f / 255.f + 0.5f);
+    const int b = (int) (c[2] * 31.f / 255.f + 0.5f);
+    return (uint16_t) ((r << 11) | (g << 5) | b);
+}
+
+static void nearest_color_indices(const unsigned char px[64], unsigned char palette[4][4], int indices[16]) {
+    for (int i = 0; i < 16; ++i) {
+        int best = 0, best_error = 1 << 30;
+        for (int j = 0; j < 4; ++j) {
+            const int dr = px[i * 4 + 0] - palette[j][0];
+            const int dg = px[i * 4 + 1] - palette[j][1];
+            const int db = px[i * 4 + 2] - palette[j][2];
+            const int error = dr * dr + dg * dg + db * db;
+            if (error < best_error) {
+                best_error = error;
+                best = j;
+            }
+        }
+        indices[i] = best;
+    }
+}
+
+static void put_bits(unsigned char *block, int *pos, uint32_t value, int count) {
+    for (int i = 0; i < count; ++i, ++*pos) {
+        if (value & (1u << i)) {
+            block[*pos >> 3] |= (unsigned char) (1u << (*pos & 7));
+        }
+    }
+}
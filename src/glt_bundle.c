@@ -0,0 +1,348 @@
+#include "glt_bundle.h"
+#include "glt_bundle_format.h"
+#include "glt_container.h"
+#include "glt_texture_internal.h"
+#include "glt_trace.h"
+#include "glt_debug.h"
+#include "glt_log.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define BUNDLE_LOG(level, msg, ...)    glt_log(level, "[BUNDLE]: " msg, ##__VA_ARGS__)
+
+struct glt_bundle_t {
+    const unsigned char *base;
+    size_t size;
+    const glt_bundle_toc_entry_t *toc;
+    uint32_t count;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+// helper funcs
+
+static bool map_file(glt_bundle_t *bundle, const char *path);
+
+static void unmap_file(glt_bundle_t *bundle);
+
+static bool validate(glt_bundle_t *bundle);
+
+static const glt_bundle_toc_entry_t *find_toc_entry(const glt_bundle_t *bundle, const char *name);
+
+static void fill_entry(const glt_bundle_t *bundle, const glt_bundle_toc_entry_t *toc, glt_bundle_entry_t *out);
+
+static bool texture_container(const glt_bundle_t *bundle, const glt_bundle_toc_entry_t *toc, glt_container_t *out);
+
+// public funcs
+
+glt_bundle_t *glt_bundle_open(const char *path) {
+    if (!path) {
+        return NULL;
+    }
+    GLT_ZONE("glt_bundle_open");
+
+    glt_bundle_t *bundle = calloc(1, sizeof(glt_bundle_t));
+    if (!bundle) {
+        BUNDLE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+
+    if (!map_file(bundle, path)) {
+        BUNDLE_LOG(GLT_LOG_ERROR, "can't map file: '%s'", path);
+        free(bundle);
+        return NULL;
+    }
+
+    if (!validate(bundle)) {
+        BUNDLE_LOG(GLT_LOG_ERROR, "'%s' is not a valid bundle", path);
+        unmap_file(bundle);
+        free(bundle);
+        return NULL;
+    }
+
+    return bundle;
+}
+
+void glt_bundle_close(glt_bundle_t *bundle) {
+    if (!bundle) {
+        return;
+    }
+    unmap_file(bundle);
+    free(bundle);
+}
+
+size_t glt_bundle_get_entry_count(const glt_bundle_t *bundle) {
+    return bundle ? bundle->count : 0;
+}
+
+bool glt_bundle_get_entry(const glt_bundle_t *bundle, size_t index, glt_bundle_entry_t *out) {
+    if (!bundle || !out || index >= bundle->count) {
+        return false;
+    }
+    fill_entry(bundle, &bundle->toc[index], out);
+    return true;
+}
+
+bool glt_bundle_find(const glt_bundle_t *bundle, const char *name, glt_bundle_entry_t *out) {
+    if (!bundle || !name || !out) {
+        return false;
+    }
+    const glt_bundle_toc_entry_t *toc = find_toc_entry(bundle, name);
+    if (!toc) {
+        return false;
+    }
+    fill_entry(bundle, toc, out);
+    return true;
+}
+
+glt_texture_t *glt_bundle_load_texture(const glt_bundle_t *bundle, const char *name, const glt_texture_options_t *options) {
+    if (!bundle || !name) {
+        return NULL;
+    }
+    GLT_ZONE("glt_bundle_load_texture");
+
+    const glt_bundle_toc_entry_t *toc = find_toc_entry(bundle, name);
+    if (!toc || toc->type != GLT_BUNDLE_TEXTURE) {
+        BUNDLE_LOG(GLT_LOG_ERROR, "no texture named '%s'", name);
+        return NULL;
+    }
+
+    glt_container_t container;
+    if (!texture_container(bundle, toc, &container)) {
+        BUNDLE_LOG(GLT_LOG_ERROR, "texture '%s' has an invalid layout", name);
+        return NULL;
+    }
+
+    glt_texture_t *texture = glt_texture_create_from_container(&container, options);
+    glt_debug_label(GL_TEXTURE, glt_texture_get_id(texture), name);
+    return texture;
+}
+
+GLuint glt_bundle_compile_shader(const glt_bundle_t *bundle, const char *name) {
+    if (!bundle || !name) {
+        return 0;
+    }
+
+    const glt_bundle_toc_entry_t *toc = find_toc_entry(bundle, name);
+    if (!toc || toc->type != GLT_BUNDLE_SHADER) {
+        BUNDLE_LOG(GLT_LOG_ERROR, "no shader named '%s'", name);
+        return 0;
+    }
+
+    // sources are stored nul-terminated, validate() checked the last byte
+    const GLuint shader = glt_shader_compile_src(toc->internal_format, (const char *) (bundle->base + toc->offset));
+    glt_debug_label(GL_SHADER, shader, name);
+    return shader;
+}
+
+glt_shader_t *glt_bundle_load_shader(const glt_bundle_t *bundle, const char *vertex_name, const char *fragment_name) {
+    const GLuint vertex_shader = glt_bundle_compile_shader(bundle, vertex_name);
+    const GLuint fragment_shader = glt_bundle_compile_shader(bundle, fragment_name);
+
+    glt_shader_t *shader = NULL;
+    if (vertex_shader && fragment_shader) {
+        shader = glt_shader_prog_create(vertex_shader, fragment_shader);
+    }
+
+    if (vertex_shader) {
+        glDeleteShader(vertex_shader);
+    }
+    if (fragment_shader) {
+        glDeleteShader(fragment_shader);
+    }
+    return shader;
+}
+
+glt_vertex_buffer_t *glt_bundle_load_buffer(const glt_bundle_t *bundle, const char *name, GLenum usage) {
+    glt_bundle_entry_t entry;
+    if (!glt_bundle_find(bundle, name, &entry)) {
+        BUNDLE_LOG(GLT_LOG_ERROR, "no entry named '%s'", name ? name : "(null)");
+        return NULL;
+    }
+    glt_vertex_buffer_t *buffer = glt_vertex_buffer_create(entry.data, (GLsizeiptr) entry.size, usage);
+    glt_debug_label(GL_BUFFER, glt_vertex_buffer_get_id(buffer), name);
+    return buffer;
+}
+
+// helper funcs
+
+static bool map_file(glt_bundle_t *bundle, const char *path) {
+#ifdef _WIN32
+    bundle->file = CreateFileA(
+        path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL
+    );
+    if (bundle->file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(bundle->file, &size) || size.QuadPart <= 0) {
+        CloseHandle(bundle->file);
+        return false;
+    }
+    bundle->mapping = CreateFileMappingA(bundle->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!bundle->mapping) {
+        CloseHandle(bundle->file);
+        return false;
+    }
+    bundle->base = MapViewOfFile(bundle->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!bundle->base) {
+        CloseHandle(bundle->mapping);
+        CloseHandle(bundle->file);
+        return false;
+    }
+    bundle->size = (size_t) size.QuadPart;
+    return true;
+#else
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    void *base = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps the file referenced
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    bundle->base = base;
+    bundle->size = (size_t) st.st_size;
+    return true;
+#endif
+}
+
+static void unmap_file(glt_bundle_t *bundle) {
+    if (!bundle->base) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(bundle->base);
+    CloseHandle(bundle->mapping);
+    CloseHandle(bundle->file);
+#else
+    munmap((void *) bundle->base, bundle->size);
+#endif
+    bundle->base = NULL;
+}
+
+static bool validate(glt_bundle_t *bundle) {
+    glt_bundle_header_t header;
+    if (bundle->size < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, bundle->base, sizeof(header));
+
+    if (memcmp(header.magic, GLT_BUNDLE_MAGIC, 4) != 0 || header.version != GLT_BUNDLE_VERSION) {
+        return false;
+    }
+    if (header.file_size != bundle->size || header.toc_offset % GLT_BUNDLE_ALIGNMENT != 0) {
+        return false;
+    }
+    if (header.toc_offset > bundle->size ||
+        (bundle->size - header.toc_offset) / sizeof(glt_bundle_toc_entry_t) < header.entry_count) {
+        return false;
+    }
+
+    bundle->toc = (const glt_bundle_toc_entry_t *) (bundle->base + header.toc_offset);
+    bundle->count = header.entry_count;
+
+    for (uint32_t i = 0; i < header.entry_count; ++i) {
+        const glt_bundle_toc_entry_t *toc = &bundle->toc[i];
+        if (memchr(toc->name, '\0', GLT_BUNDLE_NAME_MAX) == NULL || toc->type >= GLT_BUNDLE__COUNT) {
+            return false;
+        }
+        if (toc->offset > header.toc_offset || toc->size > header.toc_offset - toc->offset) {
+            return false;
+        }
+        // lookups binary search the toc
+        if (i > 0 && strcmp(bundle->toc[i - 1].name, toc->name) >= 0) {
+            return false;
+        }
+        if (toc->type == GLT_BUNDLE_SHADER && (toc->size == 0 || bundle->base[toc->offset + toc->size - 1] != '\0')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const glt_bundle_toc_entry_t *find_toc_entry(const glt_bundle_t *bundle, const char *name) {
+    uint32_t lo = 0, hi = bundle->count;
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        const int cmp = strcmp(bundle->toc[mid].name, name);
+        if (cmp == 0) {
+            return &bundle->toc[mid];
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+static void fill_entry(const glt_bundle_t *bundle, const glt_bundle_toc_entry_t *toc, glt_bundle_entry_t *out) {
+    out->name = toc->name;
+    out->type = (glt_bundle_entry_type_e) toc->type;
+    out->data = bundle->base + toc->offset;
+    out->size = (size_t) toc->size;
+    out->format = toc->internal_format;
+    out->width = (GLsizei) toc->width;
+    out->height = (GLsizei) toc->height;
+    out->levels = (GLint) toc->levels;
+}
+
+static bool texture_container(const glt_bundle_t *bundle, const glt_bundle_toc_entry_t *toc, glt_container_t *out) {
+    if (toc->width == 0 || toc->height == 0 || toc->levels == 0 || toc->levels > GLT_CONTAINER_MAX_LEVELS) {
+        return false;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->compressed = toc->texel_bytes == 0;
+    out->internal_format = toc->internal_format;
+    out->format = toc->format;
+    out->type = toc->pixel_type;
+    out->width = (GLsizei) toc->width;
+    out->height = (GLsizei) toc->height;
+    out->levels = (GLint) toc->levels;
+
+    uint64_t offset = 0;
+    GLsizei width = out->width, height = out->height;
+    for (GLint i = 0; i < out->levels; ++i) {
+        const size_t size = out->compressed
+                                ? glt_container_level_size(out->internal_format, width, height)
+                                : (size_t) width * (size_t) height * toc->texel_bytes;
+        if (size == 0 || offset + size > toc->size) {
+            return false;
+        }
+
+        out->level[i].data = bundle->base + toc->offset + offset;
+        out->level[i].size = size;
+        out->level[i].width = width;
+        out->level[i].height = height;
+
+        offset = glt_bundle_align(offset + size);
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return true;
+}
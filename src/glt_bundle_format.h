@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+
+// on-disk layout shared by glt_bundle and the glt_pack tool, little-endian:
+//
+//   header | payloads, each GLT_BUNDLE_ALIGNMENT aligned | toc (entries sorted by name)
+//
+// texture payloads hold their mip levels back to back, every level starting aligned
+
+#define GLT_BUNDLE_MAGIC "GLTB"
+#define GLT_BUNDLE_VERSION 1
+#define GLT_BUNDLE_ALIGNMENT 64
+#define GLT_BUNDLE_NAME_MAX 64
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+    uint64_t toc_offset;
+    uint64_t file_size;
+} glt_bundle_header_t;
+
+typedef struct {
+    char name[GLT_BUNDLE_NAME_MAX];
+    uint32_t type;
+    // textures: GL internal format, shaders: stage, indices: GL index type
+    uint32_t internal_format;
+    // uncompressed textures only
+    uint32_t format;
+    uint32_t pixel_type;
+    uint32_t texel_bytes;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levels;
+    uint64_t offset;
+    uint64_t size;
+} glt_bundle_toc_entry_t;
+
+_Static_assert(sizeof(glt_bundle_header_t) == 32, "bundle header layout");
+_Static_assert(sizeof(glt_bundle_toc_entry_t) == 112, "bundle toc entry layout");
+
+static inline uint64_t glt_bundle_align(uint64_t value) {
+    return (value + GLT_BUNDLE_ALIGNMENT - 1) & ~(uint64_t) (GLT_BUNDLE_ALIGNMENT - 1);
+}
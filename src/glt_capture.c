@@ -0,0 +1,494 @@
+#include "glt_capture.h"
+#include "glt_job_queue.h"
+#include "glt_image.h"
+#include "glt_trace.h"
+#include "glt_log.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "glfw-3.4/deps/stb_image_write.h"
+
+#define CAPTURE_LOG(level, msg, ...)    glt_log(level, "[CAPTURE]: " msg, ##__VA_ARGS__)
+
+#define DEFAULT_RING_SIZE 3
+#define DEFAULT_MAX_PENDING 8
+
+typedef struct {
+    GLuint pbo;
+    size_t capacity;
+    GLsync fence;
+    int width;
+    int height;
+
+    // decided when the frame is read, so a stop or a new request can't change where it goes
+    char *screenshot_path;
+    glt_capture_format_e screenshot_format;
+    char *sequence_path;
+    FILE *raw;
+} slot_t;
+
+typedef struct {
+    glt_capture_t *capture;
+    unsigned char *pixels;
+    int width;
+    int height;
+    glt_capture_format_e format;
+    // a file of its own, or NULL to append to raw
+    char *path;
+    FILE *raw;
+} encode_job_t;
+
+struct glt_capture_t {
+    glt_window_t *window;
+    glt_capture_options_t options;
+
+    // in flight from head on, oldest first
+    slot_t *slots;
+    int head;
+    int in_flight;
+
+    // a single worker keeps raw sequence frames in order
+    glt_job_queue_t *encoder;
+    atomic_int pending;
+
+    char *screenshot_path;
+    glt_capture_format_e screenshot_format;
+
+    bool recording;
+    char *sequence_path;
+    glt_capture_format_e sequence_format;
+    FILE *raw_file;
+    uint64_t sequence_index;
+
+    uint64_t captured;
+    uint64_t dropped;
+    atomic_uint_fast64_t written;
+    atomic_uint_fast64_t failed;
+};
+
+// helper funcs
+
+static char *copy_string(const char *str);
+
+static bool is_index_pattern(const char *path);
+
+static void read_frame(glt_capture_t *capture, bool screenshot, bool sequence);
+
+static void collect(glt_capture_t *capture, bool block);
+
+static bool dispatch(
+    glt_capture_t *capture, unsigned char *pixels, int width, int height,
+    glt_capture_format_e format, char *path, FILE *raw
+);
+
+static void encode(void *user);
+
+static void close_file(void *user);
+
+// public funcs
+
+glt_capture_t *glt_capture_create(glt_window_t *window, const glt_capture_options_t *options) {
+    if (!window) {
+        return NULL;
+    }
+
+    glt_capture_t *capture = calloc(1, sizeof(glt_capture_t));
+    if (!capture) {
+        CAPTURE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+    capture->window = window;
+    if (options) {
+        capture->options = *options;
+    }
+    if (capture->options.ring_size <= 0) {
+        capture->options.ring_size = DEFAULT_RING_SIZE;
+    }
+    if (capture->options.max_pending <= 0) {
+        capture->options.max_pending = DEFAULT_MAX_PENDING;
+    }
+    atomic_init(&capture->pending, 0);
+    atomic_init(&capture->written, 0);
+    atomic_init(&capture->failed, 0);
+
+    capture->slots = calloc((size_t) capture->options.ring_size, sizeof(slot_t));
+    capture->encoder = glt_job_queue_create(1);
+    if (!capture->slots || !capture->encoder) {
+        CAPTURE_LOG(GLT_LOG_ERROR, "failed to create the capture ring");
+        glt_job_queue_destroy(capture->encoder);
+        free(capture->slots);
+        free(capture);
+        return NULL;
+    }
+    for (int i = 0; i < capture->options.ring_size; ++i) {
+        glGenBuffers(1, &capture->slots[i].pbo);
+    }
+    return capture;
+}
+
+void glt_capture_destroy(glt_capture_t *capture) {
+    if (!capture) {
+        return;
+    }
+    glt_capture_stop_sequence(capture);
+    glt_capture_flush(capture);
+    glt_job_queue_destroy(capture->encoder);
+
+    for (int i = 0; i < capture->options.ring_size; ++i) {
+        glDeleteBuffers(1, &capture->slots[i].pbo);
+    }
+    free(capture->screenshot_path);
+    free(capture->slots);
+    free(capture);
+}
+
+bool glt_capture_screenshot(glt_capture_t *capture, const char *path, glt_capture_format_e format) {
+    if (!capture || !path || format >= GLT_CAPTURE__COUNT) {
+        return false;
+    }
+    if (capture->screenshot_path) {
+        CAPTURE_LOG(GLT_LOG_WARNING, "a screenshot is already pending, '%s' ignored", path);
+        return false;
+    }
+    capture->screenshot_path = copy_string(path);
+    capture->screenshot_format = format;
+    return capture->screenshot_path != NULL;
+}
+
+bool glt_capture_start_sequence(glt_capture_t *capture, const char *path, glt_capture_format_e format) {
+    if (!capture || !path || format >= GLT_CAPTURE__COUNT) {
+        return false;
+    }
+    glt_capture_stop_sequence(capture);
+
+    if (format == GLT_CAPTURE_RAW) {
+        capture->raw_file = fopen(path, "wb");
+        if (!capture->raw_file) {
+            CAPTURE_LOG(GLT_LOG_ERROR, "can't open '%s'", path);
+            return false;
+        }
+    } else if (!is_index_pattern(path)) {
+        CAPTURE_LOG(GLT_LOG_ERROR, "'%s' needs exactly one %%d style frame index conversion", path);
+        return false;
+    } else {
+        capture->sequence_path = copy_string(path);
+        if (!capture->sequence_path) {
+            return false;
+        }
+    }
+
+    capture->sequence_format = format;
+    capture->sequence_index = 0;
+    capture->recording = true;
+    return true;
+}
+
+void glt_capture_stop_sequence(glt_capture_t *capture) {
+    if (!capture || !capture->recording) {
+        return;
+    }
+    capture->recording = false;
+    free(capture->sequence_path);
+    capture->sequence_path = NULL;
+
+    if (capture->raw_file) {
+        // frames still in flight append to the file, so it closes after them
+        collect(capture, true);
+        if (!glt_job_queue_push(capture->encoder, close_file, capture->raw_file)) {
+            glt_job_queue_wait(capture->encoder);
+            fclose(capture->raw_file);
+        }
+        capture->raw_file = NULL;
+    }
+}
+
+bool glt_capture_is_recording(const glt_capture_t *capture) {
+    return capture && capture->recording;
+}
+
+void glt_capture_frame(glt_capture_t *capture) {
+    if (!capture) {
+        return;
+    }
+    GLT_ZONE("glt_capture_frame");
+    collect(capture, false);
+
+    const bool screenshot = capture->screenshot_path != NULL;
+    bool sequence = capture->recording;
+    if (!screenshot && !sequence) {
+        return;
+    }
+
+    // screenshots wait for room, sequence frames are dropped rather than stalling the frame
+    if (capture->in_flight == capture->options.ring_size) {
+        capture->dropped += sequence;
+        return;
+    }
+    if (sequence && atomic_load(&capture->pending) >= capture->options.max_pending) {
+        capture->dropped++;
+        sequence = false;
+        if (!screenshot) {
+            return;
+        }
+    }
+    read_frame(capture, screenshot, sequence);
+}
+
+void glt_capture_flush(glt_capture_t *capture) {
+    if (!capture) {
+        return;
+    }
+    collect(capture, true);
+    glt_job_queue_wait(capture->encoder);
+}
+
+void glt_capture_get_stats(const glt_capture_t *capture, glt_capture_stats_t *stats) {
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(glt_capture_stats_t));
+    if (!capture) {
+        return;
+    }
+    stats->captured = capture->captured;
+    stats->dropped = capture->dropped;
+    stats->written = atomic_load(&capture->written);
+    stats->failed = atomic_load(&capture->failed);
+}
+
+// helper funcs
+
+static char *copy_string(const char *str) {
+    char *copy = malloc(strlen(str) + 1);
+    if (!copy) {
+        CAPTURE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+    strcpy(copy, str);
+    return copy;
+}
+
+static bool is_index_pattern(const char *path) {
+    // the path becomes a printf format with one int argument, so anything else is undefined
+    int conversions = 0;
+    for (const char *c = path; *c; ++c) {
+        if (*c != '%') {
+            continue;
+        }
+        if (c[1] == '%') {
+            ++c;
+            continue;
+        }
+        ++c;
+        while (*c == '0' || *c == '-' || *c == '+' || *c == ' ') {
+            ++c;
+        }
+        while (*c >= '0' && *c <= '9') {
+            ++c;
+        }
+        if (*c != 'd' && *c != 'i') {
+            return false;
+        }
+        ++conversions;
+    }
+    return conversions == 1;
+}
+
+static void read_frame(glt_capture_t *capture, bool screenshot, bool sequence) {
+    int width = 0, height = 0;
+    glt_window_get_framebuffer_size(capture->window, &width, &height);
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    slot_t *slot = &capture->slots[(capture->head + capture->in_flight) % capture->options.ring_size];
+    const size_t size = (size_t) width * (size_t) height * 4;
+
+    GLint prev_pack = 0, prev_read_fbo = 0, prev_read_buffer = 0;
+    glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &prev_pack);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prev_read_fbo);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    if (slot->capacity != size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr) size, NULL, GL_STREAM_READ);
+        slot->capacity = size;
+    }
+
+    const GLuint fbo = glt_window_get_framebuffer(capture->window);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    if (fbo == 0) {
+        glGetIntegerv(GL_READ_BUFFER, &prev_read_buffer);
+        glReadBuffer(GL_BACK);
+    }
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (fbo == 0) {
+        glReadBuffer((GLenum) prev_read_buffer);
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint) prev_read_fbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint) prev_pack);
+
+    slot->width = width;
+    slot->height = height;
+    if (screenshot) {
+        slot->screenshot_path = capture->screenshot_path;
+        slot->screenshot_format = capture->screenshot_format;
+        capture->screenshot_path = NULL;
+    }
+    if (sequence && capture->raw_file) {
+        slot->raw = capture->raw_file;
+    } else if (sequence) {
+        const int len = snprintf(NULL, 0, capture->sequence_path, (int) capture->sequence_index);
+        slot->sequence_path = len > 0 ? malloc((size_t) len + 1) : NULL;
+        if (slot->sequence_path) {
+            snprintf(slot->sequence_path, (size_t) len + 1, capture->sequence_path, (int) capture->sequence_index);
+        }
+    }
+    capture->sequence_index += sequence;
+    capture->captured++;
+    capture->in_flight++;
+}
+
+static void collect(glt_capture_t *capture, bool block) {
+    if (capture->in_flight == 0) {
+        return;
+    }
+    GLint prev_pack = 0;
+    glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &prev_pack);
+
+    while (capture->in_flight > 0) {
+        slot_t *slot = &capture->slots[capture->head];
+        const GLenum status = glClientWaitSync(slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, block ? UINT64_MAX : 0);
+        // fences signal in order, nothing behind an unsignaled one is done either
+        if (status == GL_TIMEOUT_EXPIRED) {
+            break;
+        }
+        glDeleteSync(slot->fence);
+        slot->fence = NULL;
+
+        const size_t size = (size_t) slot->width * (size_t) slot->height * 4;
+        unsigned char *pixels = status != GL_WAIT_FAILED ? malloc(size) : NULL;
+        const void *mapped = NULL;
+        if (pixels) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+            mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr) size, GL_MAP_READ_BIT);
+        }
+        if (mapped) {
+            memcpy(pixels, mapped, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+            // a frame wanted as both gets a copy for the screenshot
+            unsigned char *screenshot_pixels = pixels;
+            const bool sequence = slot->sequence_path || slot->raw;
+            if (slot->screenshot_path && sequence) {
+                screenshot_pixels = malloc(size);
+                if (screenshot_pixels) {
+                    memcpy(screenshot_pixels, pixels, size);
+                }
+            }
+            if (slot->screenshot_path && screenshot_pixels) {
+                dispatch(
+                    capture, screenshot_pixels, slot->width, slot->height,
+                    slot->screenshot_format, slot->screenshot_path, NULL
+                );
+                slot->screenshot_path = NULL;
+            } else if (slot->screenshot_path) {
+                atomic_fetch_add(&capture->failed, 1);
+            }
+            if (sequence) {
+                dispatch(
+                    capture, pixels, slot->width, slot->height,
+                    slot->raw ? GLT_CAPTURE_RAW : GLT_CAPTURE_PNG, slot->sequence_path, slot->raw
+                );
+                slot->sequence_path = NULL;
+            }
+        } else {
+            CAPTURE_LOG(GLT_LOG_ERROR, "failed to read back a captured frame");
+            atomic_fetch_add(&capture->failed, 1);
+            free(pixels);
+        }
+
+        free(slot->screenshot_path);
+        free(slot->sequence_path);
+        slot->screenshot_path = NULL;
+        slot->sequence_path = NULL;
+        slot->raw = NULL;
+        capture->head = (capture->head + 1) % capture->options.ring_size;
+        capture->in_flight--;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint) prev_pack);
+}
+
+static bool dispatch(
+    glt_capture_t *capture, unsigned char *pixels, int width, int height,
+    glt_capture_format_e format, char *path, FILE *raw
+) {
+    encode_job_t *job = malloc(sizeof(encode_job_t));
+    if (!job) {
+        CAPTURE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        atomic_fetch_add(&capture->failed, 1);
+        free(pixels);
+        free(path);
+        return false;
+    }
+    *job = (encode_job_t) {capture, pixels, width, height, format, path, raw};
+
+    atomic_fetch_add(&capture->pending, 1);
+    if (!glt_job_queue_push(capture->encoder, encode, job)) {
+        atomic_fetch_sub(&capture->pending, 1);
+        atomic_fetch_add(&capture->failed, 1);
+        free(pixels);
+        free(path);
+        free(job);
+        return false;
+    }
+    return true;
+}
+
+static void encode(void *user) {
+    encode_job_t *job = user;
+    GLT_ZONE("capture encode");
+
+    // GL rows are bottom-up
+    glt_image_flip_vertical(job->pixels, job->width, job->height, 4);
+    const size_t size = (size_t) job->width * (size_t) job->height * 4;
+
+    bool ok = false;
+    if (job->raw) {
+        ok = fwrite(job->pixels, 1, size, job->raw) == size;
+    } else if (job->format == GLT_CAPTURE_PNG) {
+        // back buffer alpha is whatever blending left there, screenshots are opaque
+        for (size_t i = 3; i < size; i += 4) {
+            job->pixels[i] = 255;
+        }
+        ok = stbi_write_png(job->path, job->width, job->height, 4, job->pixels, job->width * 4) != 0;
+    } else {
+        FILE *file = fopen(job->path, "wb");
+        if (file) {
+            ok = fwrite(job->pixels, 1, size, file) == size;
+            ok = fclose(file) == 0 && ok;
+        }
+    }
+
+    if (ok) {
+        atomic_fetch_add(&job->capture->written, 1);
+    } else {
+        CAPTURE_LOG(GLT_LOG_ERROR, "failed to write '%s'", job->path ? job->path : "raw sequence");
+        atomic_fetch_add(&job->capture->failed, 1);
+    }
+    atomic_fetch_sub(&job->capture->pending, 1);
+
+    free(job->pixels);
+    free(job->path);
+    free(job);
+}
+
+static void close_file(void *user) {
+    fclose(user);
+}
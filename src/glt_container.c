@@ -0,0 +1,440 @@
+#include "glt_container.h"
+#include "glt_log.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#define CONTAINER_LOG(level, msg, ...)    glt_log(level, "[CONTAINER]: " msg, ##__VA_ARGS__)
+
+static const unsigned char ktx2_magic[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+#define KTX2_HEADER_SIZE 80
+#define KTX2_LEVEL_ENTRY_SIZE 24
+
+#define DDS_HEADER_SIZE 128
+#define DDS_DX10_HEADER_SIZE 20
+#define DDPF_ALPHAPIXELS 0x1
+#define DDPF_FOURCC 0x4
+#define DDPF_RGB 0x40
+
+#define FOURCC(a, b, c, d) ((uint32_t) (a) | ((uint32_t) (b) << 8) | ((uint32_t) (c) << 16) | ((uint32_t) (d) << 24))
+
+typedef struct {
+    uint32_t code;
+    GLenum internal_format;
+} format_map_t;
+
+// VkFormat -> GL
+static const format_map_t vk_formats[] = {
+    {9, GL_R8},
+    {16, GL_RG8},
+    {37, GL_RGBA8},
+    {43, GL_SRGB8_ALPHA8},
+    {131, GL_COMPRESSED_RGB_S3TC_DXT1_EXT},
+    {132, GL_COMPRESSED_SRGB_S3TC_DXT1_EXT},
+    {133, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT},
+    {134, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT},
+    {135, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT},
+    {136, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT},
+    {137, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT},
+    {138, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT},
+    {139, GL_COMPRESSED_RED_RGTC1},
+    {140, GL_COMPRESSED_SIGNED_RED_RGTC1},
+    {141, GL_COMPRESSED_RG_RGTC2},
+    {142, GL_COMPRESSED_SIGNED_RG_RGTC2},
+    {143, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT},
+    {144, GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT},
+    {145, GL_COMPRESSED_RGBA_BPTC_UNORM},
+    {146, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM},
+    {147, GL_COMPRESSED_RGB8_ETC2},
+    {148, GL_COMPRESSED_SRGB8_ETC2},
+    {149, GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2},
+    {150, GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2},
+    {151, GL_COMPRESSED_RGBA8_ETC2_EAC},
+    {152, GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC},
+    {153, GL_COMPRESSED_R11_EAC},
+    {154, GL_COMPRESSED_SIGNED_R11_EAC},
+    {155, GL_COMPRESSED_RG11_EAC},
+    {156, GL_COMPRESSED_SIGNED_RG11_EAC},
+};
+
+// DXGI_FORMAT -> GL
+static const format_map_t dxgi_formats[] = {
+    {28, GL_RGBA8},
+    {29, GL_SRGB8_ALPHA8},
+    {71, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT},
+    {72, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT},
+    {74, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT},
+    {75, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT},
+    {77, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT},
+    {78, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT},
+    {80, GL_COMPRESSED_RED_RGTC1},
+    {81, GL_COMPRESSED_SIGNED_RED_RGTC1},
+    {83, GL_COMPRESSED_RG_RGTC2},
+    {84, GL_COMPRESSED_SIGNED_RG_RGTC2},
+    {95, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT},
+    {96, GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT},
+    {98, GL_COMPRESSED_RGBA_BPTC_UNORM},
+    {99, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM},
+};
+
+// helper funcs
+
+static bool parse_ktx2(const unsigned char *data, size_t size, glt_container_t *out);
+
+static bool parse_dds(const unsigned char *data, size_t size, glt_container_t *out);
+
+static GLenum map_format(const format_map_t *map, size_t count, uint32_t code);
+
+static bool set_uncompressed(glt_container_t *out, GLenum internal_format);
+
+static uint32_t clamp_levels(uint32_t levels, uint32_t width, uint32_t height, const char *kind);
+
+static bool check_dimensions(uint32_t width, uint32_t height, GLenum internal_format, size_t available, const char *kind);
+
+static uint32_t read_u32(const unsigned char *p);
+
+static uint64_t read_u64(const unsigned char *p);
+
+// public funcs
+
+bool glt_container_is_known(const unsigned char *data, size_t size) {
+    if (!data) {
+        return false;
+    }
+    if (size >= sizeof(ktx2_magic) && memcmp(data, ktx2_magic, sizeof(ktx2_magic)) == 0) {
+        return true;
+    }
+    return size >= 4 && memcmp(data, "DDS ", 4) == 0;
+}
+
+bool glt_container_parse(const unsigned char *data, size_t size, glt_container_t *out) {
+    if (!data || !out) {
+        return false;
+    }
+    memset(out, 0, sizeof(glt_container_t));
+
+    if (size >= sizeof(ktx2_magic) && memcmp(data, ktx2_magic, sizeof(ktx2_magic)) == 0) {
+        return parse_ktx2(data, size, out);
+    }
+    if (size >= 4 && memcmp(data, "DDS ", 4) == 0) {
+        return parse_dds(data, size, out);
+    }
+    return false;
+}
+
+size_t glt_container_block_bytes(GLenum internal_format) {
+    switch (internal_format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RED_RGTC1:
+        case GL_COMPRESSED_SIGNED_RED_RGTC1:
+        case GL_COMPRESSED_RGB8_ETC2:
+        case GL_COMPRESSED_SRGB8_ETC2:
+        case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+        case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+        case GL_COMPRESSED_R11_EAC:
+        case GL_COMPRESSED_SIGNED_R11_EAC:
+            return 8;
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_RG_RGTC2:
+        case GL_COMPRESSED_SIGNED_RG_RGTC2:
+        case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+        case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+        case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+        case GL_COMPRESSED_RG11_EAC:
+        case GL_COMPRESSED_SIGNED_RG11_EAC:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+size_t glt_container_level_size(GLenum internal_format, GLsizei width, GLsizei height) {
+    const size_t block = glt_container_block_bytes(internal_format);
+    if (block) {
+        return ((size_t) width + 3) / 4 * (((size_t) height + 3) / 4) * block;
+    }
+
+    size_t texel = 0;
+    switch (internal_format) {
+        case GL_R8: texel = 1;
+            break;
+        case GL_RG8: texel = 2;
+            break;
+        // only DDS X8R8G8B8 maps to RGB8, stored padded to 4 bytes
+        case GL_RGB8:
+        case GL_RGBA8:
+        case GL_SRGB8_ALPHA8: texel = 4;
+            break;
+        default:
+            return 0;
+    }
+    return (size_t) width * (size_t) height * texel;
+}
+
+// helper funcs
+
+static bool parse_ktx2(const unsigned char *data, size_t size, glt_container_t *out) {
+    if (size < KTX2_HEADER_SIZE) {
+        CONTAINER_LOG(GLT_LOG_ERROR, "truncated KTX2 header");
+        return false;
+    }
+
+    const uint32_t vk_format = read_u32(data + 12);
+    const uint32_t width = read_u32(data + 20);
+    const uint32_t height = read_u32(data + 24);
+    const uint32_t depth = read_u32(data + 28);
+    const uint32_t layers = read_u32(data + 32);
+    const uint32_t faces = read_u32(data + 36);
+    const uint32_t levels = read_u32(data + 40);
+    const uint32_t supercompression = read_u32(data + 44);
+
+    if (depth > 1 || layers > 1 || faces != 1) {
+        CONTAINER_LOG(GLT_LOG_ERROR, "only 2D KTX2 textures are supported");
+        return false;
+    }
+    if (supercompression != 0) {
+        CONTAINER_LOG(GLT_LOG_ERROR, "KTX2 supercompression scheme %u is not supported", supercompression);
+        return false;
+    }
+
+    const GLenum internal_format = map_format(vk_formats, sizeof(vk_formats) / sizeof(vk_formats[0]), vk_format);
+    if (!internal_format) {
+        CONTAINER_LOG(GLT_LOG_ERROR, "unsupported KTX2 vkFormat %u", vk_format);
+        return false;
+    }
+    if (!set_uncompressed(out, internal_format)) {
+        out->compressed = true;
+        out->internal_format = internal_format;
+    }
+
+    if (!check_dimensions(width, height, internal_format, size - KTX2_HEADER_SIZE, "KTX2")) {
+        return false;
+    }
+
+    // levelCount 0 asks the loader to generate mips, we only upload what's stored
+    const uint32_t count = clamp_levels(levels ? levels : 1, width, height, "KTX2");
+    if (count > GLT_CONTAINER_MAX_LEVELS) {
+        CONTAINER_LOG(GLT_LOG_ERROR, "bad KTX2 level count %u", count);
+        return false;
+    }
+    if (size < KTX2_HEADER_SIZE + (size_t) count * KTX2_LEVEL_ENTRY_SIZE) {
+        CONTAINER_LOG(GLT_LOG_ERROR, "truncated KTX2 level index");
+        return false;
+    }
+
+    out->width = (GLsizei) width;
+    out->height = (GLsizei) height;
+    out->levels = (GLint) count;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const unsigned char *entry = data + KTX2_HEADER_SIZE + (size_t) i * KTX2_LEVEL_ENTRY_SIZE;
+        const uint64_t offset = read_u64(entry);
+        const uint64_t length = read_u64(entry + 8);
+        const GLsizei w = width >> i ? (GLsizei) (width >> i) : 1;
+        const GLsizei h = height >> i ? (GLsizei) (height >> i) : 1;
+
+        if (offset > size || length > size - offset || length < glt_container_level_size(internal_format, w, h)) {
+            CONTAINER_LOG(GLT_LOG_ERROR, "KTX2 level %u is out of bounds", i);
+            return false;
+        }
+        out->level[i].data = data + offset;
+        out->level[i].size = glt_container_level_size(internal_format, w, h);
+        out->level[i].width = w;
+        out->level[i].height = h;
+    }
+
+    return true;
+}
+
+static bool parse_dds(const unsigned char *data, size_t size, glt_container_t *out) {
+    if (size < DDS_HEADER_SIZE || read_u32(data + 4) != 124) {
+        CONTAINER_LOG(GLT_LOG_ERROR, "truncated or invalid DDS header");
+        return false;
+    }
+
+    const uint32_t height = read_u32(data + 12);
+    const uint32_t width = read_u32(data + 16);
+    const uint32_t mips = read_u32(data + 28);
+    const uint32_t pf_flags = read_u32(data + 80);
+    const uint32_t fourcc = read_u32(data + 84);
+    const uint32_t bit_count = read_u32(data + 88);
+    const uint32_t r_mask = read_u32(data + 92);
+    const uint32_t a_mask = read_u32(data + 104);
+    const uint32_t caps2 = read_u32(data + 112);
+
+    if (caps2 & 0x200u) {
+        CONTAINER_LOG(GLT_LOG_ERROR, "DDS cubemaps are not supported");
+        return false;
+    }
+
+    size_t offset = DDS_HEADER_SIZE;
+    GLenum internal_format = 0;
+
+    if (pf_flags & DDPF_FOURCC) {
+        switch (fourcc) {
+            case FOURCC('D', 'X', 'T', '1'): internal_format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+                break;
+            case FOURCC('D', 'X', 'T', '3'): internal_format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+                break;
+            case FOURCC('D', 'X', 'T', '5'): internal_format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                break;
+            case FOURCC('A', 'T', 'I', '1'):
+            case FOURCC('B', 'C', '4', 'U'): internal_format = GL_COMPRESSED_RED_RGTC1;
+                break;
+            case FOURCC('B', 'C', '4', 'S'): internal_format = GL_COMPRESSED_SIGNED_RED_RGTC1;
+                break;
+            case FOURCC('A', 'T', 'I', '2'):
+            case FOURCC('B', 'C', '5', 'U'): internal_format = GL_COMPRESSED_RG_RGTC2;
+                break;
+            case FOURCC('B', 'C', '5', 'S'): internal_format = GL_COMPRESSED_SIGNED_RG_RGTC2;
+                break;
+            case FOURCC('D', 'X', '1', '0'): {
+                if (size < DDS_HEADER_SIZE + DDS_DX10_HEADER_SIZE) {
+                    CONTAINER_LOG(GLT_LOG_ERROR, "truncated DDS DX10 header");
+                    return false;
+                }
+                const uint32_t dxgi = read_u32(data + DDS_HEADER_SIZE);
+                const uint32_t dimension = read_u32(data + DDS_HEADER_SIZE + 4);
+                const uint32_t array_size = read_u32(data + DDS_HEADER_SIZE + 12);
+                if (dimension != 3 || array_size > 1) {
+                    CONTAINER_LOG(GLT_LOG_ERROR, "only 2D DDS textures are supported");
+                    return false;
+                }
+                internal_format = map_format(dxgi_formats, sizeof(dxgi_formats) / sizeof(dxgi_formats[0]), dxgi);
+                offset += DDS_DX10_HEADER_SIZE;
+                break;
+            }
+            default:
+                break;
+        }
+    } else if ((pf_flags & DDPF_RGB) && bit_count == 32) {
+        // X8R8G8B8's fourth byte is padding, sampling it as alpha would show garbage
+        internal_format = (pf_flags & DDPF_ALPHAPIXELS) && a_mask ? GL_RGBA8 : GL_RGB8;
+    }
+
+    if (!internal_format) {
+        CONTAINER_LOG(GLT_LOG_ERROR, "unsupported DDS pixel format");
+        return false;
+    }
+
+    if (!set_uncompressed(out, internal_format)) {
+        out->compressed = true;
+        out->internal_format = internal_format;
+    } else if (!(pf_flags & DDPF_FOURCC) && r_mask == 0x00ff0000u) {
+        out->format = GL_BGRA;
+    }
+
+    if (!check_dimensions(width, height, internal_format, size - offset, "DDS")) {
+        return false;
+    }
+
+    const uint32_t count = clamp_levels(mips ? mips : 1, width, height, "DDS");
+    if (count > GLT_CONTAINER_MAX_LEVELS) {
+        CONTAINER_LOG(GLT_LOG_ERROR, "bad DDS level count %u", count);
+        return false;
+    }
+
+    out->width = (GLsizei) width;
+    out->height = (GLsizei) height;
+    out->levels = (GLint) count;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const GLsizei w = width >> i ? (GLsizei) (width >> i) : 1;
+        const GLsizei h = height >> i ? (GLsizei) (height >> i) : 1;
+        const size_t level_size = glt_container_level_size(internal_format, w, h);
+        if (offset > size || level_size > size - offset) {
+            CONTAINER_LOG(GLT_LOG_ERROR, "DDS level %u is out of bounds", i);
+            return false;
+        }
+        out->level[i].data = data + offset;
+        out->level[i].size = level_size;
+        out->level[i].width = w;
+        out->level[i].height = h;
+        offset += level_size;
+    }
+
+    return true;
+}
+
+static GLenum map_format(const format_map_t *map, size_t count, uint32_t code) {
+    for (size_t i = 0; i < count; ++i) {
+        if (map[i].code == code) {
+            return map[i].internal_format;
+        }
+    }
+    return 0;
+}
+
+static bool set_uncompressed(glt_container_t *out, GLenum internal_format) {
+    out->compressed = false;
+    out->internal_format = internal_format;
+    out->type = GL_UNSIGNED_BYTE;
+    switch (internal_format) {
+        case GL_R8: out->format = GL_RED;
+            return true;
+        case GL_RG8: out->format = GL_RG;
+            return true;
+        // the padding byte is uploaded and dropped by the RGB8 internal format
+        case GL_RGB8:
+        case GL_RGBA8:
+        case GL_SRGB8_ALPHA8: out->format = GL_RGBA;
+            return true;
+        default:
+            out->format = 0;
+            out->type = 0;
+            return false;
+    }
+}
+
+static uint32_t clamp_levels(uint32_t levels, uint32_t width, uint32_t height, const char *kind) {
+    // glTexStorage2D rejects more than floor(log2(max(w, h))) + 1 levels
+    uint32_t chain = 1;
+    for (uint32_t size = width > height ? width : height; size > 1; size >>= 1) {
+        ++chain;
+    }
+    if (levels > chain) {
+        CONTAINER_LOG(GLT_LOG_WARNING, "%s declares %u levels for %ux%u, using %u", kind, levels, width, height, chain);
+        return chain;
+    }
+    return levels;
+}
+
+static bool check_dimensions(uint32_t width, uint32_t height, GLenum internal_format, size_t available, const char *kind) {
+    if (width == 0 || height == 0 || width > INT_MAX || height > INT_MAX) {
+        CONTAINER_LOG(GLT_LOG_ERROR, "bad %s dimensions %ux%u", kind, width, height);
+        return false;
+    }
+
+    // level 0 has to fit in the data; compared by division so huge headers can't wrap the product
+    const size_t block = glt_container_block_bytes(internal_format);
+    const uint64_t row = block
+                             ? ((uint64_t) width + 3) / 4 * block
+                             : (uint64_t) width * glt_container_level_size(internal_format, 1, 1);
+    const uint64_t rows = block ? ((uint64_t) height + 3) / 4 : height;
+    if (row == 0 || rows > (uint64_t) available / row) {
+        CONTAINER_LOG(GLT_LOG_ERROR, "%s level 0 (%ux%u) is larger than the file", kind, width, height);
+        return false;
+    }
+    return true;
+}
+
+static uint32_t read_u32(const unsigned char *p) {
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint64_t read_u64(const unsigned char *p) {
+    return (uint64_t) read_u32(p) | ((uint64_t) read_u32(p + 4) << 32);
+}
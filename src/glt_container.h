@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "glad/glad.h"
+#include "glt_bc.h"
+
+// KTX2 / DDS parsing, levels point into the caller's buffer
+
+#define GLT_CONTAINER_MAX_LEVELS 16
+
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    GLsizei width;
+    GLsizei height;
+} glt_container_level_t;
+
+typedef struct {
+    // compressed: internal_format is the GL compressed format and format/type are 0
+    bool compressed;
+    GLenum internal_format;
+    GLenum format;
+    GLenum type;
+    GLsizei width;
+    GLsizei height;
+    GLint levels;
+    glt_container_level_t level[GLT_CONTAINER_MAX_LEVELS];
+} glt_container_t;
+
+bool glt_container_is_known(const unsigned char *data, size_t size);
+
+bool glt_container_parse(const unsigned char *data, size_t size, glt_container_t *out);
+
+// 0 for formats that aren't block compressed
+size_t glt_container_block_bytes(GLenum internal_format);
+
+size_t glt_container_level_size(GLenum internal_format, GLsizei width, GLsizei height);
@@ -0,0 +1,273 @@
+#include "glt_debug.h"
+#include "glt_log.h"
+#include "glt_time.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+#define DEBUG_LOG(level, msg, ...)    glt_log(level, "[GL DEBUG]: " msg, ##__VA_ARGS__)
+
+// distinct (source, type, id) triples tracked for de-duplication, later ones are only rate limited
+#define DEBUG_ID_CAPACITY 512
+// GL_MAX_LABEL_LENGTH is at least 256
+#define DEBUG_MAX_LABEL 255
+
+typedef struct {
+    // packed (source, type, id) + 1, 0 while the slot is free
+    atomic_uint_fast64_t key;
+    atomic_int count;
+    // reached max_repeats, glt_debug_end_frame still has to mute it
+    atomic_bool mute_pending;
+} debug_id_t;
+
+// written by glt_debug_enable only, read by the callback which may run on a driver thread
+static glt_debug_options_t options;
+static debug_id_t ids[DEBUG_ID_CAPACITY];
+static atomic_int pending_mutes;
+static atomic_uint_fast64_t suppressed;
+static atomic_uint_fast64_t window_start_ms;
+static atomic_int window_count;
+
+// helper funcs
+
+static void APIENTRY debug_callback(
+    GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *message, const void *user
+);
+
+static debug_id_t *find_id(uint64_t key);
+
+static void reset_ids(void);
+
+static bool within_rate(void);
+
+static int severity_rank(GLenum severity);
+
+static const char *source_name(GLenum source);
+
+static const char *type_name(GLenum type);
+
+static GLsizei label_length(const char *label);
+
+// public funcs
+
+bool glt_debug_enable(const glt_debug_options_t *opts) {
+    if (!glDebugMessageCallback || !glDebugMessageControl) {
+        DEBUG_LOG(GLT_LOG_WARNING, "debug output needs OpenGL 4.3");
+        return false;
+    }
+
+    GLint flags = 0;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+    if (!(flags & GL_CONTEXT_FLAG_DEBUG_BIT)) {
+        DEBUG_LOG(GLT_LOG_WARNING, "not a debug context, drivers may report little or nothing");
+    }
+
+    options = opts ? *opts : (glt_debug_options_t) {0};
+    if (!options.min_severity) {
+        options.min_severity = GL_DEBUG_SEVERITY_LOW;
+    }
+    if (options.max_repeats <= 0) {
+        options.max_repeats = 3;
+    }
+    if (options.max_per_second <= 0) {
+        options.max_per_second = 50;
+    }
+
+    // filtered in the driver, so messages below min_severity never reach the callback
+    static const GLenum severities[] = {
+        GL_DEBUG_SEVERITY_NOTIFICATION, GL_DEBUG_SEVERITY_LOW, GL_DEBUG_SEVERITY_MEDIUM, GL_DEBUG_SEVERITY_HIGH
+    };
+    for (size_t i = 0; i < sizeof(severities) / sizeof(severities[0]); ++i) {
+        const GLboolean enabled = severity_rank(severities[i]) >= severity_rank(options.min_severity);
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, severities[i], 0, NULL, enabled);
+    }
+    // our own group markers
+    glDebugMessageControl(GL_DEBUG_SOURCE_APPLICATION, GL_DEBUG_TYPE_PUSH_GROUP, GL_DONT_CARE, 0, NULL, GL_FALSE);
+    glDebugMessageControl(GL_DEBUG_SOURCE_APPLICATION, GL_DEBUG_TYPE_POP_GROUP, GL_DONT_CARE, 0, NULL, GL_FALSE);
+
+    // driver mutes are per context, this one starts with none, so every id gets its repeats again
+    reset_ids();
+
+    glDebugMessageCallback(debug_callback, NULL);
+    glEnable(GL_DEBUG_OUTPUT);
+    if (options.synchronous) {
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    } else {
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    }
+
+    return true;
+}
+
+void glt_debug_disable(void) {
+    if (!glDebugMessageCallback) {
+        return;
+    }
+    glDisable(GL_DEBUG_OUTPUT);
+    glDebugMessageCallback(NULL, NULL);
+}
+
+void glt_debug_end_frame(void) {
+    if (atomic_load_explicit(&pending_mutes, memory_order_relaxed) == 0 || !glDebugMessageControl) {
+        return;
+    }
+
+    for (int i = 0; i < DEBUG_ID_CAPACITY; ++i) {
+        debug_id_t *entry = &ids[i];
+        if (!atomic_exchange(&entry->mute_pending, false)) {
+            continue;
+        }
+        atomic_fetch_sub(&pending_mutes, 1);
+
+        const uint64_t key = atomic_load(&entry->key) - 1;
+        const GLenum source = (GLenum) (key >> 48) + GL_DEBUG_SOURCE_API;
+        const GLenum type = (GLenum) ((key >> 32) & 0xFFFF);
+        const GLuint id = (GLuint) key;
+        glDebugMessageControl(source, type, GL_DONT_CARE, 1, &id, GL_FALSE);
+    }
+}
+
+uint64_t glt_debug_get_suppressed(void) {
+    return atomic_load(&suppressed);
+}
+
+void glt_debug_push_group(const char *name) {
+    if (!glPushDebugGroup || !name) {
+        return;
+    }
+    glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, label_length(name), name);
+}
+
+void glt_debug_pop_group(void) {
+    if (!glPopDebugGroup) {
+        return;
+    }
+    glPopDebugGroup();
+}
+
+void glt_debug_label(GLenum identifier, GLuint name, const char *label) {
+    if (!glObjectLabel || !name || !label) {
+        return;
+    }
+    glObjectLabel(identifier, name, label_length(label), label);
+}
+
+// helper funcs
+
+static void APIENTRY debug_callback(
+    GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *message, const void *user
+) {
+    (void) length;
+    (void) user;
+
+    // sources are consecutive enums, types fit in 16 bits
+    const uint64_t key = ((uint64_t) (source - GL_DEBUG_SOURCE_API) << 48) | ((uint64_t) (type & 0xFFFF) << 32) | id;
+
+    bool last = false;
+    debug_id_t *entry = find_id(key);
+    if (entry) {
+        const int count = atomic_fetch_add(&entry->count, 1) + 1;
+        if (count > options.max_repeats) {
+            // the driver is still catching up with the mute
+            atomic_fetch_add(&suppressed, 1);
+            return;
+        }
+        if (count == options.max_repeats) {
+            last = true;
+            atomic_store(&entry->mute_pending, true);
+            atomic_fetch_add(&pending_mutes, 1);
+        }
+    }
+
+    if (!within_rate()) {
+        atomic_fetch_add(&suppressed, 1);
+        return;
+    }
+
+    glt_log_level_e level = GLT_LOG_INFO;
+    if (type == GL_DEBUG_TYPE_ERROR || severity == GL_DEBUG_SEVERITY_HIGH) {
+        level = GLT_LOG_ERROR;
+    } else if (severity == GL_DEBUG_SEVERITY_MEDIUM || type == GL_DEBUG_TYPE_PERFORMANCE) {
+        level = GLT_LOG_WARNING;
+    }
+
+    DEBUG_LOG(level, "%s %s 0x%X: %s%s", source_name(source), type_name(type), id, message,
+              last ? " (further repeats muted)" : "");
+}
+
+static debug_id_t *find_id(uint64_t key) {
+    // +1 keeps 0 free as the empty marker
+    const uint64_t stored = key + 1;
+    size_t slot = (size_t) ((stored * 0x9E3779B97F4A7C15ull) >> 55) & (DEBUG_ID_CAPACITY - 1);
+
+    for (int probe = 0; probe < DEBUG_ID_CAPACITY; ++probe) {
+        debug_id_t *entry = &ids[slot];
+        uint_fast64_t current = atomic_load(&entry->key);
+        if (current == stored) {
+            return entry;
+        }
+        if (current == 0) {
+            if (atomic_compare_exchange_strong(&entry->key, &current, stored) || current == stored) {
+                return entry;
+            }
+        }
+        slot = (slot + 1) & (DEBUG_ID_CAPACITY - 1);
+    }
+    return NULL;
+}
+
+static void reset_ids(void) {
+    for (int i = 0; i < DEBUG_ID_CAPACITY; ++i) {
+        atomic_store(&ids[i].mute_pending, false);
+        atomic_store(&ids[i].count, 0);
+        atomic_store(&ids[i].key, 0);
+    }
+    atomic_store(&pending_mutes, 0);
+}
+
+static bool within_rate(void) {
+    const uint64_t now_ms = glt_time_now_ns() / 1000000;
+    uint_fast64_t start = atomic_load(&window_start_ms);
+    if (now_ms - start >= 1000 && atomic_compare_exchange_strong(&window_start_ms, &start, now_ms)) {
+        atomic_store(&window_count, 0);
+    }
+    return atomic_fetch_add(&window_count, 1) < options.max_per_second;
+}
+
+static int severity_rank(GLenum severity) {
+    switch (severity) {
+        case GL_DEBUG_SEVERITY_NOTIFICATION: return 0;
+        case GL_DEBUG_SEVERITY_LOW: return 1;
+        case GL_DEBUG_SEVERITY_MEDIUM: return 2;
+        case GL_DEBUG_SEVERITY_HIGH: return 3;
+        default: return 1;
+    }
+}
+
+static const char *source_name(GLenum source) {
+    switch (source) {
+        case GL_DEBUG_SOURCE_API: return "api";
+        case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "window system";
+        case GL_DEBUG_SOURCE_SHADER_COMPILER: return "shader compiler";
+        case GL_DEBUG_SOURCE_THIRD_PARTY: return "third party";
+        case GL_DEBUG_SOURCE_APPLICATION: return "application";
+        default: return "other";
+    }
+}
+
+static const char *type_name(GLenum type) {
+    switch (type) {
+        case GL_DEBUG_TYPE_ERROR: return "error";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "undefined behavior";
+        case GL_DEBUG_TYPE_PORTABILITY: return "portability";
+        case GL_DEBUG_TYPE_PERFORMANCE: return "performance";
+        case GL_DEBUG_TYPE_MARKER: return "marker";
+        default: return "other";
+    }
+}
+
+static GLsizei label_length(const char *label) {
+    const size_t length = strlen(label);
+    return (GLsizei) (length < DEBUG_MAX_LABEL ? length : DEBUG_MAX_LABEL);
+}
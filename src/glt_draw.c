@@ -0,0 +1,41 @@
+#include "glt_draw.h"
+#include "glt_stats.h"
+
+#include <stdint.h>
+
+// helper funcs
+
+static void count_draw(GLsizei count, GLsizei instances);
+
+// public funcs
+
+void glt_draw_arrays(GLenum mode, GLint first, GLsizei count) {
+    glDrawArrays(mode, first, count);
+    count_draw(count, 1);
+}
+
+void glt_draw_arrays_instanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) {
+    glDrawArraysInstanced(mode, first, count, instances);
+    count_draw(count, instances);
+}
+
+void glt_draw_elements(GLenum mode, GLsizei count, GLenum type, size_t offset) {
+    glDrawElements(mode, count, type, (const void *) (uintptr_t) offset);
+    count_draw(count, 1);
+}
+
+void glt_draw_elements_instanced(GLenum mode, GLsizei count, GLenum type, size_t offset, GLsizei instances) {
+    glDrawElementsInstanced(mode, count, type, (const void *) (uintptr_t) offset, instances);
+    count_draw(count, instances);
+}
+
+// helper funcs
+
+static void count_draw(GLsizei count, GLsizei instances) {
+    if (count <= 0 || instances <= 0) {
+        return;
+    }
+    glt_stats_add(GLT_STAT_DRAW_CALLS, 1);
+    glt_stats_add(GLT_STAT_INSTANCES, (uint64_t) instances);
+    glt_stats_add(GLT_STAT_VERTICES, (uint64_t) count * (uint64_t) instances);
+}
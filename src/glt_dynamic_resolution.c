@@ -0,0 +1,414 @@
+#include "glt_dynamic_resolution.h"
+#include "glt_gpu_profiler.h"
+#include "glt_vertex_array.h"
+#include "glt_shader.h"
+#include "glt_draw.h"
+#include "glt_debug.h"
+#include "glt_log.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define DYNRES_LOG(level, msg, ...)    glt_log(level, "[DYNRES]: " msg, ##__VA_ARGS__)
+
+#define DEFAULT_TARGET_MS (1000.0 / 60.0)
+#define DEFAULT_MIN_SCALE 0.5f
+#define DEFAULT_MAX_SCALE 1.0f
+#define DEFAULT_HEADROOM 0.15f
+#define DEFAULT_COOLDOWN_FRAMES 8
+#define DEFAULT_SHARPNESS 0.5f
+
+// weight of the newest GPU time in the moving average
+#define GPU_MS_SMOOTHING 0.25
+// largest step up per change, going down jumps straight to the estimate
+#define MAX_SCALE_UP 0.05f
+// relative changes below this aren't worth the resample
+#define MIN_SCALE_CHANGE 0.02f
+
+struct glt_dynamic_resolution_t {
+    glt_window_t *window;
+    glt_dynamic_resolution_options_t options;
+    glt_framebuffer_t *framebuffer;
+    glt_gpu_profiler_t *profiler;
+
+    // fullscreen upscale pass, both filters go through it so taps stay inside the rendered region
+    glt_shader_t *shader;
+    glt_vertex_array_t *empty_vao;
+    GLint loc_uv_scale;
+    GLint loc_uv_max;
+    GLint loc_texel;
+    GLint loc_sharpness;
+
+    bool adaptive;
+    float scale;
+    int cooldown;
+    double gpu_ms;
+    uint64_t timed_frame;
+
+    int output_width;
+    int output_height;
+    int render_width;
+    int render_height;
+};
+
+static const char *upscale_vs =
+    "#version 330 core\n"
+    "out vec2 v_uv;\n"
+    "void main() {\n"
+    "    // one triangle covering the screen\n"
+    "    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+    "    v_uv = pos;\n"
+    "    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);\n"
+    "}\n";
+
+static const char *upscale_fs =
+    "#version 330 core\n"
+    "uniform sampler2D u_scene;\n"
+    "uniform vec2 u_uv_scale;\n"
+    "uniform vec2 u_uv_max;\n"
+    "uniform vec2 u_texel;\n"
+    "uniform float u_sharpness;\n"
+    "in vec2 v_uv;\n"
+    "out vec4 frag_color;\n"
+    "vec4 fetch(vec2 uv) {\n"
+    "    return texture(u_scene, min(uv, u_uv_max));\n"
+    "}\n"
+    "void main() {\n"
+    "    vec2 uv = v_uv * u_uv_scale;\n"
+    "    vec4 c = fetch(uv);\n"
+    "    if (u_sharpness == 0.0) {\n"
+    "        frag_color = c;\n"
+    "        return;\n"
+    "    }\n"
+    "    vec3 n = fetch(uv + vec2(0.0, u_texel.y)).rgb;\n"
+    "    vec3 s = fetch(uv - vec2(0.0, u_texel.y)).rgb;\n"
+    "    vec3 e = fetch(uv + vec2(u_texel.x, 0.0)).rgb;\n"
+    "    vec3 w = fetch(uv - vec2(u_texel.x, 0.0)).rgb;\n"
+    "    vec3 sharp = c.rgb + (4.0 * c.rgb - n - s - e - w) * u_sharpness;\n"
+    "    // clamped to the neighbourhood so edges don't ring\n"
+    "    vec3 lo = min(c.rgb, min(min(n, s), min(e, w)));\n"
+    "    vec3 hi = max(c.rgb, max(max(n, s), max(e, w)));\n"
+    "    frag_color = vec4(clamp(sharp, lo, hi), c.a);\n"
+    "}\n";
+
+// helper funcs
+
+static void apply_defaults(glt_dynamic_resolution_options_t *options);
+
+static bool update_output_size(glt_dynamic_resolution_t *dynres);
+
+static void adapt(glt_dynamic_resolution_t *dynres);
+
+static void update_render_size(glt_dynamic_resolution_t *dynres);
+
+static bool create_upscale_pass(glt_dynamic_resolution_t *dynres);
+
+static void draw_upscale_pass(const glt_dynamic_resolution_t *dynres);
+
+// public funcs
+
+glt_dynamic_resolution_t *glt_dynamic_resolution_create(glt_window_t *window, const glt_dynamic_resolution_options_t *options) {
+    if (!window) {
+        return NULL;
+    }
+
+    glt_dynamic_resolution_t *dynres = calloc(1, sizeof(glt_dynamic_resolution_t));
+    if (!dynres) {
+        DYNRES_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+    dynres->window = window;
+    if (options) {
+        dynres->options = *options;
+    }
+    apply_defaults(&dynres->options);
+    dynres->adaptive = true;
+    dynres->scale = dynres->options.max_scale;
+    dynres->timed_frame = UINT64_MAX;
+
+    dynres->profiler = glt_gpu_profiler_create(0, 1);
+    if (!dynres->profiler) {
+        glt_dynamic_resolution_destroy(dynres);
+        return NULL;
+    }
+    if (!create_upscale_pass(dynres)) {
+        glt_dynamic_resolution_destroy(dynres);
+        return NULL;
+    }
+    if (!update_output_size(dynres)) {
+        glt_dynamic_resolution_destroy(dynres);
+        return NULL;
+    }
+    return dynres;
+}
+
+void glt_dynamic_resolution_destroy(glt_dynamic_resolution_t *dynres) {
+    if (!dynres) {
+        return;
+    }
+    glt_framebuffer_destroy(dynres->framebuffer);
+    glt_gpu_profiler_destroy(dynres->profiler);
+    glt_shader_destroy(dynres->shader);
+    glt_vertex_array_destroy(dynres->empty_vao);
+    free(dynres);
+}
+
+void glt_dynamic_resolution_begin(glt_dynamic_resolution_t *dynres) {
+    if (!dynres) {
+        return;
+    }
+    glt_gpu_profiler_begin_frame(dynres->profiler);
+    update_output_size(dynres);
+    adapt(dynres);
+
+    glt_framebuffer_bind(dynres->framebuffer);
+    glViewport(0, 0, dynres->render_width, dynres->render_height);
+}
+
+void glt_dynamic_resolution_clear(const glt_dynamic_resolution_t *dynres, float r, float g, float b, float a) {
+    if (!dynres) {
+        return;
+    }
+    const GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+    GLint prev_box[4];
+    glGetIntegerv(GL_SCISSOR_BOX, prev_box);
+
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(0, 0, dynres->render_width, dynres->render_height);
+    glt_framebuffer_clear(dynres->framebuffer, r, g, b, a);
+
+    glScissor(prev_box[0], prev_box[1], prev_box[2], prev_box[3]);
+    if (!scissor) {
+        glDisable(GL_SCISSOR_TEST);
+    }
+}
+
+void glt_dynamic_resolution_end(glt_dynamic_resolution_t *dynres) {
+    if (!dynres) {
+        return;
+    }
+    glt_gpu_profiler_end_frame(dynres->profiler);
+    glt_debug_push_group("dynamic resolution upscale");
+
+    // a linear blit of the region would filter in texels past its right and top edges
+    glBindFramebuffer(GL_FRAMEBUFFER, glt_window_get_framebuffer(dynres->window));
+    glViewport(0, 0, dynres->output_width, dynres->output_height);
+    draw_upscale_pass(dynres);
+    glt_debug_pop_group();
+}
+
+void glt_dynamic_resolution_set_adaptive(glt_dynamic_resolution_t *dynres, bool adaptive) {
+    if (dynres) {
+        dynres->adaptive = adaptive;
+    }
+}
+
+void glt_dynamic_resolution_set_scale(glt_dynamic_resolution_t *dynres, float scale) {
+    if (!dynres) {
+        return;
+    }
+    const glt_dynamic_resolution_options_t *options = &dynres->options;
+    dynres->scale = scale < options->min_scale ? options->min_scale : scale > options->max_scale ? options->max_scale : scale;
+    dynres->cooldown = options->cooldown_frames;
+    update_render_size(dynres);
+}
+
+float glt_dynamic_resolution_get_scale(const glt_dynamic_resolution_t *dynres) {
+    return dynres ? dynres->scale : 0.0f;
+}
+
+void glt_dynamic_resolution_get_render_size(const glt_dynamic_resolution_t *dynres, int *width, int *height) {
+    if (width) {
+        *width = dynres ? dynres->render_width : 0;
+    }
+    if (height) {
+        *height = dynres ? dynres->render_height : 0;
+    }
+}
+
+double glt_dynamic_resolution_get_gpu_ms(const glt_dynamic_resolution_t *dynres) {
+    return dynres ? dynres->gpu_ms : 0.0;
+}
+
+const glt_framebuffer_t *glt_dynamic_resolution_get_framebuffer(const glt_dynamic_resolution_t *dynres) {
+    return dynres ? dynres->framebuffer : NULL;
+}
+
+// helper funcs
+
+static void apply_defaults(glt_dynamic_resolution_options_t *options) {
+    if (options->target_ms <= 0.0) {
+        options->target_ms = DEFAULT_TARGET_MS;
+    }
+    if (options->max_scale <= 0.0f) {
+        options->max_scale = DEFAULT_MAX_SCALE;
+    }
+    if (options->min_scale <= 0.0f) {
+        options->min_scale = DEFAULT_MIN_SCALE;
+    }
+    if (options->min_scale > options->max_scale) {
+        options->min_scale = options->max_scale;
+    }
+    if (options->headroom <= 0.0f || options->headroom >= 1.0f) {
+        options->headroom = DEFAULT_HEADROOM;
+    }
+    if (options->cooldown_frames <= 0) {
+        options->cooldown_frames = DEFAULT_COOLDOWN_FRAMES;
+    }
+    if (options->filter >= GLT_UPSCALE__COUNT) {
+        options->filter = GLT_UPSCALE_BILINEAR;
+    }
+    if (options->sharpness <= 0.0f || options->sharpness > 1.0f) {
+        options->sharpness = DEFAULT_SHARPNESS;
+    }
+    if (!options->color_format) {
+        options->color_format = GL_RGBA8;
+    }
+    if (!options->depth_format) {
+        options->depth_format = GL_DEPTH24_STENCIL8;
+    }
+}
+
+// the target is sized for max_scale once per output size, scale changes only move the viewport
+static bool update_output_size(glt_dynamic_resolution_t *dynres) {
+    int width = 0, height = 0;
+    glt_window_get_framebuffer_size(dynres->window, &width, &height);
+    if (width <= 0 || height <= 0) {
+        // minimized, keep the last size
+        return dynres->framebuffer != NULL;
+    }
+    if (dynres->framebuffer && width == dynres->output_width && height == dynres->output_height) {
+        return true;
+    }
+
+    const GLsizei target_width = (GLsizei) ceilf((float) width * dynres->options.max_scale);
+    const GLsizei target_height = (GLsizei) ceilf((float) height * dynres->options.max_scale);
+    if (dynres->framebuffer) {
+        if (!glt_framebuffer_resize(dynres->framebuffer, target_width, target_height)) {
+            return false;
+        }
+    } else {
+        glt_framebuffer_desc_t desc = {0};
+        desc.width = target_width;
+        desc.height = target_height;
+        desc.color[0].format = dynres->options.color_format;
+        desc.depth.format = dynres->options.depth_format;
+        desc.depth.renderbuffer = true;
+        desc.sampler.filter = GLT_SAMPLER_FILTER_BILINEAR;
+        desc.sampler.wrap = GLT_SAMPLER_WRAP_CLAMP_TO_EDGE;
+        dynres->framebuffer = glt_framebuffer_create(&desc, NULL);
+        if (!dynres->framebuffer) {
+            DYNRES_LOG(GLT_LOG_ERROR, "failed to create the scene target");
+            return false;
+        }
+    }
+
+    dynres->output_width = width;
+    dynres->output_height = height;
+    update_render_size(dynres);
+    return true;
+}
+
+static void adapt(glt_dynamic_resolution_t *dynres) {
+    if (dynres->cooldown > 0) {
+        dynres->cooldown--;
+    }
+
+    // timings come back a few frames late, only new ones count
+    const uint64_t frame = glt_gpu_profiler_get_timeline_frame(dynres->profiler);
+    if (frame == UINT64_MAX || frame == dynres->timed_frame) {
+        return;
+    }
+    dynres->timed_frame = frame;
+    const double ms = glt_gpu_profiler_get_frame_ms(dynres->profiler);
+    dynres->gpu_ms = dynres->gpu_ms > 0.0 ? dynres->gpu_ms + (ms - dynres->gpu_ms) * GPU_MS_SMOOTHING : ms;
+
+    if (!dynres->adaptive || dynres->cooldown > 0 || dynres->gpu_ms <= 0.0) {
+        return;
+    }
+
+    // GPU time goes with the pixel count, so with the square of the scale; aim inside the headroom
+    const glt_dynamic_resolution_options_t *options = &dynres->options;
+    const double aim = options->target_ms * (1.0 - options->headroom * 0.5);
+    float scale = dynres->scale * (float) sqrt(aim / dynres->gpu_ms);
+
+    if (dynres->gpu_ms > options->target_ms) {
+        scale = scale < options->min_scale ? options->min_scale : scale;
+    } else if (dynres->gpu_ms < options->target_ms * (1.0 - options->headroom)) {
+        const float step = dynres->scale + MAX_SCALE_UP;
+        scale = scale > step ? step : scale;
+        scale = scale > options->max_scale ? options->max_scale : scale;
+    } else {
+        return;
+    }
+
+    if (fabsf(scale - dynres->scale) < dynres->scale * MIN_SCALE_CHANGE) {
+        return;
+    }
+    dynres->scale = scale;
+    dynres->cooldown = options->cooldown_frames;
+    // the average still holds times of the old size
+    dynres->gpu_ms = 0.0;
+    update_render_size(dynres);
+}
+
+static void update_render_size(glt_dynamic_resolution_t *dynres) {
+    const GLsizei max_width = glt_framebuffer_get_width(dynres->framebuffer);
+    const GLsizei max_height = glt_framebuffer_get_height(dynres->framebuffer);
+    int width = (int) lroundf((float) dynres->output_width * dynres->scale);
+    int height = (int) lroundf((float) dynres->output_height * dynres->scale);
+    dynres->render_width = width < 1 ? 1 : width > max_width ? max_width : width;
+    dynres->render_height = height < 1 ? 1 : height > max_height ? max_height : height;
+}
+
+static bool create_upscale_pass(glt_dynamic_resolution_t *dynres) {
+    dynres->shader = glt_shader_prog_create_src(upscale_vs, upscale_fs);
+    dynres->empty_vao = glt_vertex_array_create();
+    if (!dynres->shader || !dynres->empty_vao) {
+        DYNRES_LOG(GLT_LOG_ERROR, "failed to create the upscale pass");
+        return false;
+    }
+
+    glt_shader_use(dynres->shader);
+    glt_shader_set_int(dynres->shader, "u_scene", 0);
+    dynres->loc_uv_scale = glt_shader_get_uniform_loc(dynres->shader, "u_uv_scale");
+    dynres->loc_uv_max = glt_shader_get_uniform_loc(dynres->shader, "u_uv_max");
+    dynres->loc_texel = glt_shader_get_uniform_loc(dynres->shader, "u_texel");
+    dynres->loc_sharpness = glt_shader_get_uniform_loc(dynres->shader, "u_sharpness");
+    // 0 skips the sharpen taps, plain bilinear
+    const float sharpness = dynres->options.filter == GLT_UPSCALE_SHARPEN ? dynres->options.sharpness * 0.25f : 0.0f;
+    glt_shader_set_float_loc(dynres->shader, dynres->loc_sharpness, sharpness);
+    return true;
+}
+
+static void draw_upscale_pass(const glt_dynamic_resolution_t *dynres) {
+    const GLboolean depth_test = glIsEnabled(GL_DEPTH_TEST);
+    const GLboolean blend = glIsEnabled(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+
+    const float width = (float) glt_framebuffer_get_width(dynres->framebuffer);
+    const float height = (float) glt_framebuffer_get_height(dynres->framebuffer);
+    glt_shader_use(dynres->shader);
+    glt_shader_set_vec2_loc(
+        dynres->shader, dynres->loc_uv_scale, (float) dynres->render_width / width, (float) dynres->render_height / height
+    );
+    // half a texel in, so bilinear taps never reach past the rendered region
+    glt_shader_set_vec2_loc(
+        dynres->shader, dynres->loc_uv_max,
+        ((float) dynres->render_width - 0.5f) / width, ((float) dynres->render_height - 0.5f) / height
+    );
+    glt_shader_set_vec2_loc(dynres->shader, dynres->loc_texel, 1.0f / width, 1.0f / height);
+
+    glt_texture_bind(glt_framebuffer_get_texture(dynres->framebuffer, 0), 0);
+    glt_vertex_array_bind(dynres->empty_vao);
+    glt_draw_arrays(GL_TRIANGLES, 0, 3);
+
+    if (depth_test) {
+        glEnable(GL_DEPTH_TEST);
+    }
+    if (blend) {
+        glEnable(GL_BLEND);
+    }
+}
@@ -0,0 +1,604 @@
+#include "glt_framebuffer.h"
+#include "glt_texture_internal.h"
+#include "glt_stats.h"
+#include "glt_log.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define FRAMEBUFFER_LOG(level, msg, ...)    glt_log(level, "[FRAMEBUFFER]: " msg, ##__VA_ARGS__)
+
+#define DEFAULT_MAX_IDLE_FRAMES 2
+
+typedef struct attachment_t attachment_t;
+
+struct attachment_t {
+    GLenum format;
+    GLsizei width;
+    GLsizei height;
+    GLsizei samples;
+    bool renderbuffer;
+
+    GLuint id;
+    // texture attachments, wraps id
+    glt_texture_t *texture;
+    size_t bytes;
+
+    // pool frame the attachment went idle in, next idle attachment
+    uint64_t idle_since;
+    attachment_t *next;
+};
+
+struct glt_framebuffer_t {
+    glt_framebuffer_desc_t desc;
+    glt_framebuffer_pool_t *pool;
+
+    GLuint fbo;
+    // single-sampled copy of the non-transient attachments, MSAA only
+    GLuint resolve_fbo;
+
+    attachment_t *color[GLT_FRAMEBUFFER_MAX_COLOR];
+    attachment_t *depth;
+    attachment_t *resolve_color[GLT_FRAMEBUFFER_MAX_COLOR];
+    attachment_t *resolve_depth;
+};
+
+struct glt_framebuffer_pool_t {
+    attachment_t *idle;
+    size_t count;
+    size_t bytes;
+    uint64_t frame;
+    unsigned max_idle_frames;
+};
+
+// helper funcs
+
+static bool acquire_attachments(glt_framebuffer_t *framebuffer);
+
+static void release_attachments(glt_framebuffer_t *framebuffer);
+
+static bool attach(GLuint fbo, attachment_t *const *color, const attachment_t *depth);
+
+static attachment_t *acquire_attachment(
+    glt_framebuffer_pool_t *pool, GLenum format, GLsizei width, GLsizei height, GLsizei samples, bool renderbuffer
+);
+
+static void release_attachment(glt_framebuffer_pool_t *pool, attachment_t *attachment);
+
+static attachment_t *create_attachment(GLenum format, GLsizei width, GLsizei height, GLsizei samples, bool renderbuffer);
+
+static void destroy_attachment(attachment_t *attachment);
+
+static void attach_one(GLenum point, const attachment_t *attachment);
+
+static void set_draw_buffers(attachment_t *const *color, int only);
+
+static GLbitfield depth_blit_mask(GLenum format);
+
+// public funcs
+
+glt_framebuffer_t *glt_framebuffer_create(const glt_framebuffer_desc_t *desc, glt_framebuffer_pool_t *pool) {
+    if (!desc || desc->width <= 0 || desc->height <= 0) {
+        FRAMEBUFFER_LOG(GLT_LOG_ERROR, "invalid framebuffer size");
+        return NULL;
+    }
+
+    glt_framebuffer_t *framebuffer = calloc(1, sizeof(glt_framebuffer_t));
+    if (!framebuffer) {
+        FRAMEBUFFER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+    framebuffer->desc = *desc;
+    framebuffer->pool = pool;
+
+    GLint max_samples = 1;
+    glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
+    GLsizei samples = desc->samples > 1 ? desc->samples : 1;
+    if (samples > max_samples) {
+        FRAMEBUFFER_LOG(GLT_LOG_WARNING, "%d samples requested, clamped to %d", samples, max_samples);
+        samples = max_samples;
+    }
+    framebuffer->desc.samples = samples;
+
+    glGenFramebuffers(1, &framebuffer->fbo);
+    glt_stats_track_resource(GLT_RESOURCE_FRAMEBUFFER, 1, 0);
+    if (samples > 1) {
+        glGenFramebuffers(1, &framebuffer->resolve_fbo);
+        glt_stats_track_resource(GLT_RESOURCE_FRAMEBUFFER, 1, 0);
+    }
+
+    if (!acquire_attachments(framebuffer)) {
+        glt_framebuffer_destroy(framebuffer);
+        return NULL;
+    }
+    return framebuffer;
+}
+
+void glt_framebuffer_destroy(glt_framebuffer_t *framebuffer) {
+    if (!framebuffer) {
+        return;
+    }
+    release_attachments(framebuffer);
+    if (framebuffer->fbo) {
+        glDeleteFramebuffers(1, &framebuffer->fbo);
+        glt_stats_track_resource(GLT_RESOURCE_FRAMEBUFFER, -1, 0);
+    }
+    if (framebuffer->resolve_fbo) {
+        glDeleteFramebuffers(1, &framebuffer->resolve_fbo);
+        glt_stats_track_resource(GLT_RESOURCE_FRAMEBUFFER, -1, 0);
+    }
+    free(framebuffer);
+}
+
+bool glt_framebuffer_resize(glt_framebuffer_t *framebuffer, GLsizei width, GLsizei height) {
+    if (!framebuffer || width <= 0 || height <= 0) {
+        return false;
+    }
+    if (width == framebuffer->desc.width && height == framebuffer->desc.height) {
+        return true;
+    }
+
+    // released first, so a pool can hand back what an earlier resize to this size left behind
+    release_attachments(framebuffer);
+    framebuffer->desc.width = width;
+    framebuffer->desc.height = height;
+    return acquire_attachments(framebuffer);
+}
+
+void glt_framebuffer_bind(const glt_framebuffer_t *framebuffer) {
+    if (!framebuffer) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->fbo);
+    glViewport(0, 0, framebuffer->desc.width, framebuffer->desc.height);
+}
+
+void glt_framebuffer_clear(const glt_framebuffer_t *framebuffer, float r, float g, float b, float a) {
+    if (!framebuffer) {
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->fbo);
+
+    const GLfloat color[4] = {r, g, b, a};
+    for (int i = 0; i < GLT_FRAMEBUFFER_MAX_COLOR; ++i) {
+        if (framebuffer->color[i]) {
+            glClearBufferfv(GL_COLOR, i, color);
+        }
+    }
+
+    if (framebuffer->depth) {
+        const GLbitfield mask = depth_blit_mask(framebuffer->depth->format);
+        const GLfloat depth = 1.0f;
+        const GLint stencil = 0;
+        if (mask == (GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT)) {
+            glClearBufferfi(GL_DEPTH_STENCIL, 0, depth, stencil);
+        } else if (mask == GL_STENCIL_BUFFER_BIT) {
+            glClearBufferiv(GL_STENCIL, 0, &stencil);
+        } else {
+            glClearBufferfv(GL_DEPTH, 0, &depth);
+        }
+    }
+}
+
+void glt_framebuffer_resolve(glt_framebuffer_t *framebuffer) {
+    if (!framebuffer || !framebuffer->resolve_fbo) {
+        return;
+    }
+    const GLsizei w = framebuffer->desc.width;
+    const GLsizei h = framebuffer->desc.height;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer->fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer->resolve_fbo);
+
+    // a blit writes its read buffer to every draw buffer, so attachments go one at a time
+    bool resolved_color = false;
+    for (int i = 0; i < GLT_FRAMEBUFFER_MAX_COLOR; ++i) {
+        if (!framebuffer->resolve_color[i]) {
+            continue;
+        }
+        resolved_color = true;
+        glReadBuffer(GL_COLOR_ATTACHMENT0 + i);
+        set_draw_buffers(framebuffer->resolve_color, i);
+        glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+    if (resolved_color) {
+        set_draw_buffers(framebuffer->resolve_color, -1);
+    }
+    if (framebuffer->resolve_depth) {
+        glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, depth_blit_mask(framebuffer->resolve_depth->format), GL_NEAREST);
+    }
+
+    // everything worth keeping is in the resolve targets now
+    if (glInvalidateFramebuffer) {
+        GLenum points[GLT_FRAMEBUFFER_MAX_COLOR + 1];
+        GLsizei count = 0;
+        for (int i = 0; i < GLT_FRAMEBUFFER_MAX_COLOR; ++i) {
+            if (framebuffer->color[i]) {
+                points[count++] = GL_COLOR_ATTACHMENT0 + i;
+            }
+        }
+        if (framebuffer->depth) {
+            points[count++] = glt_texture_depth_attachment_point(framebuffer->depth->format);
+        }
+        glInvalidateFramebuffer(GL_READ_FRAMEBUFFER, count, points);
+    }
+
+    // back to the read buffer attach set up
+    for (int i = 0; i < GLT_FRAMEBUFFER_MAX_COLOR; ++i) {
+        if (framebuffer->color[i]) {
+            glReadBuffer(GL_COLOR_ATTACHMENT0 + i);
+            break;
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->fbo);
+}
+
+void glt_framebuffer_discard(const glt_framebuffer_t *framebuffer) {
+    if (!framebuffer || !glInvalidateFramebuffer) {
+        return;
+    }
+
+    GLenum points[GLT_FRAMEBUFFER_MAX_COLOR + 1];
+    GLsizei count = 0;
+    for (int i = 0; i < GLT_FRAMEBUFFER_MAX_COLOR; ++i) {
+        if (framebuffer->color[i] && framebuffer->desc.color[i].transient) {
+            points[count++] = GL_COLOR_ATTACHMENT0 + i;
+        }
+    }
+    if (framebuffer->depth && framebuffer->desc.depth.transient) {
+        points[count++] = glt_texture_depth_attachment_point(framebuffer->depth->format);
+    }
+    if (count == 0) {
+        return;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->fbo);
+    glInvalidateFramebuffer(GL_FRAMEBUFFER, count, points);
+}
+
+void glt_framebuffer_blit(
+    const glt_framebuffer_t *framebuffer, GLuint dst_fbo, GLsizei dst_width, GLsizei dst_height, GLenum filter
+) {
+    if (!framebuffer) {
+        return;
+    }
+    glt_framebuffer_blit_region(
+        framebuffer, framebuffer->desc.width, framebuffer->desc.height, dst_fbo, dst_width, dst_height, filter
+    );
+}
+
+void glt_framebuffer_blit_region(
+    const glt_framebuffer_t *framebuffer, GLsizei src_width, GLsizei src_height,
+    GLuint dst_fbo, GLsizei dst_width, GLsizei dst_height, GLenum filter
+) {
+    if (!framebuffer) {
+        return;
+    }
+    const GLuint src = framebuffer->resolve_fbo ? framebuffer->resolve_fbo : framebuffer->fbo;
+    const attachment_t *color = framebuffer->resolve_fbo ? framebuffer->resolve_color[0] : framebuffer->color[0];
+    if (!color) {
+        FRAMEBUFFER_LOG(GLT_LOG_WARNING, "blit needs a resolved color attachment 0");
+        return;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, src);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dst_fbo);
+    glBlitFramebuffer(0, 0, src_width, src_height, 0, 0, dst_width, dst_height, GL_COLOR_BUFFER_BIT, filter);
+    glBindFramebuffer(GL_FRAMEBUFFER, dst_fbo);
+}
+
+const glt_texture_t *glt_framebuffer_get_texture(const glt_framebuffer_t *framebuffer, int index) {
+    if (!framebuffer || index < 0 || index >= GLT_FRAMEBUFFER_MAX_COLOR) {
+        return NULL;
+    }
+    const attachment_t *color = framebuffer->resolve_fbo ? framebuffer->resolve_color[index] : framebuffer->color[index];
+    return color ? color->texture : NULL;
+}
+
+const glt_texture_t *glt_framebuffer_get_depth_texture(const glt_framebuffer_t *framebuffer) {
+    if (!framebuffer) {
+        return NULL;
+    }
+    const attachment_t *depth = framebuffer->resolve_fbo ? framebuffer->resolve_depth : framebuffer->depth;
+    return depth ? depth->texture : NULL;
+}
+
+GLuint glt_framebuffer_get_id(const glt_framebuffer_t *framebuffer) {
+    return framebuffer ? framebuffer->fbo : 0;
+}
+
+GLsizei glt_framebuffer_get_width(const glt_framebuffer_t *framebuffer) {
+    return framebuffer ? framebuffer->desc.width : 0;
+}
+
+GLsizei glt_framebuffer_get_height(const glt_framebuffer_t *framebuffer) {
+    return framebuffer ? framebuffer->desc.height : 0;
+}
+
+GLsizei glt_framebuffer_get_samples(const glt_framebuffer_t *framebuffer) {
+    return framebuffer ? framebuffer->desc.samples : 0;
+}
+
+glt_framebuffer_pool_t *glt_framebuffer_pool_create(unsigned max_idle_frames) {
+    glt_framebuffer_pool_t *pool = calloc(1, sizeof(glt_framebuffer_pool_t));
+    if (!pool) {
+        FRAMEBUFFER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+    pool->max_idle_frames = max_idle_frames ? max_idle_frames : DEFAULT_MAX_IDLE_FRAMES;
+    return pool;
+}
+
+void glt_framebuffer_pool_destroy(glt_framebuffer_pool_t *pool) {
+    if (!pool) {
+        return;
+    }
+    attachment_t *attachment = pool->idle;
+    while (attachment) {
+        attachment_t *next = attachment->next;
+        destroy_attachment(attachment);
+        attachment = next;
+    }
+    free(pool);
+}
+
+void glt_framebuffer_pool_end_frame(glt_framebuffer_pool_t *pool) {
+    if (!pool) {
+        return;
+    }
+    pool->frame++;
+
+    attachment_t **link = &pool->idle;
+    while (*link) {
+        attachment_t *attachment = *link;
+        if (pool->frame - attachment->idle_since > pool->max_idle_frames) {
+            *link = attachment->next;
+            pool->count--;
+            pool->bytes -= attachment->bytes;
+            destroy_attachment(attachment);
+        } else {
+            link = &attachment->next;
+        }
+    }
+}
+
+size_t glt_framebuffer_pool_get_count(const glt_framebuffer_pool_t *pool) {
+    return pool ? pool->count : 0;
+}
+
+size_t glt_framebuffer_pool_get_memory_size(const glt_framebuffer_pool_t *pool) {
+    return pool ? pool->bytes : 0;
+}
+
+// helper funcs
+
+static bool acquire_attachments(glt_framebuffer_t *framebuffer) {
+    const glt_framebuffer_desc_t *desc = &framebuffer->desc;
+    const bool msaa = desc->samples > 1;
+    bool ok = true;
+    bool any = false;
+
+    for (int i = 0; i < GLT_FRAMEBUFFER_MAX_COLOR; ++i) {
+        const glt_attachment_desc_t *color = &desc->color[i];
+        if (!color->format) {
+            continue;
+        }
+        any = true;
+        framebuffer->color[i] = acquire_attachment(
+            framebuffer->pool, color->format, desc->width, desc->height, desc->samples, msaa || color->renderbuffer
+        );
+        ok = ok && framebuffer->color[i];
+        if (msaa && !color->transient) {
+            framebuffer->resolve_color[i] = acquire_attachment(
+                framebuffer->pool, color->format, desc->width, desc->height, 1, color->renderbuffer
+            );
+            ok = ok && framebuffer->resolve_color[i];
+        }
+    }
+
+    if (desc->depth.format) {
+        any = true;
+        framebuffer->depth = acquire_attachment(
+            framebuffer->pool, desc->depth.format, desc->width, desc->height, desc->samples,
+            msaa || desc->depth.renderbuffer
+        );
+        ok = ok && framebuffer->depth;
+        if (msaa && !desc->depth.transient) {
+            framebuffer->resolve_depth = acquire_attachment(
+                framebuffer->pool, desc->depth.format, desc->width, desc->height, 1, desc->depth.renderbuffer
+            );
+            ok = ok && framebuffer->resolve_depth;
+        }
+    }
+
+    if (!any) {
+        FRAMEBUFFER_LOG(GLT_LOG_ERROR, "framebuffer has no attachments");
+        return false;
+    }
+    if (!ok) {
+        FRAMEBUFFER_LOG(GLT_LOG_ERROR, "failed to create attachments");
+        return false;
+    }
+
+    const GLuint sampler = glt_sampler_get(&desc->sampler);
+    for (int i = 0; i < GLT_FRAMEBUFFER_MAX_COLOR; ++i) {
+        attachment_t *color = msaa ? framebuffer->resolve_color[i] : framebuffer->color[i];
+        if (color && color->texture) {
+            color->texture->sampler = sampler;
+        }
+    }
+    attachment_t *depth = msaa ? framebuffer->resolve_depth : framebuffer->depth;
+    if (depth && depth->texture) {
+        depth->texture->sampler = sampler;
+    }
+
+    if (!attach(framebuffer->fbo, framebuffer->color, framebuffer->depth)) {
+        return false;
+    }
+    return !msaa || attach(framebuffer->resolve_fbo, framebuffer->resolve_color, framebuffer->resolve_depth);
+}
+
+static void release_attachments(glt_framebuffer_t *framebuffer) {
+    for (int i = 0; i < GLT_FRAMEBUFFER_MAX_COLOR; ++i) {
+        release_attachment(framebuffer->pool, framebuffer->color[i]);
+        release_attachment(framebuffer->pool, framebuffer->resolve_color[i]);
+        framebuffer->color[i] = NULL;
+        framebuffer->resolve_color[i] = NULL;
+    }
+    release_attachment(framebuffer->pool, framebuffer->depth);
+    release_attachment(framebuffer->pool, framebuffer->resolve_depth);
+    framebuffer->depth = NULL;
+    framebuffer->resolve_depth = NULL;
+}
+
+static bool attach(GLuint fbo, attachment_t *const *color, const attachment_t *depth) {
+    GLint prev_draw = 0;
+    GLint prev_read = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prev_draw);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prev_read);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    GLenum read = GL_NONE;
+    for (int i = 0; i < GLT_FRAMEBUFFER_MAX_COLOR; ++i) {
+        attach_one(GL_COLOR_ATTACHMENT0 + i, color[i]);
+        if (color[i] && read == GL_NONE) {
+            read = GL_COLOR_ATTACHMENT0 + i;
+        }
+    }
+    if (depth) {
+        attach_one(glt_texture_depth_attachment_point(depth->format), depth);
+    } else {
+        attach_one(GL_DEPTH_STENCIL_ATTACHMENT, NULL);
+    }
+    set_draw_buffers(color, -1);
+    glReadBuffer(read);
+
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint) prev_draw);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint) prev_read);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        FRAMEBUFFER_LOG(GLT_LOG_ERROR, "framebuffer is incomplete (0x%x)", status);
+        return false;
+    }
+    return true;
+}
+
+static attachment_t *acquire_attachment(
+    glt_framebuffer_pool_t *pool, GLenum format, GLsizei width, GLsizei height, GLsizei samples, bool renderbuffer
+) {
+    if (pool) {
+        for (attachment_t **link = &pool->idle; *link; link = &(*link)->next) {
+            attachment_t *attachment = *link;
+            if (attachment->format == format && attachment->width == width && attachment->height == height
+                && attachment->samples == samples && attachment->renderbuffer == renderbuffer) {
+                *link = attachment->next;
+                attachment->next = NULL;
+                pool->count--;
+                pool->bytes -= attachment->bytes;
+                return attachment;
+            }
+        }
+    }
+    return create_attachment(format, width, height, samples, renderbuffer);
+}
+
+static void release_attachment(glt_framebuffer_pool_t *pool, attachment_t *attachment) {
+    if (!attachment) {
+        return;
+    }
+    if (!pool) {
+        destroy_attachment(attachment);
+        return;
+    }
+    attachment->idle_since = pool->frame;
+    attachment->next = pool->idle;
+    pool->idle = attachment;
+    pool->count++;
+    pool->bytes += attachment->bytes;
+}
+
+static attachment_t *create_attachment(GLenum format, GLsizei width, GLsizei height, GLsizei samples, bool renderbuffer) {
+    attachment_t *attachment = calloc(1, sizeof(attachment_t));
+    if (!attachment) {
+        return NULL;
+    }
+    attachment->format = format;
+    attachment->width = width;
+    attachment->height = height;
+    attachment->samples = samples;
+    attachment->renderbuffer = renderbuffer;
+    attachment->bytes = (size_t) width * (size_t) height * (size_t) samples * glt_texture_format_bytes(format);
+
+    if (renderbuffer) {
+        glGenRenderbuffers(1, &attachment->id);
+        glBindRenderbuffer(GL_RENDERBUFFER, attachment->id);
+        if (samples > 1) {
+            glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, format, width, height);
+        } else {
+            glRenderbufferStorage(GL_RENDERBUFFER, format, width, height);
+        }
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        glt_stats_track_resource(GLT_RESOURCE_RENDERBUFFER, 1, (int64_t) attachment->bytes);
+        return attachment;
+    }
+
+    attachment->texture = glt_texture_create_render_target(format, width, height);
+    if (!attachment->texture) {
+        free(attachment);
+        return NULL;
+    }
+    attachment->id = attachment->texture->id;
+    return attachment;
+}
+
+static void destroy_attachment(attachment_t *attachment) {
+    if (attachment->texture) {
+        // deletes the texture object and untracks it
+        glt_texture_destroy(attachment->texture);
+    } else if (attachment->id) {
+        glDeleteRenderbuffers(1, &attachment->id);
+        glt_stats_track_resource(GLT_RESOURCE_RENDERBUFFER, -1, -(int64_t) attachment->bytes);
+    }
+    free(attachment);
+}
+
+static void attach_one(GLenum point, const attachment_t *attachment) {
+    if (!attachment) {
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, point, GL_RENDERBUFFER, 0);
+    } else if (attachment->renderbuffer) {
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, point, GL_RENDERBUFFER, attachment->id);
+    } else {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, point, GL_TEXTURE_2D, attachment->id, 0);
+    }
+}
+
+// draw buffer i always maps to color attachment i; only >= 0 enables just that one
+static void set_draw_buffers(attachment_t *const *color, int only) {
+    GLenum buffers[GLT_FRAMEBUFFER_MAX_COLOR];
+    GLsizei count = 0;
+    for (int i = 0; i < GLT_FRAMEBUFFER_MAX_COLOR; ++i) {
+        const bool enabled = color[i] && (only < 0 || only == i);
+        buffers[i] = enabled ? GL_COLOR_ATTACHMENT0 + i : GL_NONE;
+        if (enabled) {
+            count = i + 1;
+        }
+    }
+    if (count == 0) {
+        glDrawBuffer(GL_NONE);
+        return;
+    }
+    glDrawBuffers(count, buffers);
+}
+
+static GLbitfield depth_blit_mask(GLenum format) {
+    switch (glt_texture_depth_attachment_point(format)) {
+        case GL_DEPTH_STENCIL_ATTACHMENT:
+            return GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT;
+        case GL_STENCIL_ATTACHMENT:
+            return GL_STENCIL_BUFFER_BIT;
+        default:
+            return GL_DEPTH_BUFFER_BIT;
+    }
+}
@@ -0,0 +1,423 @@
+#include "glt_gpu_profiler.h"
+#include "glt_time.h"
+#include "glt_log.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PROFILER_LOG(level, msg, ...)    glt_log(level, "[GPU PROFILER]: " msg, ##__VA_ARGS__)
+
+// weight of the newest frame in the moving average
+#define AVG_WEIGHT 0.05
+
+typedef struct {
+    size_t scope;
+    int depth;
+} gpu_event_t;
+
+typedef struct {
+    // two per event, then the frame's begin and end
+    GLuint *queries;
+    gpu_event_t *events;
+    size_t event_count;
+    uint64_t index;
+    bool pending;
+} frame_slot_t;
+
+typedef struct {
+    char *name;
+    glt_gpu_scope_stats_t stats;
+} scope_t;
+
+struct glt_gpu_profiler_t {
+    frame_slot_t *slots;
+    size_t slot_count;
+    size_t max_events;
+    uint64_t frame;
+    bool enabled;
+    bool recording;
+
+    // frame being recorded
+    frame_slot_t *current;
+    size_t stack[GLT_GPU_PROFILER_MAX_DEPTH];
+    int depth;
+    int skipped_depth;
+
+    scope_t *scopes;
+    size_t scope_count;
+    size_t scope_cap;
+
+    // scratch for one frame's per-scope totals
+    double *frame_totals;
+    uint32_t *frame_calls;
+
+    // most recently harvested frame
+    glt_gpu_event_t *timeline;
+    size_t timeline_count;
+    uint64_t timeline_frame;
+    double timeline_start;
+    double frame_ms;
+    uint64_t dropped;
+
+    // glt_time_now minus GPU time, both in seconds
+    double clock_offset;
+};
+
+// helper funcs
+
+static bool harvest_slot(glt_gpu_profiler_t *profiler, frame_slot_t *slot);
+
+static bool find_scope(glt_gpu_profiler_t *profiler, const char *name, size_t *index);
+
+// public funcs
+
+glt_gpu_profiler_t *glt_gpu_profiler_create(int frames_in_flight, int max_scopes) {
+    glt_gpu_profiler_t *profiler = calloc(1, sizeof(glt_gpu_profiler_t));
+    if (!profiler) {
+        PROFILER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+
+    profiler->slot_count = frames_in_flight > 0 ? (size_t) frames_in_flight : GLT_GPU_PROFILER_FRAMES_DEFAULT;
+    profiler->max_events = max_scopes > 0 ? (size_t) max_scopes : GLT_GPU_PROFILER_SCOPES_DEFAULT;
+    profiler->enabled = true;
+    profiler->timeline_frame = UINT64_MAX;
+
+    // GL_TIMESTAMP reads the GPU clock without waiting for queued work
+    GLint64 gpu_now = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+    profiler->clock_offset = glt_time_now() - (double) gpu_now * 1e-9;
+
+    profiler->slots = calloc(profiler->slot_count, sizeof(frame_slot_t));
+    profiler->timeline = malloc(profiler->max_events * sizeof(glt_gpu_event_t));
+    if (!profiler->slots || !profiler->timeline) {
+        PROFILER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        glt_gpu_profiler_destroy(profiler);
+        return NULL;
+    }
+
+    const size_t query_count = profiler->max_events * 2 + 2;
+    for (size_t i = 0; i < profiler->slot_count; ++i) {
+        frame_slot_t *slot = &profiler->slots[i];
+        slot->queries = malloc(query_count * sizeof(GLuint));
+        slot->events = malloc(profiler->max_events * sizeof(gpu_event_t));
+        if (!slot->queries || !slot->events) {
+            PROFILER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+            free(slot->queries);
+            slot->queries = NULL;
+            glt_gpu_profiler_destroy(profiler);
+            return NULL;
+        }
+        glGenQueries((GLsizei) query_count, slot->queries);
+    }
+
+    return profiler;
+}
+
+void glt_gpu_profiler_destroy(glt_gpu_profiler_t *profiler) {
+    if (!profiler) {
+        return;
+    }
+
+    if (profiler->slots) {
+        const size_t query_count = profiler->max_events * 2 + 2;
+        for (size_t i = 0; i < profiler->slot_count; ++i) {
+            if (profiler->slots[i].queries) {
+                glDeleteQueries((GLsizei) query_count, profiler->slots[i].queries);
+            }
+            free(profiler->slots[i].queries);
+            free(profiler->slots[i].events);
+        }
+    }
+    for (size_t i = 0; i < profiler->scope_count; ++i) {
+        free(profiler->scopes[i].name);
+    }
+
+    free(profiler->slots);
+    free(profiler->scopes);
+    free(profiler->frame_totals);
+    free(profiler->frame_calls);
+    free(profiler->timeline);
+    free(profiler);
+}
+
+void glt_gpu_profiler_set_enabled(glt_gpu_profiler_t *profiler, bool enabled) {
+    if (profiler) {
+        profiler->enabled = enabled;
+    }
+}
+
+void glt_gpu_profiler_begin_frame(glt_gpu_profiler_t *profiler) {
+    if (!profiler) {
+        return;
+    }
+    if (profiler->recording) {
+        glt_gpu_profiler_end_frame(profiler);
+    }
+
+    // oldest first, results arrive in submission order so the first unavailable frame ends the scan
+    for (size_t i = 0; i < profiler->slot_count; ++i) {
+        frame_slot_t *slot = &profiler->slots[(profiler->frame + i) % profiler->slot_count];
+        if (slot->pending && !harvest_slot(profiler, slot)) {
+            break;
+        }
+    }
+
+    if (!profiler->enabled) {
+        return;
+    }
+
+    frame_slot_t *slot = &profiler->slots[profiler->frame % profiler->slot_count];
+    if (slot->pending) {
+        // still in flight after a full ring of frames, reusing the queries discards it
+        slot->pending = false;
+        profiler->dropped++;
+    }
+
+    slot->event_count = 0;
+    slot->index = profiler->frame++;
+    profiler->current = slot;
+    profiler->depth = 0;
+    profiler->skipped_depth = 0;
+    profiler->recording = true;
+
+    glQueryCounter(slot->queries[profiler->max_events * 2], GL_TIMESTAMP);
+}
+
+void glt_gpu_profiler_end_frame(glt_gpu_profiler_t *profiler) {
+    if (!profiler || !profiler->recording) {
+        return;
+    }
+    while (profiler->depth > 0 || profiler->skipped_depth > 0) {
+        PROFILER_LOG(GLT_LOG_WARNING, "scope left open at the end of the frame");
+        glt_gpu_profiler_pop(profiler);
+    }
+
+    frame_slot_t *slot = profiler->current;
+    glQueryCounter(slot->queries[profiler->max_events * 2 + 1], GL_TIMESTAMP);
+    slot->pending = true;
+    profiler->current = NULL;
+    profiler->recording = false;
+}
+
+void glt_gpu_profiler_push(glt_gpu_profiler_t *profiler, const char *name) {
+    if (!profiler || !profiler->recording || !name) {
+        return;
+    }
+
+    frame_slot_t *slot = profiler->current;
+    size_t scope = 0;
+    if (profiler->skipped_depth > 0 || profiler->depth == GLT_GPU_PROFILER_MAX_DEPTH
+        || slot->event_count == profiler->max_events || !find_scope(profiler, name, &scope)) {
+        // pops still have to pair up with the pushes that were ignored
+        profiler->skipped_depth++;
+        return;
+    }
+
+    const size_t event = slot->event_count++;
+    slot->events[event].scope = scope;
+    slot->events[event].depth = profiler->depth;
+    profiler->stack[profiler->depth++] = event;
+
+    glQueryCounter(slot->queries[event * 2], GL_TIMESTAMP);
+}
+
+void glt_gpu_profiler_pop(glt_gpu_profiler_t *profiler) {
+    if (!profiler || !profiler->recording) {
+        return;
+    }
+    if (profiler->skipped_depth > 0) {
+        profiler->skipped_depth--;
+        return;
+    }
+    if (profiler->depth == 0) {
+        PROFILER_LOG(GLT_LOG_WARNING, "pop without a matching push");
+        return;
+    }
+
+    const size_t event = profiler->stack[--profiler->depth];
+    glQueryCounter(profiler->current->queries[event * 2 + 1], GL_TIMESTAMP);
+}
+
+size_t glt_gpu_profiler_get_scope_count(const glt_gpu_profiler_t *profiler) {
+    return profiler ? profiler->scope_count : 0;
+}
+
+bool glt_gpu_profiler_get_scope(const glt_gpu_profiler_t *profiler, size_t index, glt_gpu_scope_stats_t *stats) {
+    if (!profiler || !stats || index >= profiler->scope_count) {
+        return false;
+    }
+    *stats = profiler->scopes[index].stats;
+    return true;
+}
+
+const glt_gpu_event_t *glt_gpu_profiler_get_timeline(const glt_gpu_profiler_t *profiler, size_t *count) {
+    if (!profiler) {
+        if (count) {
+            *count = 0;
+        }
+        return NULL;
+    }
+    if (count) {
+        *count = profiler->timeline_count;
+    }
+    return profiler->timeline;
+}
+
+uint64_t glt_gpu_profiler_get_timeline_frame(const glt_gpu_profiler_t *profiler) {
+    return profiler ? profiler->timeline_frame : UINT64_MAX;
+}
+
+double glt_gpu_profiler_get_timeline_start(const glt_gpu_profiler_t *profiler) {
+    return profiler ? profiler->timeline_start : 0.0;
+}
+
+double glt_gpu_profiler_get_frame_ms(const glt_gpu_profiler_t *profiler) {
+    return profiler ? profiler->frame_ms : 0.0;
+}
+
+uint64_t glt_gpu_profiler_get_dropped_frames(const glt_gpu_profiler_t *profiler) {
+    return profiler ? profiler->dropped : 0;
+}
+
+void glt_gpu_profiler_print_timeline(const glt_gpu_profiler_t *profiler, FILE *out) {
+    if (!profiler || !out) {
+        return;
+    }
+
+    fprintf(out, "---------------- GPU frame: %.3f ms ----------------\n", profiler->frame_ms);
+    for (size_t i = 0; i < profiler->timeline_count; ++i) {
+        const glt_gpu_event_t *event = &profiler->timeline[i];
+        fprintf(
+            out, "%*s%-*s %9.3f %9.3f ms\n", event->depth * 2, "", 32 - event->depth * 2, event->name,
+            event->start_ms, event->duration_ms
+        );
+    }
+}
+
+void glt_gpu_profiler_print_stats(const glt_gpu_profiler_t *profiler, FILE *out) {
+    if (!profiler || !out) {
+        return;
+    }
+
+    fprintf(out, "%-32s %9s %9s %9s %9s\n", "scope", "last", "avg", "min", "max");
+    for (size_t i = 0; i < profiler->scope_count; ++i) {
+        const glt_gpu_scope_stats_t *stats = &profiler->scopes[i].stats;
+        if (stats->frames == 0) {
+            continue;
+        }
+        fprintf(
+            out, "%-32s %9.3f %9.3f %9.3f %9.3f\n", stats->name,
+            stats->last_ms, stats->avg_ms, stats->min_ms, stats->max_ms
+        );
+    }
+}
+
+// helper funcs
+
+static bool harvest_slot(glt_gpu_profiler_t *profiler, frame_slot_t *slot) {
+    // the frame's end timestamp is the last query issued for it
+    const GLuint *frame_queries = &slot->queries[profiler->max_events * 2];
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(frame_queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return false;
+    }
+    slot->pending = false;
+
+    GLuint64 frame_begin = 0, frame_end = 0;
+    glGetQueryObjectui64v(frame_queries[0], GL_QUERY_RESULT, &frame_begin);
+    glGetQueryObjectui64v(frame_queries[1], GL_QUERY_RESULT, &frame_end);
+    profiler->frame_ms = (double) (frame_end - frame_begin) * 1e-6;
+    profiler->timeline_frame = slot->index;
+    profiler->timeline_start = (double) frame_begin * 1e-9 + profiler->clock_offset;
+
+    memset(profiler->frame_totals, 0, profiler->scope_count * sizeof(double));
+    memset(profiler->frame_calls, 0, profiler->scope_count * sizeof(uint32_t));
+
+    for (size_t i = 0; i < slot->event_count; ++i) {
+        const gpu_event_t *event = &slot->events[i];
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(slot->queries[i * 2], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(slot->queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+        const double duration = end > begin ? (double) (end - begin) * 1e-6 : 0.0;
+
+        glt_gpu_event_t *out = &profiler->timeline[i];
+        out->name = profiler->scopes[event->scope].name;
+        out->depth = event->depth;
+        out->start_ms = begin > frame_begin ? (double) (begin - frame_begin) * 1e-6 : 0.0;
+        out->duration_ms = duration;
+
+        profiler->frame_totals[event->scope] += duration;
+        profiler->frame_calls[event->scope]++;
+    }
+    profiler->timeline_count = slot->event_count;
+
+    for (size_t i = 0; i < profiler->scope_count; ++i) {
+        if (profiler->frame_calls[i] == 0) {
+            continue;
+        }
+        glt_gpu_scope_stats_t *stats = &profiler->scopes[i].stats;
+        const double ms = profiler->frame_totals[i];
+        if (stats->frames == 0) {
+            stats->avg_ms = ms;
+            stats->min_ms = ms;
+            stats->max_ms = ms;
+        } else {
+            stats->avg_ms += (ms - stats->avg_ms) * AVG_WEIGHT;
+            stats->min_ms = ms < stats->min_ms ? ms : stats->min_ms;
+            stats->max_ms = ms > stats->max_ms ? ms : stats->max_ms;
+        }
+        stats->last_ms = ms;
+        stats->frames++;
+        stats->calls += profiler->frame_calls[i];
+    }
+    return true;
+}
+
+static bool find_scope(glt_gpu_profiler_t *profiler, const char *name, size_t *index) {
+    for (size_t i = 0; i < profiler->scope_count; ++i) {
+        if (strcmp(profiler->scopes[i].name, name) == 0) {
+            *index = i;
+            return true;
+        }
+    }
+
+    if (profiler->scope_count == profiler->scope_cap) {
+        const size_t cap = profiler->scope_cap ? profiler->scope_cap * 2 : 16;
+        scope_t *scopes = realloc(profiler->scopes, cap * sizeof(scope_t));
+        if (!scopes) {
+            PROFILER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+            return false;
+        }
+        profiler->scopes = scopes;
+
+        double *totals = realloc(profiler->frame_totals, cap * sizeof(double));
+        if (totals) {
+            profiler->frame_totals = totals;
+        }
+        uint32_t *calls = realloc(profiler->frame_calls, cap * sizeof(uint32_t));
+        if (calls) {
+            profiler->frame_calls = calls;
+        }
+        if (!totals || !calls) {
+            PROFILER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+            return false;
+        }
+        profiler->scope_cap = cap;
+    }
+
+    char *copy = malloc(strlen(name) + 1);
+    if (!copy) {
+        PROFILER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return false;
+    }
+    strcpy(copy, name);
+
+    scope_t *scope = &profiler->scopes[profiler->scope_count];
+    memset(scope, 0, sizeof(scope_t));
+    scope->name = copy;
+    scope->stats.name = copy;
+    *index = profiler->scope_count++;
+    return true;
+}
@@ -0,0 +1,655 @@
+#include "glt_hierarchy.h"
+#include "glt_stats.h"
+#include "glt_trace.h"
+#include "glt_log.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#define HIERARCHY_LOG(level, msg, ...)    glt_log(level, "[HIERARCHY]: " msg, ##__VA_ARGS__)
+
+#define DEFAULT_CAPACITY 1024
+
+// translation, rotation or scale changed, the local matrix has to be composed again
+#define NODE_LOCAL_DIRTY 0x01
+// the world matrix has to be recomputed, and with it the whole subtree's
+#define NODE_WORLD_DIRTY 0x02
+// some descendant is flagged, the subtree can't be skipped
+#define NODE_CHILD_DIRTY 0x04
+// dropped with its subtree by the next rebuild
+#define NODE_REMOVED 0x08
+
+struct glt_hierarchy_t {
+    int capacity;
+
+    // by dense index, depth-first so every subtree is the contiguous range [i, i + subtree_sizes[i])
+    int count;
+    glt_node_t *ids;
+    // dense index of the parent, -1 for roots
+    int *parents;
+    int *subtree_sizes;
+    uint8_t *flags;
+    glt_vec3_t *translations;
+    glt_quat_t *rotations;
+    glt_vec3_t *scales;
+    glt_mat4_t *locals;
+    glt_mat4_t *worlds;
+    // dense indices recomputed by the current update
+    int *work;
+
+    // by node id
+    int id_count;
+    // dense index, -1 for free ids
+    int *indices;
+    glt_node_t *parent_ids;
+    // world matrix changed since the last write_changed / upload
+    uint8_t *changed;
+    glt_node_t *changed_ids;
+    int changed_count;
+    glt_node_t *free_ids;
+    int free_count;
+    // id-ordered copies for glt_hierarchy_upload, allocated on first use
+    glt_mat4_t *staging;
+
+    // added, removed or reparented nodes broke the depth-first order
+    bool needs_rebuild;
+};
+
+// helper funcs
+
+static bool grow(glt_hierarchy_t *hierarchy, int needed);
+
+static bool grow_array(void **items, int capacity, size_t item_size);
+
+static bool grow_matrices(glt_mat4_t **items, int old_capacity, int capacity);
+
+static void *aligned_malloc(size_t size);
+
+static void aligned_free(void *ptr);
+
+static int node_index(const glt_hierarchy_t *hierarchy, glt_node_t node);
+
+static void mark_dirty(glt_hierarchy_t *hierarchy, int index, uint8_t flags);
+
+static bool rebuild(glt_hierarchy_t *hierarchy);
+
+static void permute(void *items, size_t item_size, const int *order, int count, void *scratch);
+
+static void compose_locals(glt_hierarchy_t *hierarchy, int work_count);
+
+static void mark_changed(glt_hierarchy_t *hierarchy, glt_node_t id);
+
+// public funcs
+
+glt_hierarchy_t *glt_hierarchy_create(int capacity) {
+    glt_hierarchy_t *hierarchy = calloc(1, sizeof(glt_hierarchy_t));
+    if (!hierarchy) {
+        HIERARCHY_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+    if (!grow(hierarchy, capacity > 0 ? capacity : DEFAULT_CAPACITY)) {
+        glt_hierarchy_destroy(hierarchy);
+        return NULL;
+    }
+    return hierarchy;
+}
+
+void glt_hierarchy_destroy(glt_hierarchy_t *hierarchy) {
+    if (!hierarchy) {
+        return;
+    }
+    free(hierarchy->ids);
+    free(hierarchy->parents);
+    free(hierarchy->subtree_sizes);
+    free(hierarchy->flags);
+    free(hierarchy->translations);
+    free(hierarchy->rotations);
+    free(hierarchy->scales);
+    aligned_free(hierarchy->locals);
+    aligned_free(hierarchy->worlds);
+    free(hierarchy->work);
+    free(hierarchy->indices);
+    free(hierarchy->parent_ids);
+    free(hierarchy->changed);
+    free(hierarchy->changed_ids);
+    free(hierarchy->free_ids);
+    aligned_free(hierarchy->staging);
+    free(hierarchy);
+}
+
+glt_node_t glt_hierarchy_add(glt_hierarchy_t *hierarchy, glt_node_t parent) {
+    if (!hierarchy) {
+        return GLT_NODE_NONE;
+    }
+    const int parent_index = parent == GLT_NODE_NONE ? -1 : node_index(hierarchy, parent);
+    if (parent != GLT_NODE_NONE && parent_index < 0) {
+        HIERARCHY_LOG(GLT_LOG_ERROR, "invalid parent %d", parent);
+        return GLT_NODE_NONE;
+    }
+
+    if (!grow(hierarchy, (hierarchy->id_count > hierarchy->count ? hierarchy->id_count : hierarchy->count) + 1)) {
+        return GLT_NODE_NONE;
+    }
+
+    const glt_node_t id = hierarchy->free_count > 0 ? hierarchy->free_ids[--hierarchy->free_count] : hierarchy->id_count++;
+    const int i = hierarchy->count++;
+
+    // appending keeps parents ahead of children, only the subtree ranges need the rebuild
+    hierarchy->ids[i] = id;
+    hierarchy->parents[i] = parent_index;
+    hierarchy->subtree_sizes[i] = 1;
+    hierarchy->flags[i] = 0;
+    hierarchy->translations[i] = (glt_vec3_t) {0.0f, 0.0f, 0.0f};
+    hierarchy->rotations[i] = glt_quat_identity();
+    hierarchy->scales[i] = (glt_vec3_t) {1.0f, 1.0f, 1.0f};
+    hierarchy->indices[id] = i;
+    hierarchy->parent_ids[id] = parent;
+    hierarchy->needs_rebuild = true;
+
+    mark_dirty(hierarchy, i, NODE_LOCAL_DIRTY | NODE_WORLD_DIRTY);
+
+    return id;
+}
+
+void glt_hierarchy_remove(glt_hierarchy_t *hierarchy, glt_node_t node) {
+    const int i = node_index(hierarchy, node);
+    if (i < 0) {
+        return;
+    }
+    // the whole subtree is invalid from now on, so nothing in it can be reparented out and kept
+    if (!hierarchy->needs_rebuild) {
+        for (int k = i; k < i + hierarchy->subtree_sizes[i]; ++k) {
+            hierarchy->flags[k] |= NODE_REMOVED;
+        }
+    } else {
+        // nodes added or moved since the last update aren't in depth-first order yet
+        hierarchy->flags[i] |= NODE_REMOVED;
+        for (int k = 0; k < hierarchy->count; ++k) {
+            for (glt_node_t a = hierarchy->parent_ids[hierarchy->ids[k]]; a != GLT_NODE_NONE; a = hierarchy->parent_ids[a]) {
+                if (hierarchy->flags[hierarchy->indices[a]] & NODE_REMOVED) {
+                    hierarchy->flags[k] |= NODE_REMOVED;
+                    break;
+                }
+            }
+        }
+    }
+    hierarchy->needs_rebuild = true;
+}
+
+bool glt_hierarchy_set_parent(glt_hierarchy_t *hierarchy, glt_node_t node, glt_node_t parent) {
+    const int i = node_index(hierarchy, node);
+    if (i < 0 || (parent != GLT_NODE_NONE && node_index(hierarchy, parent) < 0)) {
+        HIERARCHY_LOG(GLT_LOG_ERROR, "invalid node %d or parent %d", node, parent);
+        return false;
+    }
+    for (glt_node_t ancestor = parent; ancestor != GLT_NODE_NONE; ancestor = hierarchy->parent_ids[ancestor]) {
+        if (ancestor == node) {
+            HIERARCHY_LOG(GLT_LOG_ERROR, "node %d can't become a descendant of itself", node);
+            return false;
+        }
+    }
+    if (hierarchy->parent_ids[node] == parent) {
+        return true;
+    }
+
+    hierarchy->parent_ids[node] = parent;
+    hierarchy->needs_rebuild = true;
+    mark_dirty(hierarchy, i, NODE_WORLD_DIRTY);
+    return true;
+}
+
+glt_node_t glt_hierarchy_get_parent(const glt_hierarchy_t *hierarchy, glt_node_t node) {
+    return node_index(hierarchy, node) >= 0 ? hierarchy->parent_ids[node] : GLT_NODE_NONE;
+}
+
+bool glt_hierarchy_is_valid(const glt_hierarchy_t *hierarchy, glt_node_t node) {
+    return node_index(hierarchy, node) >= 0;
+}
+
+void glt_hierarchy_set_local(
+    glt_hierarchy_t *hierarchy, glt_node_t node, glt_vec3_t translation, glt_quat_t rotation, glt_vec3_t scale
+) {
+    const int i = node_index(hierarchy, node);
+    if (i < 0) {
+        return;
+    }
+    hierarchy->translations[i] = translation;
+    hierarchy->rotations[i] = rotation;
+    hierarchy->scales[i] = scale;
+    mark_dirty(hierarchy, i, NODE_LOCAL_DIRTY | NODE_WORLD_DIRTY);
+}
+
+void glt_hierarchy_set_translation(glt_hierarchy_t *hierarchy, glt_node_t node, glt_vec3_t translation) {
+    const int i = node_index(hierarchy, node);
+    if (i < 0) {
+        return;
+    }
+    hierarchy->translations[i] = translation;
+    mark_dirty(hierarchy, i, NODE_LOCAL_DIRTY | NODE_WORLD_DIRTY);
+}
+
+void glt_hierarchy_set_rotation(glt_hierarchy_t *hierarchy, glt_node_t node, glt_quat_t rotation) {
+    const int i = node_index(hierarchy, node);
+    if (i < 0) {
+        return;
+    }
+    hierarchy->rotations[i] = rotation;
+    mark_dirty(hierarchy, i, NODE_LOCAL_DIRTY | NODE_WORLD_DIRTY);
+}
+
+void glt_hierarchy_set_scale(glt_hierarchy_t *hierarchy, glt_node_t node, glt_vec3_t scale) {
+    const int i = node_index(hierarchy, node);
+    if (i < 0) {
+        return;
+    }
+    hierarchy->scales[i] = scale;
+    mark_dirty(hierarchy, i, NODE_LOCAL_DIRTY | NODE_WORLD_DIRTY);
+}
+
+void glt_hierarchy_get_local(
+    const glt_hierarchy_t *hierarchy, glt_node_t node, glt_vec3_t *translation, glt_quat_t *rotation, glt_vec3_t *scale
+) {
+    const int i = node_index(hierarchy, node);
+    if (i < 0) {
+        return;
+    }
+    if (translation) {
+        *translation = hierarchy->translations[i];
+    }
+    if (rotation) {
+        *rotation = hierarchy->rotations[i];
+    }
+    if (scale) {
+        *scale = hierarchy->scales[i];
+    }
+}
+
+int glt_hierarchy_update(glt_hierarchy_t *hierarchy) {
+    if (!hierarchy) {
+        return 0;
+    }
+    GLT_ZONE("glt_hierarchy_update");
+
+    if (hierarchy->needs_rebuild && !rebuild(hierarchy)) {
+        return 0;
+    }
+
+    // collect the nodes to recompute in order, skipping clean subtrees whole; a node whose world
+    // matrix changes takes its entire subtree along
+    int work_count = 0;
+    for (int i = 0; i < hierarchy->count;) {
+        const uint8_t flags = hierarchy->flags[i];
+        if (flags & NODE_WORLD_DIRTY) {
+            const int end = i + hierarchy->subtree_sizes[i];
+            for (; i < end; ++i) {
+                hierarchy->work[work_count++] = i;
+            }
+        } else if (flags & NODE_CHILD_DIRTY) {
+            hierarchy->flags[i] &= (uint8_t) ~NODE_CHILD_DIRTY;
+            ++i;
+        } else {
+            i += hierarchy->subtree_sizes[i];
+        }
+    }
+
+    compose_locals(hierarchy, work_count);
+
+    for (int w = 0; w < work_count; ++w) {
+        const int i = hierarchy->work[w];
+        const int parent = hierarchy->parents[i];
+        if (parent < 0) {
+            hierarchy->worlds[i] = hierarchy->locals[i];
+        } else {
+            glt_mat4_mul(&hierarchy->worlds[parent], &hierarchy->locals[i], &hierarchy->worlds[i]);
+        }
+        hierarchy->flags[i] = 0;
+        mark_changed(hierarchy, hierarchy->ids[i]);
+    }
+
+    return work_count;
+}
+
+const glt_mat4_t *glt_hierarchy_get_world(const glt_hierarchy_t *hierarchy, glt_node_t node) {
+    const int i = node_index(hierarchy, node);
+    return i >= 0 ? &hierarchy->worlds[i] : NULL;
+}
+
+int glt_hierarchy_get_count(const glt_hierarchy_t *hierarchy) {
+    return hierarchy ? hierarchy->count : 0;
+}
+
+int glt_hierarchy_get_id_count(const glt_hierarchy_t *hierarchy) {
+    return hierarchy ? hierarchy->id_count : 0;
+}
+
+int glt_hierarchy_write_changed(glt_hierarchy_t *hierarchy, glt_mat4_t *out) {
+    if (!hierarchy || !out) {
+        return 0;
+    }
+
+    int written = 0;
+    for (int c = 0; c < hierarchy->changed_count; ++c) {
+        const glt_node_t id = hierarchy->changed_ids[c];
+        hierarchy->changed[id] = 0;
+        // removed since it changed
+        if (hierarchy->indices[id] < 0) {
+            continue;
+        }
+        out[id] = hierarchy->worlds[hierarchy->indices[id]];
+        ++written;
+    }
+    hierarchy->changed_count = 0;
+
+    return written;
+}
+
+bool glt_hierarchy_upload(glt_hierarchy_t *hierarchy, GLuint buffer, GLintptr offset) {
+    if (!hierarchy || !buffer) {
+        return false;
+    }
+    if (hierarchy->changed_count == 0) {
+        return true;
+    }
+
+    if (!hierarchy->staging && !grow_matrices(&hierarchy->staging, 0, hierarchy->capacity)) {
+        return false;
+    }
+
+    int lo = INT_MAX, hi = -1;
+    for (int c = 0; c < hierarchy->changed_count; ++c) {
+        const glt_node_t id = hierarchy->changed_ids[c];
+        if (hierarchy->indices[id] < 0) {
+            continue;
+        }
+        lo = id < lo ? id : lo;
+        hi = id > hi ? id : hi;
+    }
+    for (int c = 0; c < hierarchy->changed_count; ++c) {
+        hierarchy->changed[hierarchy->changed_ids[c]] = 0;
+    }
+    hierarchy->changed_count = 0;
+    if (hi < 0) {
+        return true;
+    }
+
+    // unchanged ids inside the range are sent again, with their current matrices
+    for (glt_node_t id = lo; id <= hi; ++id) {
+        const int index = hierarchy->indices[id];
+        if (index >= 0) {
+            hierarchy->staging[id] = hierarchy->worlds[index];
+        }
+    }
+
+    const GLsizeiptr size = (GLsizeiptr) (hi - lo + 1) * (GLsizeiptr) sizeof(glt_mat4_t);
+    const GLintptr start = offset + (GLintptr) lo * (GLintptr) sizeof(glt_mat4_t);
+    if (GLAD_GL_VERSION_4_5) {
+        glNamedBufferSubData(buffer, start, size, &hierarchy->staging[lo]);
+    } else {
+        // leaves the caller's binding alone
+        GLint prev = 0;
+        glGetIntegerv(GL_COPY_WRITE_BUFFER_BINDING, &prev);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, start, size, &hierarchy->staging[lo]);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, (GLuint) prev);
+    }
+    glt_stats_add(GLT_STAT_BUFFER_UPLOADS, 1);
+    glt_stats_add(GLT_STAT_BUFFER_UPLOAD_BYTES, (uint64_t) size);
+
+    return true;
+}
+
+// helper funcs
+
+static bool grow(glt_hierarchy_t *hierarchy, int needed) {
+    if (needed <= hierarchy->capacity) {
+        return true;
+    }
+    const int old = hierarchy->capacity;
+    int capacity = old ? old * 2 : 16;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+
+    const bool ok = grow_array((void **) &hierarchy->ids, capacity, sizeof(glt_node_t))
+        && grow_array((void **) &hierarchy->parents, capacity, sizeof(int))
+        && grow_array((void **) &hierarchy->subtree_sizes, capacity, sizeof(int))
+        && grow_array((void **) &hierarchy->flags, capacity, sizeof(uint8_t))
+        && grow_array((void **) &hierarchy->translations, capacity, sizeof(glt_vec3_t))
+        && grow_array((void **) &hierarchy->rotations, capacity, sizeof(glt_quat_t))
+        && grow_array((void **) &hierarchy->scales, capacity, sizeof(glt_vec3_t))
+        && grow_matrices(&hierarchy->locals, old, capacity)
+        && grow_matrices(&hierarchy->worlds, old, capacity)
+        && grow_array((void **) &hierarchy->work, capacity, sizeof(int))
+        && grow_array((void **) &hierarchy->indices, capacity, sizeof(int))
+        && grow_array((void **) &hierarchy->parent_ids, capacity, sizeof(glt_node_t))
+        && grow_array((void **) &hierarchy->changed, capacity, sizeof(uint8_t))
+        && grow_array((void **) &hierarchy->changed_ids, capacity, sizeof(glt_node_t))
+        && grow_array((void **) &hierarchy->free_ids, capacity, sizeof(glt_node_t))
+        && (!hierarchy->staging || grow_matrices(&hierarchy->staging, old, capacity));
+    if (!ok) {
+        HIERARCHY_LOG(GLT_LOG_ERROR, "failed to allocate memory for %d nodes", capacity);
+        return false;
+    }
+
+    memset(hierarchy->changed + old, 0, (size_t) (capacity - old));
+    hierarchy->capacity = capacity;
+    return true;
+}
+
+static bool grow_array(void **items, int capacity, size_t item_size) {
+    void *grown = realloc(*items, (size_t) capacity * item_size);
+    if (!grown) {
+        return false;
+    }
+    *items = grown;
+    return true;
+}
+
+static bool grow_matrices(glt_mat4_t **items, int old_capacity, int capacity) {
+    // realloc only promises malloc's alignment, the SIMD paths want the type's
+    glt_mat4_t *grown = aligned_malloc((size_t) capacity * sizeof(glt_mat4_t));
+    if (!grown) {
+        return false;
+    }
+    if (*items) {
+        memcpy(grown, *items, (size_t) old_capacity * sizeof(glt_mat4_t));
+        aligned_free(*items);
+    } else {
+        old_capacity = 0;
+    }
+    // upload sends never-written ids inside its range too, they should hold zeros rather than garbage
+    memset(grown + old_capacity, 0, (size_t) (capacity - old_capacity) * sizeof(glt_mat4_t));
+    *items = grown;
+    return true;
+}
+
+static void *aligned_malloc(size_t size) {
+#ifdef _WIN32
+    return _aligned_malloc(size, _Alignof(glt_mat4_t));
+#else
+    // aligned_alloc wants a multiple of the alignment, which every matrix array is
+    return aligned_alloc(_Alignof(glt_mat4_t), size);
+#endif
+}
+
+static void aligned_free(void *ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+static int node_index(const glt_hierarchy_t *hierarchy, glt_node_t node) {
+    if (!hierarchy || node < 0 || node >= hierarchy->id_count) {
+        return -1;
+    }
+    const int i = hierarchy->indices[node];
+    return i >= 0 && !(hierarchy->flags[i] & NODE_REMOVED) ? i : -1;
+}
+
+static void mark_dirty(glt_hierarchy_t *hierarchy, int index, uint8_t flags) {
+    hierarchy->flags[index] |= flags;
+    // stops at the first ancestor already flagged, its own ancestors are flagged too
+    for (int p = hierarchy->parents[index]; p >= 0 && !(hierarchy->flags[p] & NODE_CHILD_DIRTY); p = hierarchy->parents[p]) {
+        hierarchy->flags[p] |= NODE_CHILD_DIRTY;
+    }
+}
+
+static bool rebuild(glt_hierarchy_t *hierarchy) {
+    GLT_ZONE("glt_hierarchy_rebuild");
+    const int count = hierarchy->count;
+    const int id_count = hierarchy->id_count;
+
+    // children lists by id, built back to front so siblings keep their current order
+    int *first_child = malloc((size_t) (id_count + 1) * sizeof(int));
+    int *next_sibling = malloc((size_t) (id_count + 1) * sizeof(int));
+    int *stack = malloc((size_t) (count + 1) * sizeof(int));
+    int *order = malloc((size_t) (count + 1) * sizeof(int));
+    void *scratch = aligned_malloc((size_t) (count + 1) * sizeof(glt_mat4_t));
+    if (!first_child || !next_sibling || !stack || !order || !scratch) {
+        HIERARCHY_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        free(first_child);
+        free(next_sibling);
+        free(stack);
+        free(order);
+        aligned_free(scratch);
+        return false;
+    }
+
+    // roots hang off the extra list at id_count
+    const int roots = id_count;
+    for (int id = 0; id <= id_count; ++id) {
+        first_child[id] = -1;
+    }
+    for (int i = count - 1; i >= 0; --i) {
+        const glt_node_t id = hierarchy->ids[i];
+        const glt_node_t parent = hierarchy->parent_ids[id];
+        const int list = parent == GLT_NODE_NONE ? roots : parent;
+        next_sibling[id] = first_child[list];
+        first_child[list] = id;
+    }
+
+    // depth-first; removed nodes take their subtrees with them and free the ids
+    int new_count = 0;
+    int top = 0;
+    for (int id = first_child[roots]; id >= 0; id = next_sibling[id]) {
+        stack[top++] = id;
+    }
+    // the stack pops the last root first, reverse so the order stays stable
+    for (int a = 0, b = top - 1; a < b; ++a, --b) {
+        const int tmp = stack[a];
+        stack[a] = stack[b];
+        stack[b] = tmp;
+    }
+    while (top > 0) {
+        const glt_node_t id = stack[--top];
+        const int old = hierarchy->indices[id];
+        const bool removed = (hierarchy->flags[old] & NODE_REMOVED)
+            || (hierarchy->parent_ids[id] != GLT_NODE_NONE && hierarchy->indices[hierarchy->parent_ids[id]] < 0);
+        if (removed) {
+            // children see the parent's index gone and follow
+            hierarchy->indices[id] = -1;
+            hierarchy->free_ids[hierarchy->free_count++] = id;
+        } else {
+            order[new_count++] = old;
+        }
+
+        const int first = top;
+        for (int child = first_child[id]; child >= 0; child = next_sibling[child]) {
+            stack[top++] = child;
+        }
+        for (int a = first, b = top - 1; a < b; ++a, --b) {
+            const int tmp = stack[a];
+            stack[a] = stack[b];
+            stack[b] = tmp;
+        }
+    }
+
+    permute(hierarchy->ids, sizeof(glt_node_t), order, new_count, scratch);
+    permute(hierarchy->flags, sizeof(uint8_t), order, new_count, scratch);
+    permute(hierarchy->translations, sizeof(glt_vec3_t), order, new_count, scratch);
+    permute(hierarchy->rotations, sizeof(glt_quat_t), order, new_count, scratch);
+    permute(hierarchy->scales, sizeof(glt_vec3_t), order, new_count, scratch);
+    permute(hierarchy->locals, sizeof(glt_mat4_t), order, new_count, scratch);
+    permute(hierarchy->worlds, sizeof(glt_mat4_t), order, new_count, scratch);
+    hierarchy->count = new_count;
+
+    for (int i = 0; i < new_count; ++i) {
+        hierarchy->indices[hierarchy->ids[i]] = i;
+    }
+    for (int i = 0; i < new_count; ++i) {
+        const glt_node_t parent = hierarchy->parent_ids[hierarchy->ids[i]];
+        hierarchy->parents[i] = parent == GLT_NODE_NONE ? -1 : hierarchy->indices[parent];
+        hierarchy->subtree_sizes[i] = 1;
+        hierarchy->flags[i] &= (uint8_t) ~NODE_CHILD_DIRTY;
+    }
+    // children come after their parents, so one backwards pass sums the subtrees and
+    // flags the ancestors of everything dirty
+    for (int i = new_count - 1; i >= 0; --i) {
+        const int parent = hierarchy->parents[i];
+        if (parent < 0) {
+            continue;
+        }
+        hierarchy->subtree_sizes[parent] += hierarchy->subtree_sizes[i];
+        if (hierarchy->flags[i] & (NODE_WORLD_DIRTY | NODE_CHILD_DIRTY)) {
+            hierarchy->flags[parent] |= NODE_CHILD_DIRTY;
+        }
+    }
+
+    free(first_child);
+    free(next_sibling);
+    free(stack);
+    free(order);
+    aligned_free(scratch);
+
+    hierarchy->needs_rebuild = false;
+    return true;
+}
+
+static void permute(void *items, size_t item_size, const int *order, int count, void *scratch) {
+    unsigned char *src = items;
+    unsigned char *dst = scratch;
+    for (int i = 0; i < count; ++i) {
+        memcpy(dst + (size_t) i * item_size, src + (size_t) order[i] * item_size, item_size);
+    }
+    memcpy(src, dst, (size_t) count * item_size);
+}
+
+static void compose_locals(glt_hierarchy_t *hierarchy, int work_count) {
+    // work is ascending, so nodes next to each other in it form contiguous runs of the arrays
+    int run_start = -1;
+    int run_end = -1;
+    for (int w = 0; w <= work_count; ++w) {
+        const int i = w < work_count ? hierarchy->work[w] : -1;
+        const bool dirty = i >= 0 && (hierarchy->flags[i] & NODE_LOCAL_DIRTY);
+        if (dirty && i == run_end) {
+            ++run_end;
+            continue;
+        }
+        if (run_start >= 0) {
+            glt_mat4_compose_trs_array(
+                &hierarchy->translations[run_start], &hierarchy->rotations[run_start], &hierarchy->scales[run_start],
+                &hierarchy->locals[run_start], (size_t) (run_end - run_start)
+            );
+            run_start = -1;
+            run_end = -1;
+        }
+        if (dirty) {
+            run_start = i;
+            run_end = i + 1;
+        }
+    }
+}
+
+static void mark_changed(glt_hierarchy_t *hierarchy, glt_node_t id) {
+    if (!hierarchy->changed[id]) {
+        hierarchy->changed[id] = 1;
+        hierarchy->changed_ids[hierarchy->changed_count++] = id;
+    }
+}
@@ -0,0 +1,650 @@
+#include "glt_image.h"
+#include "glt_trace.h"
+#include "glt_log.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define GLT_IMAGE_X86 1
+#include <immintrin.h>
+#endif
+
+#define IMAGE_LOG(level, msg, ...)    glt_log(level, "[IMAGE]: " msg, ##__VA_ARGS__)
+
+// linear -> sRGB goes through a table indexed by the quantized linear value
+#define ENCODE_STEPS 4096
+
+typedef struct {
+    void (*flip_rows)(unsigned char *a, unsigned char *b, size_t size);
+    void (*rgb_to_rgba)(const unsigned char *rgb, unsigned char *rgba, size_t count);
+    void (*premultiply)(unsigned char *rgba, size_t count);
+    void (*decode_srgb)(const unsigned char *src, float *dst, size_t count);
+    void (*encode_srgb)(const float *src, unsigned char *dst, size_t count);
+    void (*accumulate_rows)(float *dst, const float *const *rows, const float *weights, int taps, size_t count);
+} kernels_t;
+
+typedef struct {
+    int start;
+    int taps;
+} contrib_t;
+
+typedef struct {
+    contrib_t *contribs;
+    float *weights;
+    int max_taps;
+} resample_plan_t;
+
+static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+static glt_image_simd_e cpu_level = GLT_IMAGE_SIMD_NONE;
+static glt_image_simd_e active_level = GLT_IMAGE_SIMD_NONE;
+static kernels_t kernels;
+
+static float srgb_decode_table[256];
+static int32_t srgb_encode_table[ENCODE_STEPS + 1];
+
+// helper funcs
+
+static void init(void);
+
+static void select_kernels(glt_image_simd_e level);
+
+static float srgb_to_linear(float c);
+
+static float linear_to_srgb(float c);
+
+static float filter_weight(glt_image_filter_e filter, float x);
+
+static float filter_support(glt_image_filter_e filter);
+
+static bool build_plan(resample_plan_t *plan, int src_size, int dst_size, glt_image_filter_e filter);
+
+static void free_plan(resample_plan_t *plan);
+
+static void decode_row(const unsigned char *src, float *dst, int width, bool srgb);
+
+static void encode_row(const float *src, unsigned char *dst, int width, bool srgb);
+
+static void resample_row(const float *src, float *dst, const resample_plan_t *plan, int dst_width);
+
+static void flip_rows_scalar(unsigned char *a, unsigned char *b, size_t size);
+
+static void rgb_to_rgba_scalar(const unsigned char *rgb, unsigned char *rgba, size_t count);
+
+static void premultiply_scalar(unsigned char *rgba, size_t count);
+
+static void decode_srgb_scalar(const unsigned char *src, float *dst, size_t count);
+
+static void encode_srgb_scalar(const float *src, unsigned char *dst, size_t count);
+
+static void accumulate_rows_scalar(float *dst, const float *const *rows, const float *weights, int taps, size_t count);
+
+#ifdef GLT_IMAGE_X86
+static void rgb_to_rgba_ssse3(const unsigned char *rgb, unsigned char *rgba, size_t count);
+
+static void premultiply_ssse3(unsigned char *rgba, size_t count);
+
+static void accumulate_rows_sse(float *dst, const float *const *rows, const float *weights, int taps, size_t count);
+
+static void flip_rows_avx2(unsigned char *a, unsigned char *b, size_t size);
+
+static void rgb_to_rgba_avx2(const unsigned char *rgb, unsigned char *rgba, size_t count);
+
+static void premultiply_avx2(unsigned char *rgba, size_t count);
+
+static void decode_srgb_avx2(const unsigned char *src, float *dst, size_t count);
+
+static void encode_srgb_avx2(const float *src, unsigned char *dst, size_t count);
+
+static void accumulate_rows_avx2(float *dst, const float *const *rows, const float *weights, int taps, size_t count);
+#endif
+
+// public funcs
+
+glt_image_simd_e glt_image_get_simd(void) {
+    pthread_once(&init_once, init);
+    return active_level;
+}
+
+void glt_image_set_simd(glt_image_simd_e max_level) {
+    pthread_once(&init_once, init);
+    select_kernels(max_level < cpu_level ? max_level : cpu_level);
+}
+
+void glt_image_flip_vertical(unsigned char *pixels, int width, int height, int channels) {
+    if (!pixels || width <= 0 || height <= 1 || channels <= 0) {
+        return;
+    }
+    pthread_once(&init_once, init);
+
+    const size_t row_bytes = (size_t) width * (size_t) channels;
+    for (int y = 0; y < height / 2; ++y) {
+        kernels.flip_rows(pixels + (size_t) y * row_bytes, pixels + (size_t) (height - 1 - y) * row_bytes, row_bytes);
+    }
+}
+
+void glt_image_rgb_to_rgba(const unsigned char *rgb, unsigned char *rgba, size_t count) {
+    if (!rgb || !rgba) {
+        return;
+    }
+    pthread_once(&init_once, init);
+    kernels.rgb_to_rgba(rgb, rgba, count);
+}
+
+void glt_image_premultiply_alpha(unsigned char *rgba, size_t count) {
+    if (!rgba) {
+        return;
+    }
+    pthread_once(&init_once, init);
+    kernels.premultiply(rgba, count);
+}
+
+void glt_image_srgb_to_linear(const unsigned char *src, float *dst, size_t count) {
+    if (!src || !dst) {
+        return;
+    }
+    pthread_once(&init_once, init);
+    kernels.decode_srgb(src, dst, count);
+}
+
+void glt_image_linear_to_srgb(const float *src, unsigned char *dst, size_t count) {
+    if (!src || !dst) {
+        return;
+    }
+    pthread_once(&init_once, init);
+    kernels.encode_srgb(src, dst, count);
+}
+
+void glt_image_fit(int width, int height, int max_size, int *out_width, int *out_height) {
+    if (max_size <= 0 || (width <= max_size && height <= max_size)) {
+        *out_width = width;
+        *out_height = height;
+        return;
+    }
+
+    const double scale = (double) max_size / (double) (width > height ? width : height);
+    const int w = (int) (width * scale + 0.5);
+    const int h = (int) (height * scale + 0.5);
+    *out_width = w > 0 ? w : 1;
+    *out_height = h > 0 ? h : 1;
+}
+
+unsigned char *glt_image_resize(
+    const unsigned char *rgba, int width, int height,
+    int dst_width, int dst_height, glt_image_filter_e filter, bool srgb
+) {
+    if (!rgba || width <= 0 || height <= 0 || dst_width <= 0 || dst_height <= 0 || filter >= GLT_IMAGE_FILTER__COUNT) {
+        return NULL;
+    }
+    pthread_once(&init_once, init);
+    GLT_ZONE("glt_image_resize");
+
+    resample_plan_t horizontal = {0}, vertical = {0};
+    if (!build_plan(&horizontal, width, dst_width, filter) || !build_plan(&vertical, height, dst_height, filter)) {
+        IMAGE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        free_plan(&horizontal);
+        free_plan(&vertical);
+        return NULL;
+    }
+
+    // horizontally resampled source rows live in a ring that covers one vertical window
+    const int ring_size = vertical.max_taps;
+    const size_t dst_row_floats = (size_t) dst_width * 4;
+    unsigned char *dst = malloc((size_t) dst_width * (size_t) dst_height * 4);
+    float *src_row = malloc((size_t) width * 4 * sizeof(float));
+    float *ring = malloc((size_t) ring_size * dst_row_floats * sizeof(float));
+    int *ring_rows = malloc((size_t) ring_size * sizeof(int));
+    float *out_row = malloc(dst_row_floats * sizeof(float));
+    const float **rows = malloc((size_t) ring_size * sizeof(float *));
+    if (dst && src_row && ring && ring_rows && out_row && rows) {
+        for (int i = 0; i < ring_size; ++i) {
+            ring_rows[i] = -1;
+        }
+
+        for (int y = 0; y < dst_height; ++y) {
+            const contrib_t *contrib = &vertical.contribs[y];
+            for (int k = 0; k < contrib->taps; ++k) {
+                const int sy = contrib->start + k;
+                const int slot = sy % ring_size;
+                float *slot_row = ring + (size_t) slot * dst_row_floats;
+                if (ring_rows[slot] != sy) {
+                    decode_row(rgba + (size_t) sy * (size_t) width * 4, src_row, width, srgb);
+                    resample_row(src_row, slot_row, &horizontal, dst_width);
+                    ring_rows[slot] = sy;
+                }
+                rows[k] = slot_row;
+            }
+
+            kernels.accumulate_rows(
+                out_row, rows, vertical.weights + (size_t) y * (size_t) vertical.max_taps, contrib->taps, dst_row_floats
+            );
+            encode_row(out_row, dst + (size_t) y * (size_t) dst_width * 4, dst_width, srgb);
+        }
+    } else {
+        IMAGE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        free(dst);
+        dst = NULL;
+    }
+
+    free(rows);
+    free(out_row);
+    free(ring_rows);
+    free(ring);
+    free(src_row);
+    free_plan(&horizontal);
+    free_plan(&vertical);
+    return dst;
+}
+
+// helper funcs
+
+static void init(void) {
+    for (int i = 0; i < 256; ++i) {
+        srgb_decode_table[i] = srgb_to_linear((float) i / 255.f);
+    }
+    for (int i = 0; i <= ENCODE_STEPS; ++i) {
+        srgb_encode_table[i] = (int32_t) (linear_to_srgb((float) i / ENCODE_STEPS) * 255.f + 0.5f);
+    }
+
+#ifdef GLT_IMAGE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        cpu_level = GLT_IMAGE_SIMD_AVX2;
+    } else if (__builtin_cpu_supports("ssse3")) {
+        cpu_level = GLT_IMAGE_SIMD_SSSE3;
+    }
+#endif
+    select_kernels(cpu_level);
+}
+
+static void select_kernels(glt_image_simd_e level) {
+    kernels.flip_rows = flip_rows_scalar;
+    kernels.rgb_to_rgba = rgb_to_rgba_scalar;
+    kernels.premultiply = premultiply_scalar;
+    kernels.decode_srgb = decode_srgb_scalar;
+    kernels.encode_srgb = encode_srgb_scalar;
+    kernels.accumulate_rows = accumulate_rows_scalar;
+
+#ifdef GLT_IMAGE_X86
+    if (level >= GLT_IMAGE_SIMD_SSSE3) {
+        kernels.rgb_to_rgba = rgb_to_rgba_ssse3;
+        kernels.premultiply = premultiply_ssse3;
+        kernels.accumulate_rows = accumulate_rows_sse;
+    }
+    if (level >= GLT_IMAGE_SIMD_AVX2) {
+        kernels.flip_rows = flip_rows_avx2;
+        kernels.rgb_to_rgba = rgb_to_rgba_avx2;
+        kernels.premultiply = premultiply_avx2;
+        kernels.decode_srgb = decode_srgb_avx2;
+        kernels.encode_srgb = encode_srgb_avx2;
+        kernels.accumulate_rows = accumulate_rows_avx2;
+    }
+#else
+    level = GLT_IMAGE_SIMD_NONE;
+#endif
+    active_level = level;
+}
+
+static float srgb_to_linear(float c) {
+    return c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static float linear_to_srgb(float c) {
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * powf(c, 1.f / 2.4f) - 0.055f;
+}
+
+static float filter_weight(glt_image_filter_e filter, float x) {
+    if (filter == GLT_IMAGE_FILTER_BOX) {
+        return x >= -0.5f && x < 0.5f ? 1.f : 0.f;
+    }
+
+    x = fabsf(x);
+    if (x < 1e-6f) {
+        return 1.f;
+    }
+    if (x >= 3.f) {
+        return 0.f;
+    }
+    const float pi_x = 3.14159265358979f * x;
+    return 3.f * sinf(pi_x) * sinf(pi_x / 3.f) / (pi_x * pi_x);
+}
+
+static float filter_support(glt_image_filter_e filter) {
+    return filter == GLT_IMAGE_FILTER_BOX ? 0.5f : 3.f;
+}
+
+static bool build_plan(resample_plan_t *plan, int src_size, int dst_size, glt_image_filter_e filter) {
+    const float scale = (float) src_size / (float) dst_size;
+    // minification widens the kernel, magnification keeps it at its natural size
+    const float filter_scale = scale > 1.f ? scale : 1.f;
+    const float support = filter_support(filter) * filter_scale;
+
+    plan->max_taps = (int) ceilf(support * 2.f) + 1;
+    plan->contribs = malloc((size_t) dst_size * sizeof(contrib_t));
+    plan->weights = calloc((size_t) dst_size * (size_t) plan->max_taps, sizeof(float));
+    if (!plan->contribs || !plan->weights) {
+        return false;
+    }
+
+    for (int i = 0; i < dst_size; ++i) {
+        const float center = ((float) i + 0.5f) * scale;
+        int start = (int) floorf(center - support);
+        int end = (int) ceilf(center + support);
+        if (start < 0) {
+            start = 0;
+        }
+        if (end > src_size) {
+            end = src_size;
+        }
+        if (end - start > plan->max_taps) {
+            end = start + plan->max_taps;
+        }
+
+        float *weights = plan->weights + (size_t) i * (size_t) plan->max_taps;
+        float total = 0.f;
+        for (int j = start; j < end; ++j) {
+            const float w = filter_weight(filter, ((float) j + 0.5f - center) / filter_scale);
+            weights[j - start] = w;
+            total += w;
+        }
+
+        // a box narrower than a texel can miss every sample, fall back to the nearest one
+        if (total == 0.f) {
+            start = (int) center < src_size ? (int) center : src_size - 1;
+            end = start + 1;
+            weights[0] = 1.f;
+            total = 1.f;
+        }
+        for (int j = 0; j < end - start; ++j) {
+            weights[j] /= total;
+        }
+
+        plan->contribs[i].start = start;
+        plan->contribs[i].taps = end - start;
+    }
+    return true;
+}
+
+static void free_plan(resample_plan_t *plan) {
+    free(plan->contribs);
+    free(plan->weights);
+    plan->contribs = NULL;
+    plan->weights = NULL;
+}
+
+static void decode_row(const unsigned char *src, float *dst, int width, bool srgb) {
+    for (int x = 0; x < width; ++x) {
+        const unsigned char *p = src + (size_t) x * 4;
+        float *q = dst + (size_t) x * 4;
+        for (int c = 0; c < 3; ++c) {
+            q[c] = srgb ? srgb_decode_table[p[c]] : (float) p[c] * (1.f / 255.f);
+        }
+        q[3] = (float) p[3] * (1.f / 255.f);
+    }
+}
+
+static void encode_row(const float *src, unsigned char *dst, int width, bool srgb) {
+    for (int x = 0; x < width; ++x) {
+        const float *p = src + (size_t) x * 4;
+        unsigned char *q = dst + (size_t) x * 4;
+        for (int c = 0; c < 4; ++c) {
+            // lanczos lobes overshoot
+            float v = p[c] < 0.f ? 0.f : p[c] > 1.f ? 1.f : p[c];
+            if (srgb && c < 3) {
+                q[c] = (unsigned char) srgb_encode_table[(int) (v * ENCODE_STEPS + 0.5f)];
+            } else {
+                q[c] = (unsigned char) (v * 255.f + 0.5f);
+            }
+        }
+    }
+}
+
+static void resample_row(const float *src, float *dst, const resample_plan_t *plan, int dst_width) {
+    for (int x = 0; x < dst_width; ++x) {
+        const contrib_t *contrib = &plan->contribs[x];
+        const float *weights = plan->weights + (size_t) x * (size_t) plan->max_taps;
+        const float *p = src + (size_t) contrib->start * 4;
+#if defined(GLT_IMAGE_X86) && defined(__SSE2__)
+        // one RGBA texel per register, SSE2 is baseline wherever this builds
+        __m128 acc = _mm_setzero_ps();
+        for (int k = 0; k < contrib->taps; ++k) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(p + k * 4), _mm_set1_ps(weights[k])));
+        }
+        _mm_storeu_ps(dst + (size_t) x * 4, acc);
+#else
+        float acc[4] = {0};
+        for (int k = 0; k < contrib->taps; ++k) {
+            for (int c = 0; c < 4; ++c) {
+                acc[c] += p[k * 4 + c] * weights[k];
+            }
+        }
+        memcpy(dst + (size_t) x * 4, acc, sizeof(acc));
+#endif
+    }
+}
+
+static void flip_rows_scalar(unsigned char *a, unsigned char *b, size_t size) {
+    unsigned char tmp[256];
+    while (size > 0) {
+        const size_t n = size < sizeof(tmp) ? size : sizeof(tmp);
+        memcpy(tmp, a, n);
+        memcpy(a, b, n);
+        memcpy(b, tmp, n);
+        a += n;
+        b += n;
+        size -= n;
+    }
+}
+
+static void rgb_to_rgba_scalar(const unsigned char *rgb, unsigned char *rgba, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        rgba[i * 4 + 0] = rgb[i * 3 + 0];
+        rgba[i * 4 + 1] = rgb[i * 3 + 1];
+        rgba[i * 4 + 2] = rgb[i * 3 + 2];
+        rgba[i * 4 + 3] = 255;
+    }
+}
+
+static void premultiply_scalar(unsigned char *rgba, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        unsigned char *p = rgba + i * 4;
+        const unsigned a = p[3];
+        for (int c = 0; c < 3; ++c) {
+            // exact x * a / 255 with rounding
+            const unsigned t = p[c] * a + 128;
+            p[c] = (unsigned char) ((t + (t >> 8)) >> 8);
+        }
+    }
+}
+
+static void decode_srgb_scalar(const unsigned char *src, float *dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = srgb_decode_table[src[i]];
+    }
+}
+
+static void encode_srgb_scalar(const float *src, unsigned char *dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const float v = src[i] < 0.f ? 0.f : src[i] > 1.f ? 1.f : src[i];
+        dst[i] = (unsigned char) srgb_encode_table[(int) (v * ENCODE_STEPS + 0.5f)];
+    }
+}
+
+static void accumulate_rows_scalar(float *dst, const float *const *rows, const float *weights, int taps, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        float acc = 0.f;
+        for (int k = 0; k < taps; ++k) {
+            acc += rows[k][i] * weights[k];
+        }
+        dst[i] = acc;
+    }
+}
+
+#ifdef GLT_IMAGE_X86
+
+__attribute__((target("ssse3")))
+static void rgb_to_rgba_ssse3(const unsigned char *rgb, unsigned char *rgba, size_t count) {
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32((int) 0xFF000000u);
+
+    size_t i = 0;
+    // each 16 byte load converts 4 pixels and reads 4 bytes ahead
+    for (; i + 6 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (rgb + i * 3));
+        _mm_storeu_si128((__m128i *) (rgba + i * 4), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha));
+    }
+    rgb_to_rgba_scalar(rgb + i * 3, rgba + i * 4, count - i);
+}
+
+__attribute__((target("ssse3")))
+static void premultiply_ssse3(unsigned char *rgba, size_t count) {
+    // per 16-bit lane: the pixel's alpha for r, g, b and 255 for alpha itself
+    const __m128i spread = _mm_setr_epi8(6, 7, 6, 7, 6, 7, -1, -1, 14, 15, 14, 15, 14, 15, -1, -1);
+    const __m128i keep_alpha = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+    const __m128i round = _mm_set1_epi16(128);
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i px = _mm_loadu_si128((const __m128i *) (rgba + i * 4));
+        __m128i lo = _mm_unpacklo_epi8(px, zero);
+        __m128i hi = _mm_unpackhi_epi8(px, zero);
+
+        lo = _mm_add_epi16(_mm_mullo_epi16(lo, _mm_or_si128(_mm_shuffle_epi8(lo, spread), keep_alpha)), round);
+        hi = _mm_add_epi16(_mm_mullo_epi16(hi, _mm_or_si128(_mm_shuffle_epi8(hi, spread), keep_alpha)), round);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+        _mm_storeu_si128((__m128i *) (rgba + i * 4), _mm_packus_epi16(lo, hi));
+    }
+    premultiply_scalar(rgba + i * 4, count - i);
+}
+
+static void accumulate_rows_sse(float *dst, const float *const *rows, const float *weights, int taps, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 acc = _mm_setzero_ps();
+        for (int k = 0; k < taps; ++k) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(rows[k] + i), _mm_set1_ps(weights[k])));
+        }
+        _mm_storeu_ps(dst + i, acc);
+    }
+    for (; i < count; ++i) {
+        float acc = 0.f;
+        for (int k = 0; k < taps; ++k) {
+            acc += rows[k][i] * weights[k];
+        }
+        dst[i] = acc;
+    }
+}
+
+__attribute__((target("avx2")))
+static void flip_rows_avx2(unsigned char *a, unsigned char *b, size_t size) {
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i va = _mm256_loadu_si256((const __m256i *) (a + i));
+        const __m256i vb = _mm256_loadu_si256((const __m256i *) (b + i));
+        _mm256_storeu_si256((__m256i *) (a + i), vb);
+        _mm256_storeu_si256((__m256i *) (b + i), va);
+    }
+    flip_rows_scalar(a + i, b + i, size - i);
+}
+
+__attribute__((target("avx2")))
+static void rgb_to_rgba_avx2(const unsigned char *rgb, unsigned char *rgba, size_t count) {
+    const __m256i shuffle = _mm256_setr_epi8(
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+    );
+    const __m256i alpha = _mm256_set1_epi32((int) 0xFF000000u);
+
+    size_t i = 0;
+    // two 16 byte loads, 12 bytes apart, convert 8 pixels and read 4 bytes ahead
+    for (; i + 10 <= count; i += 8) {
+        const __m128i lo = _mm_loadu_si128((const __m128i *) (rgb + i * 3));
+        const __m128i hi = _mm_loadu_si128((const __m128i *) (rgb + i * 3 + 12));
+        const __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        _mm256_storeu_si256((__m256i *) (rgba + i * 4), _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), alpha));
+    }
+    rgb_to_rgba_scalar(rgb + i * 3, rgba + i * 4, count - i);
+}
+
+__attribute__((target("avx2")))
+static void premultiply_avx2(unsigned char *rgba, size_t count) {
+    const __m256i spread = _mm256_setr_epi8(
+        6, 7, 6, 7, 6, 7, -1, -1, 14, 15, 14, 15, 14, 15, -1, -1,
+        6, 7, 6, 7, 6, 7, -1, -1, 14, 15, 14, 15, 14, 15, -1, -1
+    );
+    const __m256i keep_alpha = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255);
+    const __m256i round = _mm256_set1_epi16(128);
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t i = 0;
+    // unpack and pack both work per 128-bit lane, so pixel order is preserved
+    for (; i + 8 <= count; i += 8) {
+        const __m256i px = _mm256_loadu_si256((const __m256i *) (rgba + i * 4));
+        __m256i lo = _mm256_unpacklo_epi8(px, zero);
+        __m256i hi = _mm256_unpackhi_epi8(px, zero);
+
+        lo = _mm256_add_epi16(_mm256_mullo_epi16(lo, _mm256_or_si256(_mm256_shuffle_epi8(lo, spread), keep_alpha)), round);
+        hi = _mm256_add_epi16(_mm256_mullo_epi16(hi, _mm256_or_si256(_mm256_shuffle_epi8(hi, spread), keep_alpha)), round);
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+        _mm256_storeu_si256((__m256i *) (rgba + i * 4), _mm256_packus_epi16(lo, hi));
+    }
+    premultiply_scalar(rgba + i * 4, count - i);
+}
+
+__attribute__((target("avx2")))
+static void decode_srgb_avx2(const unsigned char *src, float *dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_i32gather_ps(srgb_decode_table, index, 4));
+    }
+    decode_srgb_scalar(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void encode_srgb_avx2(const float *src, unsigned char *dst, size_t count) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 steps = _mm256_set1_ps((float) ENCODE_STEPS);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256i low_bytes = _mm256_setr_epi8(
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+    );
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i), zero), one);
+        const __m256i index = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v, steps), half));
+        const __m256i bytes = _mm256_shuffle_epi8(_mm256_i32gather_epi32(srgb_encode_table, index, 4), low_bytes);
+
+        const uint32_t lo = (uint32_t) _mm_cvtsi128_si32(_mm256_castsi256_si128(bytes));
+        const uint32_t hi = (uint32_t) _mm_cvtsi128_si32(_mm256_extracti128_si256(bytes, 1));
+        memcpy(dst + i, &lo, 4);
+        memcpy(dst + i + 4, &hi, 4);
+    }
+    encode_srgb_scalar(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void accumulate_rows_avx2(float *dst, const float *const *rows, const float *weights, int taps, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < taps; ++k) {
+            acc = _mm256_fmadd_ps(_mm256_loadu_ps(rows[k] + i), _mm256_set1_ps(weights[k]), acc);
+        }
+        _mm256_storeu_ps(dst + i, acc);
+    }
+    accumulate_rows_sse(dst + i, rows, weights, taps, count - i);
+}
+
+#endif
@@ -0,0 +1,181 @@
+#include "glt_job_queue.h"
+#include "glt_trace.h"
+#include "glt_log.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define JOB_LOG(level, msg, ...)    glt_log(level, "[JOB QUEUE]: " msg, ##__VA_ARGS__)
+
+typedef struct job_t {
+    glt_job_fn fn;
+    void *user;
+    struct job_t *next;
+} job_t;
+
+struct glt_job_queue_t {
+    pthread_mutex_t mutex;
+    pthread_cond_t has_job;
+    pthread_cond_t idle;
+    job_t *head;
+    job_t *tail;
+    int active;
+    bool stop;
+    int n_threads;
+    pthread_t *threads;
+};
+
+// helper funcs
+
+static void *worker_main(void *arg);
+
+static int default_thread_count(void);
+
+// public funcs
+
+glt_job_queue_t *glt_job_queue_create(int n_threads) {
+    if (n_threads <= 0) {
+        n_threads = default_thread_count();
+    }
+
+    glt_job_queue_t *queue = calloc(1, sizeof(glt_job_queue_t));
+    if (!queue) {
+        JOB_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+
+    queue->threads = calloc(n_threads, sizeof(pthread_t));
+    if (!queue->threads) {
+        JOB_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        free(queue);
+        return NULL;
+    }
+
+    pthread_mutex_init(&queue->mutex, NULL);
+    pthread_cond_init(&queue->has_job, NULL);
+    pthread_cond_init(&queue->idle, NULL);
+
+    for (int i = 0; i < n_threads; ++i) {
+        if (pthread_create(&queue->threads[i], NULL, worker_main, queue) != 0) {
+            JOB_LOG(GLT_LOG_ERROR, "failed to start worker %d", i);
+            break;
+        }
+        queue->n_threads++;
+    }
+
+    if (queue->n_threads == 0) {
+        glt_job_queue_destroy(queue);
+        return NULL;
+    }
+
+    return queue;
+}
+
+void glt_job_queue_destroy(glt_job_queue_t *queue) {
+    if (!queue) {
+        return;
+    }
+
+    glt_job_queue_wait(queue);
+
+    pthread_mutex_lock(&queue->mutex);
+    queue->stop = true;
+    pthread_cond_broadcast(&queue->has_job);
+    pthread_mutex_unlock(&queue->mutex);
+
+    for (int i = 0; i < queue->n_threads; ++i) {
+        pthread_join(queue->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&queue->idle);
+    pthread_cond_destroy(&queue->has_job);
+    pthread_mutex_destroy(&queue->mutex);
+    free(queue->threads);
+    free(queue);
+}
+
+bool glt_job_queue_push(glt_job_queue_t *queue, glt_job_fn fn, void *user) {
+    if (!queue || !fn) {
+        return false;
+    }
+
+    job_t *job = malloc(sizeof(job_t));
+    if (!job) {
+        JOB_LOG(GLT_LOG_ERROR, "failed to allocate job");
+        return false;
+    }
+    job->fn = fn;
+    job->user = user;
+    job->next = NULL;
+
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->tail) {
+        queue->tail->next = job;
+    } else {
+        queue->head = job;
+    }
+    queue->tail = job;
+    pthread_cond_signal(&queue->has_job);
+    pthread_mutex_unlock(&queue->mutex);
+
+    return true;
+}
+
+void glt_job_queue_wait(glt_job_queue_t *queue) {
+    if (!queue) {
+        return;
+    }
+
+    pthread_mutex_lock(&queue->mutex);
+    while (queue->head || queue->active > 0) {
+        pthread_cond_wait(&queue->idle, &queue->mutex);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+int glt_job_queue_get_thread_count(const glt_job_queue_t *queue) {
+    return queue ? queue->n_threads : 0;
+}
+
+// helper funcs
+
+static void *worker_main(void *arg) {
+    glt_job_queue_t *queue = arg;
+    GLT_TRACE_THREAD_NAME("glt worker");
+
+    pthread_mutex_lock(&queue->mutex);
+    for (;;) {
+        while (!queue->head && !queue->stop) {
+            pthread_cond_wait(&queue->has_job, &queue->mutex);
+        }
+        if (!queue->head) {
+            break;
+        }
+
+        job_t *job = queue->head;
+        queue->head = job->next;
+        if (!queue->head) {
+            queue->tail = NULL;
+        }
+        queue->active++;
+        pthread_mutex_unlock(&queue->mutex);
+
+        job->fn(job->user);
+        free(job);
+
+        pthread_mutex_lock(&queue->mutex);
+        queue->active--;
+        if (!queue->head && queue->active == 0) {
+            pthread_cond_broadcast(&queue->idle);
+        }
+    }
+    pthread_mutex_unlock(&queue->mutex);
+
+    return NULL;
+}
+
+static int default_thread_count(void) {
+    const long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 1 ? (int) (n - 1) : 1;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdbool.h>
+
+// internal fixed-size worker pool, jobs run in FIFO order
+
+typedef struct glt_job_queue_t glt_job_queue_t;
+
+typedef void (*glt_job_fn)(void *user);
+
+// n_threads <= 0 picks (online cpus - 1), at least 1
+glt_job_queue_t *glt_job_queue_create(int n_threads);
+
+// waits for queued jobs, then joins the workers
+void glt_job_queue_destroy(glt_job_queue_t *queue);
+
+bool glt_job_queue_push(glt_job_queue_t *queue, glt_job_fn fn, void *user);
+
+// blocks until the queue is empty and no job is running
+void glt_job_queue_wait(glt_job_queue_t *queue);
+
+int glt_job_queue_get_thread_count(const glt_job_queue_t *queue);
@@ -1,10 +1,41 @@
 #include "glt_log.h"
 
 #include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdatomic.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
-#include <stdarg.h>
 #include <stdlib.h>
+#include <time.h>
+
+#define LOG_PREFIX "[LOG]: "
+#define LOG_LOG(level, msg, ...)    glt_log(level, LOG_PREFIX msg, ##__VA_ARGS__)
+
+#define GLT_LOG_MAX_SINKS 8
+#define DEFAULT_CAPACITY 1024
+// a wakeup lost to a producer signaling without the mutex costs at most this
+#define CONSUMER_WAIT_NS 50000000L
+
+typedef struct {
+    // slot position + 1 once the record is published, position + capacity once it is free again
+    atomic_size_t seq;
+    glt_log_level_e level;
+    char message[GLT_LOG_MESSAGE_SIZE];
+} record_t;
+
+typedef struct {
+    glt_log_sink_fn fn;
+    void *user;
+} sink_t;
+
+typedef enum {
+    PUSH_SYNC,
+    PUSH_QUEUED,
+    PUSH_DROPPED
+} push_result_e;
 
 static const char *level_names[] = {
     "INFO",
@@ -13,22 +44,414 @@ static const char *level_names[] = {
     "FATAL"
 };
 
-void glt_log(glt_log_level_e level, const char *msg, ...) {
-    assert(level < GLT_LOG__COUNT);
+// sinks, guarded by sink_mutex
+static pthread_mutex_t sink_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool console_enabled = true;
+static FILE *log_file;
+static sink_t sinks[GLT_LOG_MAX_SINKS];
+static int sink_count;
+
+// async backend; start / stop are serialized by lifecycle_mutex, the consumer sleeps on async_mutex
+static pthread_mutex_t lifecycle_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t async_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t drained = PTHREAD_COND_INITIALIZER;
+static pthread_t consumer;
+static bool atexit_registered;
+
+static record_t *ring;
+static size_t ring_mask;
+// next position producers claim, monotonic across restarts
+static atomic_size_t tail;
+// next position the consumer reads, consumer only
+static size_t head;
+// every position below was handed to the sinks
+static atomic_size_t written;
+
+static atomic_bool async_running;
+static atomic_int producers;
+static atomic_bool consumer_sleeping;
+static atomic_bool stop_requested;
+static bool consumer_alive;
+static atomic_uint_fast64_t dropped;
+static uint64_t dropped_reported;
+
+// helper funcs
+
+static push_result_e async_push(glt_log_level_e level, const char *msg, va_list args);
+
+static bool ring_push(glt_log_level_e level, const char *msg, va_list args);
+
+static void *consumer_main(void *arg);
+
+static size_t drain(void);
+
+static void dispatch(glt_log_level_e level, const char *message);
+
+static void flush_outputs(void);
 
-    printf("[%s] ", level_names[level]);
+static size_t round_up_pow2(size_t n);
 
-    FILE *out = level == GLT_LOG_INFO || level == GLT_LOG_WARNING ? stdout : stderr;
+// public funcs
+
+void glt_log_write(glt_log_level_e level, const char *msg, ...) {
+    assert(level < GLT_LOG__COUNT);
 
     va_list args;
     va_start(args, msg);
-    vfprintf(out, msg, args);
-    va_end(args);
 
-    fprintf(out, "\n");
-    fflush(out);
+    push_result_e result = PUSH_SYNC;
+    if (level != GLT_LOG_FATAL) {
+        result = async_push(level, msg, args);
+    }
+
+    if (result == PUSH_SYNC) {
+        char message[GLT_LOG_MESSAGE_SIZE];
+        vsnprintf(message, sizeof(message), msg, args);
+
+        if (level == GLT_LOG_FATAL) {
+            // everything logged before goes out first
+            glt_log_flush();
+        }
+
+        pthread_mutex_lock(&sink_mutex);
+        dispatch(level, message);
+        flush_outputs();
+        pthread_mutex_unlock(&sink_mutex);
+    }
+
+    va_end(args);
 
     if (level == GLT_LOG_FATAL) {
         exit(EXIT_FAILURE);
     }
 }
+
+void glt_log_set_console(bool enabled) {
+    pthread_mutex_lock(&sink_mutex);
+    console_enabled = enabled;
+    pthread_mutex_unlock(&sink_mutex);
+}
+
+bool glt_log_set_file(const char *path) {
+    FILE *file = NULL;
+    if (path) {
+        file = fopen(path, "a");
+        if (!file) {
+            LOG_LOG(GLT_LOG_ERROR, "failed to open '%s'", path);
+            return false;
+        }
+    }
+
+    pthread_mutex_lock(&sink_mutex);
+    FILE *old = log_file;
+    log_file = file;
+    pthread_mutex_unlock(&sink_mutex);
+
+    if (old) {
+        fclose(old);
+    }
+
+    return true;
+}
+
+bool glt_log_add_sink(glt_log_sink_fn sink, void *user) {
+    if (!sink) {
+        return false;
+    }
+
+    pthread_mutex_lock(&sink_mutex);
+    bool added = sink_count < GLT_LOG_MAX_SINKS;
+    if (added) {
+        sinks[sink_count++] = (sink_t) {sink, user};
+    }
+    pthread_mutex_unlock(&sink_mutex);
+
+    if (!added) {
+        LOG_LOG(GLT_LOG_ERROR, "sink limit (%d) reached", GLT_LOG_MAX_SINKS);
+    }
+
+    return added;
+}
+
+void glt_log_remove_sink(glt_log_sink_fn sink, void *user) {
+    pthread_mutex_lock(&sink_mutex);
+    for (int i = 0; i < sink_count; ++i) {
+        if (sinks[i].fn == sink && sinks[i].user == user) {
+            for (int j = i + 1; j < sink_count; ++j) {
+                sinks[j - 1] = sinks[j];
+            }
+            --sink_count;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&sink_mutex);
+}
+
+bool glt_log_start_async(size_t capacity) {
+    pthread_mutex_lock(&lifecycle_mutex);
+
+    if (atomic_load(&async_running)) {
+        pthread_mutex_unlock(&lifecycle_mutex);
+        return true;
+    }
+
+    capacity = round_up_pow2(capacity == 0 ? DEFAULT_CAPACITY : capacity);
+
+    ring = malloc(capacity * sizeof(record_t));
+    if (!ring) {
+        pthread_mutex_unlock(&lifecycle_mutex);
+        LOG_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return false;
+    }
+
+    // positions keep counting from where the last run stopped, so flushes never go backwards
+    size_t base = atomic_load(&tail);
+    ring_mask = capacity - 1;
+    for (size_t i = 0; i < capacity; ++i) {
+        atomic_init(&ring[i].seq, base + ((i - base) & ring_mask));
+    }
+    head = base;
+
+    atomic_store(&stop_requested, false);
+    consumer_alive = true;
+
+    if (pthread_create(&consumer, NULL, consumer_main, NULL) != 0) {
+        consumer_alive = false;
+        free(ring);
+        ring = NULL;
+        pthread_mutex_unlock(&lifecycle_mutex);
+        LOG_LOG(GLT_LOG_ERROR, "failed to start the logging thread");
+        return false;
+    }
+
+    if (!atexit_registered) {
+        atexit(glt_log_stop_async);
+        atexit_registered = true;
+    }
+
+    atomic_store(&async_running, true);
+
+    pthread_mutex_unlock(&lifecycle_mutex);
+
+    return true;
+}
+
+void glt_log_stop_async(void) {
+    pthread_mutex_lock(&lifecycle_mutex);
+
+    if (!atomic_load(&async_running)) {
+        pthread_mutex_unlock(&lifecycle_mutex);
+        return;
+    }
+
+    // new messages go the synchronous way, the ring must outlive the pushes already in progress
+    atomic_store(&async_running, false);
+    while (atomic_load(&producers) > 0) {
+        sched_yield();
+    }
+
+    pthread_mutex_lock(&async_mutex);
+    atomic_store(&stop_requested, true);
+    pthread_cond_signal(&wake);
+    pthread_mutex_unlock(&async_mutex);
+
+    pthread_join(consumer, NULL);
+
+    free(ring);
+    ring = NULL;
+
+    pthread_mutex_unlock(&lifecycle_mutex);
+}
+
+void glt_log_flush(void) {
+    size_t target = atomic_load(&tail);
+
+    pthread_mutex_lock(&async_mutex);
+    if (consumer_alive) {
+        pthread_cond_signal(&wake);
+    }
+    while (consumer_alive && atomic_load(&written) < target) {
+        pthread_cond_wait(&drained, &async_mutex);
+    }
+    pthread_mutex_unlock(&async_mutex);
+
+    pthread_mutex_lock(&sink_mutex);
+    flush_outputs();
+    pthread_mutex_unlock(&sink_mutex);
+}
+
+uint64_t glt_log_get_dropped(void) {
+    return atomic_load(&dropped);
+}
+
+// helper funcs
+
+static push_result_e async_push(glt_log_level_e level, const char *msg, va_list args) {
+    // registered before checking, so glt_log_stop_async can wait for it before freeing the ring
+    atomic_fetch_add(&producers, 1);
+
+    push_result_e result = PUSH_SYNC;
+    if (atomic_load(&async_running)) {
+        if (ring_push(level, msg, args)) {
+            result = PUSH_QUEUED;
+            if (atomic_load(&consumer_sleeping)) {
+                pthread_cond_signal(&wake);
+            }
+        } else {
+            result = PUSH_DROPPED;
+            atomic_fetch_add(&dropped, 1);
+        }
+    }
+
+    atomic_fetch_sub(&producers, 1);
+
+    return result;
+}
+
+static bool ring_push(glt_log_level_e level, const char *msg, va_list args) {
+    size_t pos = atomic_load_explicit(&tail, memory_order_relaxed);
+    record_t *record;
+
+    for (;;) {
+        record = &ring[pos & ring_mask];
+        size_t seq = atomic_load_explicit(&record->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&tail, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // the consumer hasn't freed this slot yet, the ring is full
+            return false;
+        } else {
+            pos = atomic_load_explicit(&tail, memory_order_relaxed);
+        }
+    }
+
+    record->level = level;
+    vsnprintf(record->message, sizeof(record->message), msg, args);
+
+    atomic_store_explicit(&record->seq, pos + 1, memory_order_release);
+
+    return true;
+}
+
+static void *consumer_main(void *arg) {
+    (void) arg;
+
+    for (;;) {
+        // read before draining: once set, every producer has published and this drain sees it all
+        bool stop = atomic_load(&stop_requested);
+        size_t count = drain();
+
+        pthread_mutex_lock(&async_mutex);
+
+        atomic_store(&written, head);
+        pthread_cond_broadcast(&drained);
+
+        if (count == 0 && stop) {
+            consumer_alive = false;
+            pthread_cond_broadcast(&drained);
+            pthread_mutex_unlock(&async_mutex);
+            break;
+        }
+
+        if (count == 0) {
+            atomic_store(&consumer_sleeping, true);
+
+            record_t *next = &ring[head & ring_mask];
+            if (atomic_load_explicit(&next->seq, memory_order_acquire) != head + 1 &&
+                !atomic_load(&stop_requested)) {
+                struct timespec deadline;
+                clock_gettime(CLOCK_REALTIME, &deadline);
+                deadline.tv_nsec += CONSUMER_WAIT_NS;
+                if (deadline.tv_nsec >= 1000000000L) {
+                    deadline.tv_sec += 1;
+                    deadline.tv_nsec -= 1000000000L;
+                }
+                pthread_cond_timedwait(&wake, &async_mutex, &deadline);
+            }
+
+            atomic_store(&consumer_sleeping, false);
+        }
+
+        pthread_mutex_unlock(&async_mutex);
+    }
+
+    return NULL;
+}
+
+static size_t drain(void) {
+    size_t count = 0;
+
+    pthread_mutex_lock(&sink_mutex);
+
+    for (;;) {
+        record_t *record = &ring[head & ring_mask];
+        if (atomic_load_explicit(&record->seq, memory_order_acquire) != head + 1) {
+            break;
+        }
+
+        dispatch(record->level, record->message);
+
+        atomic_store_explicit(&record->seq, head + ring_mask + 1, memory_order_release);
+        ++head;
+        ++count;
+    }
+
+    uint64_t total_dropped = atomic_load(&dropped);
+    if (total_dropped != dropped_reported) {
+        char message[GLT_LOG_MESSAGE_SIZE];
+        snprintf(message, sizeof(message), LOG_PREFIX "%llu messages dropped, the ring is full",
+                 (unsigned long long) (total_dropped - dropped_reported));
+        dispatch(GLT_LOG_WARNING, message);
+        dropped_reported = total_dropped;
+        ++count;
+    }
+
+    // once per batch instead of once per message
+    if (count > 0) {
+        flush_outputs();
+    }
+
+    pthread_mutex_unlock(&sink_mutex);
+
+    return count;
+}
+
+static void dispatch(glt_log_level_e level, const char *message) {
+    if (console_enabled) {
+        // the prefix goes to the same stream as the message
+        FILE *out = level == GLT_LOG_INFO || level == GLT_LOG_WARNING ? stdout : stderr;
+        fprintf(out, "[%s] %s\n", level_names[level], message);
+    }
+
+    if (log_file) {
+        fprintf(log_file, "[%s] %s\n", level_names[level], message);
+    }
+
+    for (int i = 0; i < sink_count; ++i) {
+        sinks[i].fn(level, message, sinks[i].user);
+    }
+}
+
+static void flush_outputs(void) {
+    if (console_enabled) {
+        fflush(stdout);
+        fflush(stderr);
+    }
+    if (log_file) {
+        fflush(log_file);
+    }
+}
+
+static size_t round_up_pow2(size_t n) {
+    size_t pow2 = 2;
+    while (pow2 < n) {
+        pow2 <<= 1;
+    }
+    return pow2;
+}
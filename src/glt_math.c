@@ -1,5 +1,28 @@
 #include "glt_math.h"
 
+// glt_vec4_t arrays are only 4-byte aligned and AVX builds would want 32 for matrices
+#define CGLM_ALL_UNALIGNED
+#include "cglm/cglm.h"
+
+// cglm takes non-const arrays but only writes to dest
+#define MAT(p) ((vec4 *) (p)->m)
+#define QUAT(q) ((float *) &(q))
+
+// cglm has fused multiply-add but no plain multiply wrapper
+#if defined(CGLM_SIMD_x86)
+#define SIMD_MUL(a, b) _mm_mul_ps(a, b)
+#elif defined(CGLM_SIMD_ARM)
+#define SIMD_MUL(a, b) vmulq_f32(a, b)
+#elif defined(CGLM_SIMD_WASM)
+#define SIMD_MUL(a, b) wasm_f32x4_mul(a, b)
+#endif
+
+// helper funcs
+
+static void compose_trs(const glt_vec3_t *t, const glt_quat_t *r, const glt_vec3_t *s, glt_mat4_t *out);
+
+// public funcs
+
 float glt_clamp(float val, float min_val, float max_val) {
     if (val < min_val) {
         return min_val;
@@ -13,3 +36,180 @@ float glt_clamp(float val, float min_val, float max_val) {
 float glt_lepr(float a, float b, float t) {
     return a + (b - a) * t;
 }
+
+void glt_mat4_identity(glt_mat4_t *out) {
+    glm_mat4_identity(MAT(out));
+}
+
+void glt_mat4_mul(const glt_mat4_t *a, const glt_mat4_t *b, glt_mat4_t *out) {
+    glm_mat4_mul(MAT(a), MAT(b), MAT(out));
+}
+
+void glt_mat4_inverse(const glt_mat4_t *m, glt_mat4_t *out) {
+    glm_mat4_inv(MAT(m), MAT(out));
+}
+
+void glt_mat4_transpose(const glt_mat4_t *m, glt_mat4_t *out) {
+    if (m == out) {
+        glm_mat4_transpose(MAT(out));
+    } else {
+        glm_mat4_transpose_to(MAT(m), MAT(out));
+    }
+}
+
+void glt_mat4_from_trs(const glt_vec3_t *translation, const glt_quat_t *rotation, const glt_vec3_t *scale, glt_mat4_t *out) {
+    compose_trs(translation, rotation, scale, out);
+}
+
+void glt_mat4_perspective(float fovy, float aspect, float near_z, float far_z, glt_mat4_t *out) {
+    glm_perspective_rh_no(fovy, aspect, near_z, far_z, MAT(out));
+}
+
+void glt_mat4_look_at(const glt_vec3_t *eye, const glt_vec3_t *center, const glt_vec3_t *up, glt_mat4_t *out) {
+    vec3 e = {eye->x, eye->y, eye->z};
+    vec3 c = {center->x, center->y, center->z};
+    vec3 u = {up->x, up->y, up->z};
+    glm_lookat_rh(e, c, u, MAT(out));
+}
+
+glt_vec3_t glt_mat4_transform_point(const glt_mat4_t *m, glt_vec3_t point) {
+    glt_mat4_transform_points(m, &point, &point, 1);
+    return point;
+}
+
+glt_quat_t glt_quat_identity(void) {
+    return (glt_quat_t) {.x = 0.0f, .y = 0.0f, .z = 0.0f, .w = 1.0f};
+}
+
+glt_quat_t glt_quat_from_axis_angle(glt_vec3_t axis, float angle) {
+    glt_quat_t q;
+    vec3 a = {axis.x, axis.y, axis.z};
+    glm_quatv(QUAT(q), angle, a);
+    return q;
+}
+
+glt_quat_t glt_quat_mul(glt_quat_t a, glt_quat_t b) {
+    glt_quat_t q;
+    glm_quat_mul(QUAT(a), QUAT(b), QUAT(q));
+    return q;
+}
+
+glt_quat_t glt_quat_normalize(glt_quat_t q) {
+    glm_quat_normalize(QUAT(q));
+    return q;
+}
+
+glt_quat_t glt_quat_slerp(glt_quat_t a, glt_quat_t b, float t) {
+    glt_quat_t q;
+    glm_quat_slerp(QUAT(a), QUAT(b), t, QUAT(q));
+    return q;
+}
+
+void glt_quat_to_mat4(glt_quat_t q, glt_mat4_t *out) {
+    glm_quat_mat4(QUAT(q), MAT(out));
+}
+
+void glt_mat4_transform_points(const glt_mat4_t *m, const glt_vec3_t *in, glt_vec3_t *out, size_t count) {
+#ifdef CGLM_SIMD
+    const glmm_128 c0 = glmm_load(m->m[0]);
+    const glmm_128 c1 = glmm_load(m->m[1]);
+    const glmm_128 c2 = glmm_load(m->m[2]);
+    const glmm_128 c3 = glmm_load(m->m[3]);
+    CGLM_ALIGN(16) float r[4];
+
+    for (size_t i = 0; i < count; ++i) {
+        float x = in[i].x, y = in[i].y, z = in[i].z;
+        glmm_128 v = glmm_fmadd(glmm_set1(x), c0, c3);
+        v = glmm_fmadd(glmm_set1(y), c1, v);
+        v = glmm_fmadd(glmm_set1(z), c2, v);
+        glmm_store(r, v);
+        out[i] = (glt_vec3_t) {r[0], r[1], r[2]};
+    }
+#else
+    const float (*c)[4] = m->m;
+    for (size_t i = 0; i < count; ++i) {
+        const float x = in[i].x, y = in[i].y, z = in[i].z;
+        out[i].x = c[0][0] * x + c[1][0] * y + c[2][0] * z + c[3][0];
+        out[i].y = c[0][1] * x + c[1][1] * y + c[2][1] * z + c[3][1];
+        out[i].z = c[0][2] * x + c[1][2] * y + c[2][2] * z + c[3][2];
+    }
+#endif
+}
+
+void glt_mat4_transform_vec4s(const glt_mat4_t *m, const glt_vec4_t *in, glt_vec4_t *out, size_t count) {
+#ifdef CGLM_SIMD
+    const glmm_128 c0 = glmm_load(m->m[0]);
+    const glmm_128 c1 = glmm_load(m->m[1]);
+    const glmm_128 c2 = glmm_load(m->m[2]);
+    const glmm_128 c3 = glmm_load(m->m[3]);
+
+    for (size_t i = 0; i < count; ++i) {
+        const glmm_128 p = glmm_load(&in[i].x);
+        glmm_128 v = SIMD_MUL(glmm_splat_x(p), c0);
+        v = glmm_fmadd(glmm_splat_y(p), c1, v);
+        v = glmm_fmadd(glmm_splat_z(p), c2, v);
+        v = glmm_fmadd(glmm_splat_w(p), c3, v);
+        glmm_store(&out[i].x, v);
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        vec4 v = {in[i].x, in[i].y, in[i].z, in[i].w};
+        glm_mat4_mulv(MAT(m), v, v);
+        out[i] = (glt_vec4_t) {v[0], v[1], v[2], v[3]};
+    }
+#endif
+}
+
+void glt_mat4_mul_array(const glt_mat4_t *a, const glt_mat4_t *b, glt_mat4_t *out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        glm_mat4_mul(MAT(&a[i]), MAT(&b[i]), MAT(&out[i]));
+    }
+}
+
+void glt_mat4_premul_array(const glt_mat4_t *a, const glt_mat4_t *b, glt_mat4_t *out, size_t count) {
+#ifdef CGLM_SIMD
+    const glmm_128 c0 = glmm_load(a->m[0]);
+    const glmm_128 c1 = glmm_load(a->m[1]);
+    const glmm_128 c2 = glmm_load(a->m[2]);
+    const glmm_128 c3 = glmm_load(a->m[3]);
+
+    for (size_t i = 0; i < count; ++i) {
+        for (int col = 0; col < 4; ++col) {
+            const glmm_128 p = glmm_load(b[i].m[col]);
+            glmm_128 v = SIMD_MUL(glmm_splat_x(p), c0);
+            v = glmm_fmadd(glmm_splat_y(p), c1, v);
+            v = glmm_fmadd(glmm_splat_z(p), c2, v);
+            v = glmm_fmadd(glmm_splat_w(p), c3, v);
+            glmm_store(out[i].m[col], v);
+        }
+    }
+#else
+    glt_mat4_t left = *a;
+    for (size_t i = 0; i < count; ++i) {
+        glm_mat4_mul(MAT(&left), MAT(&b[i]), MAT(&out[i]));
+    }
+#endif
+}
+
+void glt_mat4_compose_trs_array(
+    const glt_vec3_t *translation, const glt_quat_t *rotation, const glt_vec3_t *scale, glt_mat4_t *out, size_t count
+) {
+    static const glt_vec3_t unit = {1.0f, 1.0f, 1.0f};
+    for (size_t i = 0; i < count; ++i) {
+        compose_trs(&translation[i], &rotation[i], scale ? &scale[i] : &unit, &out[i]);
+    }
+}
+
+// helper funcs
+
+static void compose_trs(const glt_vec3_t *t, const glt_quat_t *r, const glt_vec3_t *s, glt_mat4_t *out) {
+    // the rotation's columns scaled by s, the translation as the last column
+    glm_quat_mat4(QUAT(*r), MAT(out));
+    glm_vec4_scale(out->m[0], s->x, out->m[0]);
+    glm_vec4_scale(out->m[1], s->y, out->m[1]);
+    glm_vec4_scale(out->m[2], s->z, out->m[2]);
+    out->m[3][0] = t->x;
+    out->m[3][1] = t->y;
+    out->m[3][2] = t->z;
+    out->m[3][3] = 1.0f;
+}
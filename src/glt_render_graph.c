@@ -0,0 +1,837 @@
+#include "glt_render_graph.h"
+#include "glt_texture_internal.h"
+#include "glt_stats.h"
+#include "glt_trace.h"
+#include "glt_debug.h"
+#include "glt_log.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RENDER_GRAPH_LOG(level, msg, ...)    glt_log(level, "[RENDER GRAPH]: " msg, ##__VA_ARGS__)
+
+// frames storage may sit unused before it is deleted
+#define MAX_IDLE_FRAMES 2
+
+// color attachments then depth
+#define MAX_TARGETS (GLT_FRAMEBUFFER_MAX_COLOR + 1)
+
+typedef enum {
+    RESOURCE_TEXTURE = 0,
+    RESOURCE_BUFFER
+} resource_kind_e;
+
+typedef struct {
+    glt_rg_pass_t pass;
+    glt_rg_resource_t resource;
+    glt_rg_usage_e usage;
+    bool write;
+} access_t;
+
+typedef struct {
+    const char *name;
+    glt_rg_pass_type_e type;
+    glt_rg_execute_fn execute;
+    void *user;
+    bool side_effects;
+    bool culled;
+} pass_t;
+
+typedef struct {
+    const char *name;
+    resource_kind_e kind;
+    bool imported;
+    glt_rg_texture_desc_t desc;
+    GLsizeiptr size;
+    const glt_texture_t *texture;
+    GLuint buffer;
+
+    // transient only: storage index and the resource that held it before, both -1 if none
+    int storage;
+    glt_rg_resource_t aliased;
+    // first and last live pass using it, -1 if none
+    int first_use;
+    int last_use;
+    bool needed;
+
+    // written by image / storage stores, visible so far only for the synced barrier bits
+    bool unsynced;
+    GLbitfield synced;
+} resource_t;
+
+typedef struct {
+    resource_kind_e kind;
+    glt_rg_texture_desc_t desc;
+    GLsizeiptr size;
+    glt_texture_t *texture;
+    GLuint buffer;
+    size_t bytes;
+
+    // resource holding it at this point of the assignment, last one once it's done
+    glt_rg_resource_t owner;
+    bool busy;
+    unsigned idle_frames;
+    // carried over from the last owner of the previous frame
+    bool unsynced;
+    GLbitfield synced;
+} storage_t;
+
+// kept per pass index across frames, so a steady graph never reattaches
+typedef struct {
+    GLuint fbo;
+    GLuint attached[MAX_TARGETS];
+} pass_fbo_t;
+
+typedef struct {
+    glt_rg_resource_t resources[MAX_TARGETS];
+    GLenum points[MAX_TARGETS];
+    int count;
+} pass_targets_t;
+
+struct glt_render_graph_t {
+    pass_t *passes;
+    int pass_count;
+    int pass_capacity;
+
+    resource_t *resources;
+    int resource_count;
+    int resource_capacity;
+
+    access_t *accesses;
+    int access_count;
+    int access_capacity;
+
+    storage_t *storage;
+    int storage_count;
+    int storage_capacity;
+
+    pass_fbo_t *fbos;
+    int fbo_count;
+    int fbo_capacity;
+
+    size_t culled;
+    size_t barriers;
+};
+
+static const GLbitfield barrier_bits[GLT_RG_USAGE__COUNT] = {
+    GL_TEXTURE_FETCH_BARRIER_BIT,
+    GL_FRAMEBUFFER_BARRIER_BIT,
+    GL_FRAMEBUFFER_BARRIER_BIT,
+    GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+    GL_SHADER_STORAGE_BARRIER_BIT,
+    GL_UNIFORM_BARRIER_BIT,
+    GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT,
+    GL_ELEMENT_ARRAY_BARRIER_BIT,
+    GL_COMMAND_BARRIER_BIT,
+    GL_BUFFER_UPDATE_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT
+};
+
+static const char *usage_names[GLT_RG_USAGE__COUNT] = {
+    "sampled",
+    "color attachment",
+    "depth attachment",
+    "storage image",
+    "storage buffer",
+    "uniform buffer",
+    "vertex buffer",
+    "index buffer",
+    "indirect buffer",
+    "transfer"
+};
+
+// helper funcs
+
+static bool reserve(void **items, int *capacity, int needed, size_t item_size);
+
+static resource_t *add_resource(glt_render_graph_t *graph, const char *name, resource_kind_e kind);
+
+static void add_access(glt_render_graph_t *graph, glt_rg_pass_t pass, glt_rg_resource_t resource, glt_rg_usage_e usage, bool write);
+
+static void cull(glt_render_graph_t *graph);
+
+static bool assign_storage(glt_render_graph_t *graph);
+
+static int acquire_storage(glt_render_graph_t *graph, glt_rg_resource_t resource);
+
+static void destroy_storage(storage_t *storage);
+
+static void detach_texture(glt_render_graph_t *graph, GLuint id);
+
+static void insert_barriers(glt_render_graph_t *graph, glt_rg_pass_t pass);
+
+static bool bind_targets(glt_render_graph_t *graph, glt_rg_pass_t pass, pass_targets_t *targets);
+
+static void invalidate_targets(const glt_render_graph_t *graph, glt_rg_pass_t pass, const pass_targets_t *targets, bool first_use);
+
+// public funcs
+
+glt_render_graph_t *glt_render_graph_create(void) {
+    glt_render_graph_t *graph = calloc(1, sizeof(glt_render_graph_t));
+    if (!graph) {
+        RENDER_GRAPH_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+    return graph;
+}
+
+void glt_render_graph_destroy(glt_render_graph_t *graph) {
+    if (!graph) {
+        return;
+    }
+    for (int i = 0; i < graph->storage_count; ++i) {
+        destroy_storage(&graph->storage[i]);
+    }
+    for (int i = 0; i < graph->fbo_count; ++i) {
+        if (graph->fbos[i].fbo) {
+            glDeleteFramebuffers(1, &graph->fbos[i].fbo);
+            glt_stats_track_resource(GLT_RESOURCE_FRAMEBUFFER, -1, 0);
+        }
+    }
+    free(graph->passes);
+    free(graph->resources);
+    free(graph->accesses);
+    free(graph->storage);
+    free(graph->fbos);
+    free(graph);
+}
+
+void glt_render_graph_reset(glt_render_graph_t *graph) {
+    if (!graph) {
+        return;
+    }
+
+    int kept = 0;
+    for (int i = 0; i < graph->storage_count; ++i) {
+        storage_t *storage = &graph->storage[i];
+        if (storage->owner >= 0) {
+            const resource_t *owner = &graph->resources[storage->owner];
+            storage->unsynced = owner->unsynced;
+            storage->synced = owner->synced;
+        }
+        storage->owner = -1;
+        storage->busy = false;
+
+        if (++storage->idle_frames > MAX_IDLE_FRAMES) {
+            detach_texture(graph, glt_texture_get_id(storage->texture));
+            destroy_storage(storage);
+            continue;
+        }
+        graph->storage[kept++] = *storage;
+    }
+    graph->storage_count = kept;
+
+    graph->pass_count = 0;
+    graph->resource_count = 0;
+    graph->access_count = 0;
+}
+
+glt_rg_resource_t glt_render_graph_create_texture(glt_render_graph_t *graph, const char *name, const glt_rg_texture_desc_t *desc) {
+    if (!graph || !desc || desc->width <= 0 || desc->height <= 0 || !desc->format) {
+        RENDER_GRAPH_LOG(GLT_LOG_ERROR, "invalid texture desc for '%s'", name ? name : "?");
+        return -1;
+    }
+    resource_t *resource = add_resource(graph, name, RESOURCE_TEXTURE);
+    if (!resource) {
+        return -1;
+    }
+    resource->desc = *desc;
+    return graph->resource_count - 1;
+}
+
+glt_rg_resource_t glt_render_graph_create_buffer(glt_render_graph_t *graph, const char *name, GLsizeiptr size) {
+    if (!graph || size <= 0) {
+        RENDER_GRAPH_LOG(GLT_LOG_ERROR, "invalid buffer size for '%s'", name ? name : "?");
+        return -1;
+    }
+    resource_t *resource = add_resource(graph, name, RESOURCE_BUFFER);
+    if (!resource) {
+        return -1;
+    }
+    resource->size = size;
+    return graph->resource_count - 1;
+}
+
+glt_rg_resource_t glt_render_graph_import_texture(glt_render_graph_t *graph, const char *name, const glt_texture_t *texture) {
+    if (!graph || !texture) {
+        return -1;
+    }
+    resource_t *resource = add_resource(graph, name, RESOURCE_TEXTURE);
+    if (!resource) {
+        return -1;
+    }
+    resource->imported = true;
+    resource->texture = texture;
+    resource->desc.width = glt_texture_get_width(texture);
+    resource->desc.height = glt_texture_get_height(texture);
+    return graph->resource_count - 1;
+}
+
+glt_rg_resource_t glt_render_graph_import_buffer(glt_render_graph_t *graph, const char *name, GLuint buffer) {
+    if (!graph || !buffer) {
+        return -1;
+    }
+    resource_t *resource = add_resource(graph, name, RESOURCE_BUFFER);
+    if (!resource) {
+        return -1;
+    }
+    resource->imported = true;
+    resource->buffer = buffer;
+    return graph->resource_count - 1;
+}
+
+glt_rg_pass_t glt_render_graph_add_pass(
+    glt_render_graph_t *graph, const char *name, glt_rg_pass_type_e type, glt_rg_execute_fn execute, void *user
+) {
+    if (!graph || !execute || type >= GLT_RG_PASS__COUNT) {
+        return -1;
+    }
+    if (!reserve((void **) &graph->passes, &graph->pass_capacity, graph->pass_count + 1, sizeof(pass_t))) {
+        return -1;
+    }
+    pass_t *pass = &graph->passes[graph->pass_count];
+    memset(pass, 0, sizeof(pass_t));
+    pass->name = name ? name : "pass";
+    pass->type = type;
+    pass->execute = execute;
+    pass->user = user;
+    return graph->pass_count++;
+}
+
+void glt_render_graph_read(glt_render_graph_t *graph, glt_rg_pass_t pass, glt_rg_resource_t resource, glt_rg_usage_e usage) {
+    add_access(graph, pass, resource, usage, false);
+}
+
+void glt_render_graph_write(glt_render_graph_t *graph, glt_rg_pass_t pass, glt_rg_resource_t resource, glt_rg_usage_e usage) {
+    add_access(graph, pass, resource, usage, true);
+}
+
+void glt_render_graph_set_side_effects(glt_render_graph_t *graph, glt_rg_pass_t pass) {
+    if (graph && pass >= 0 && pass < graph->pass_count) {
+        graph->passes[pass].side_effects = true;
+    }
+}
+
+bool glt_render_graph_execute(glt_render_graph_t *graph) {
+    if (!graph) {
+        return false;
+    }
+    GLT_ZONE("glt_render_graph_execute");
+
+    cull(graph);
+    if (!assign_storage(graph)) {
+        return false;
+    }
+
+    GLint prev_fbo = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prev_fbo);
+    graph->barriers = 0;
+
+    for (glt_rg_pass_t p = 0; p < graph->pass_count; ++p) {
+        const pass_t *pass = &graph->passes[p];
+        if (pass->culled) {
+            continue;
+        }
+        // pass names only outlive the frame, the trace is written later
+        GLT_ZONE_BEGIN(zone, glt_trace_intern(pass->name));
+        glt_debug_push_group(pass->name);
+
+        // a resource picks up the pending stores of whatever held its storage before
+        for (int i = 0; i < graph->access_count; ++i) {
+            const access_t *access = &graph->accesses[i];
+            resource_t *resource = &graph->resources[access->resource];
+            if (access->pass != p || resource->imported || resource->first_use != p) {
+                continue;
+            }
+            if (resource->aliased >= 0) {
+                resource->unsynced = graph->resources[resource->aliased].unsynced;
+                resource->synced = graph->resources[resource->aliased].synced;
+            } else {
+                resource->unsynced = graph->storage[resource->storage].unsynced;
+                resource->synced = graph->storage[resource->storage].synced;
+            }
+        }
+        insert_barriers(graph, p);
+
+        pass_targets_t targets = {0};
+        if (pass->type == GLT_RG_PASS_RASTER && bind_targets(graph, p, &targets)) {
+            invalidate_targets(graph, p, &targets, true);
+            pass->execute(graph, pass->user);
+            invalidate_targets(graph, p, &targets, false);
+        } else {
+            glBindFramebuffer(GL_FRAMEBUFFER, (GLuint) prev_fbo);
+            pass->execute(graph, pass->user);
+        }
+
+        for (int i = 0; i < graph->access_count; ++i) {
+            const access_t *access = &graph->accesses[i];
+            if (access->pass == p && access->write
+                && (access->usage == GLT_RG_USAGE_STORAGE_IMAGE || access->usage == GLT_RG_USAGE_STORAGE_BUFFER)) {
+                graph->resources[access->resource].unsynced = true;
+                graph->resources[access->resource].synced = 0;
+            }
+        }
+        glt_debug_pop_group();
+        GLT_ZONE_END(zone);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint) prev_fbo);
+    return true;
+}
+
+const glt_texture_t *glt_render_graph_get_texture(const glt_render_graph_t *graph, glt_rg_resource_t resource) {
+    if (!graph || resource < 0 || resource >= graph->resource_count) {
+        return NULL;
+    }
+    return graph->resources[resource].texture;
+}
+
+GLuint glt_render_graph_get_buffer(const glt_render_graph_t *graph, glt_rg_resource_t resource) {
+    if (!graph || resource < 0 || resource >= graph->resource_count) {
+        return 0;
+    }
+    return graph->resources[resource].buffer;
+}
+
+void glt_render_graph_get_info(const glt_render_graph_t *graph, glt_render_graph_info_t *info) {
+    if (!info) {
+        return;
+    }
+    memset(info, 0, sizeof(glt_render_graph_info_t));
+    if (!graph) {
+        return;
+    }
+    info->passes = (size_t) graph->pass_count;
+    info->culled_passes = graph->culled;
+    info->resources = (size_t) graph->resource_count;
+    info->barriers = graph->barriers;
+    for (int i = 0; i < graph->storage_count; ++i) {
+        const storage_t *storage = &graph->storage[i];
+        if (storage->kind == RESOURCE_TEXTURE) {
+            info->textures++;
+        } else {
+            info->buffers++;
+        }
+        info->memory_size += storage->bytes;
+    }
+}
+
+void glt_render_graph_print(const glt_render_graph_t *graph, FILE *out) {
+    if (!graph || !out) {
+        return;
+    }
+
+    fprintf(out, "---------------- Render graph ----------------\n");
+    for (glt_rg_pass_t p = 0; p < graph->pass_count; ++p) {
+        const pass_t *pass = &graph->passes[p];
+        fprintf(
+            out, "pass %2d %-24s %-8s %s\n", p, pass->name,
+            pass->type == GLT_RG_PASS_COMPUTE ? "compute" : "raster", pass->culled ? "culled" : "live"
+        );
+        for (int i = 0; i < graph->access_count; ++i) {
+            const access_t *access = &graph->accesses[i];
+            if (access->pass == p) {
+                fprintf(
+                    out, "    %-5s %-24s %s\n", access->write ? "write" : "read",
+                    graph->resources[access->resource].name, usage_names[access->usage]
+                );
+            }
+        }
+    }
+    fprintf(out, "---------------- Resources -------------------\n");
+    for (int r = 0; r < graph->resource_count; ++r) {
+        const resource_t *resource = &graph->resources[r];
+        if (resource->first_use < 0) {
+            fprintf(out, "%-28s unused\n", resource->name);
+        } else if (resource->imported) {
+            fprintf(out, "%-28s passes %d-%d, imported\n", resource->name, resource->first_use, resource->last_use);
+        } else {
+            fprintf(
+                out, "%-28s passes %d-%d, storage %d\n", resource->name, resource->first_use, resource->last_use,
+                resource->storage
+            );
+        }
+    }
+    glt_render_graph_info_t info;
+    glt_render_graph_get_info(graph, &info);
+    fprintf(
+        out, "%zu textures, %zu buffers (%.2f MiB), %zu barriers\n", info.textures, info.buffers,
+        (double) info.memory_size / (1024.0 * 1024.0), info.barriers
+    );
+    fprintf(out, "----------------------------------------------\n");
+}
+
+// helper funcs
+
+static bool reserve(void **items, int *capacity, int needed, size_t item_size) {
+    if (needed <= *capacity) {
+        return true;
+    }
+    int cap = *capacity ? *capacity * 2 : 16;
+    while (cap < needed) {
+        cap *= 2;
+    }
+    void *grown = realloc(*items, (size_t) cap * item_size);
+    if (!grown) {
+        RENDER_GRAPH_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return false;
+    }
+    *items = grown;
+    *capacity = cap;
+    return true;
+}
+
+static resource_t *add_resource(glt_render_graph_t *graph, const char *name, resource_kind_e kind) {
+    if (!reserve((void **) &graph->resources, &graph->resource_capacity, graph->resource_count + 1, sizeof(resource_t))) {
+        return NULL;
+    }
+    resource_t *resource = &graph->resources[graph->resource_count++];
+    memset(resource, 0, sizeof(resource_t));
+    resource->name = name ? name : "resource";
+    resource->kind = kind;
+    resource->storage = -1;
+    resource->aliased = -1;
+    resource->first_use = -1;
+    resource->last_use = -1;
+    return resource;
+}
+
+static void add_access(glt_render_graph_t *graph, glt_rg_pass_t pass, glt_rg_resource_t resource, glt_rg_usage_e usage, bool write) {
+    if (!graph || pass < 0 || pass >= graph->pass_count || resource < 0 || resource >= graph->resource_count
+        || usage >= GLT_RG_USAGE__COUNT) {
+        RENDER_GRAPH_LOG(GLT_LOG_ERROR, "invalid pass, resource or usage");
+        return;
+    }
+    if (!reserve((void **) &graph->accesses, &graph->access_capacity, graph->access_count + 1, sizeof(access_t))) {
+        return;
+    }
+    graph->accesses[graph->access_count++] = (access_t) {pass, resource, usage, write};
+}
+
+static void cull(glt_render_graph_t *graph) {
+    for (int r = 0; r < graph->resource_count; ++r) {
+        resource_t *resource = &graph->resources[r];
+        resource->needed = resource->imported;
+        if (!resource->imported) {
+            resource->texture = NULL;
+            resource->buffer = 0;
+            resource->storage = -1;
+            resource->aliased = -1;
+        }
+        resource->first_use = -1;
+        resource->last_use = -1;
+        resource->unsynced = false;
+        resource->synced = 0;
+    }
+
+    // backwards: a pass lives if it writes something a live pass or the outside reads
+    graph->culled = 0;
+    for (glt_rg_pass_t p = graph->pass_count - 1; p >= 0; --p) {
+        pass_t *pass = &graph->passes[p];
+        bool live = pass->side_effects;
+        for (int i = 0; i < graph->access_count && !live; ++i) {
+            const access_t *access = &graph->accesses[i];
+            live = access->pass == p && access->write && graph->resources[access->resource].needed;
+        }
+
+        pass->culled = !live;
+        if (!live) {
+            graph->culled++;
+            continue;
+        }
+        for (int i = 0; i < graph->access_count; ++i) {
+            const access_t *access = &graph->accesses[i];
+            if (access->pass == p && !access->write) {
+                graph->resources[access->resource].needed = true;
+            }
+        }
+    }
+
+    for (int i = 0; i < graph->access_count; ++i) {
+        const access_t *access = &graph->accesses[i];
+        if (graph->passes[access->pass].culled) {
+            continue;
+        }
+        resource_t *resource = &graph->resources[access->resource];
+        if (resource->first_use < 0 || access->pass < resource->first_use) {
+            resource->first_use = access->pass;
+        }
+        if (access->pass > resource->last_use) {
+            resource->last_use = access->pass;
+        }
+    }
+}
+
+static bool assign_storage(glt_render_graph_t *graph) {
+    for (int i = 0; i < graph->storage_count; ++i) {
+        graph->storage[i].busy = false;
+        graph->storage[i].owner = -1;
+    }
+
+    for (glt_rg_pass_t p = 0; p < graph->pass_count; ++p) {
+        if (graph->passes[p].culled) {
+            continue;
+        }
+        // everything the pass touches is acquired before any of it is released, so resources
+        // of the same pass never alias
+        for (int i = 0; i < graph->access_count; ++i) {
+            const access_t *access = &graph->accesses[i];
+            resource_t *resource = &graph->resources[access->resource];
+            if (access->pass != p || resource->imported || resource->first_use != p || resource->storage >= 0) {
+                continue;
+            }
+            resource->storage = acquire_storage(graph, access->resource);
+            if (resource->storage < 0) {
+                return false;
+            }
+        }
+        for (int i = 0; i < graph->access_count; ++i) {
+            const access_t *access = &graph->accesses[i];
+            const resource_t *resource = &graph->resources[access->resource];
+            if (access->pass == p && !resource->imported && resource->last_use == p) {
+                graph->storage[resource->storage].busy = false;
+            }
+        }
+    }
+    return true;
+}
+
+static int acquire_storage(glt_render_graph_t *graph, glt_rg_resource_t r) {
+    resource_t *resource = &graph->resources[r];
+    int index = -1;
+    for (int i = 0; i < graph->storage_count && index < 0; ++i) {
+        const storage_t *storage = &graph->storage[i];
+        if (storage->busy || storage->kind != resource->kind) {
+            continue;
+        }
+        if (resource->kind == RESOURCE_TEXTURE
+                ? storage->desc.width == resource->desc.width && storage->desc.height == resource->desc.height
+                      && storage->desc.format == resource->desc.format
+                : storage->size == resource->size) {
+            index = i;
+        }
+    }
+
+    if (index < 0) {
+        if (!reserve((void **) &graph->storage, &graph->storage_capacity, graph->storage_count + 1, sizeof(storage_t))) {
+            return -1;
+        }
+        storage_t *storage = &graph->storage[graph->storage_count];
+        memset(storage, 0, sizeof(storage_t));
+        storage->kind = resource->kind;
+        storage->owner = -1;
+
+        if (resource->kind == RESOURCE_TEXTURE) {
+            storage->desc = resource->desc;
+            storage->texture = glt_texture_create_render_target(resource->desc.format, resource->desc.width, resource->desc.height);
+            if (!storage->texture) {
+                RENDER_GRAPH_LOG(GLT_LOG_ERROR, "failed to create texture for '%s'", resource->name);
+                return -1;
+            }
+            storage->bytes = glt_texture_get_memory_size(storage->texture);
+            // named after the first resource it holds, aliasing hands it on to others later
+            glt_debug_label(GL_TEXTURE, glt_texture_get_id(storage->texture), resource->name);
+        } else {
+            storage->size = resource->size;
+            storage->bytes = (size_t) resource->size;
+            glGenBuffers(1, &storage->buffer);
+            if (!storage->buffer) {
+                RENDER_GRAPH_LOG(GLT_LOG_ERROR, "failed to create buffer for '%s'", resource->name);
+                return -1;
+            }
+            glBindBuffer(GL_COPY_WRITE_BUFFER, storage->buffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, resource->size, NULL, GL_DYNAMIC_COPY);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            glt_debug_label(GL_BUFFER, storage->buffer, resource->name);
+            glt_stats_track_resource(GLT_RESOURCE_BUFFER, 1, (int64_t) storage->bytes);
+        }
+        index = graph->storage_count++;
+    }
+
+    storage_t *storage = &graph->storage[index];
+    storage->busy = true;
+    storage->idle_frames = 0;
+    resource->aliased = storage->owner;
+    storage->owner = r;
+    resource->texture = storage->texture;
+    resource->buffer = storage->buffer;
+    return index;
+}
+
+static void destroy_storage(storage_t *storage) {
+    if (storage->texture) {
+        glt_texture_destroy(storage->texture);
+        storage->texture = NULL;
+    }
+    if (storage->buffer) {
+        glDeleteBuffers(1, &storage->buffer);
+        glt_stats_track_resource(GLT_RESOURCE_BUFFER, -1, -(int64_t) storage->bytes);
+        storage->buffer = 0;
+    }
+}
+
+static void detach_texture(glt_render_graph_t *graph, GLuint id) {
+    if (!id) {
+        return;
+    }
+    // a new texture may get the same name, so the fbos must not keep it or compare equal to it
+    GLint prev_draw = 0;
+    bool bound = false;
+    for (int i = 0; i < graph->fbo_count; ++i) {
+        pass_fbo_t *fbo = &graph->fbos[i];
+        for (int a = 0; a < MAX_TARGETS; ++a) {
+            if (fbo->attached[a] != id) {
+                continue;
+            }
+            if (!bound) {
+                glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prev_draw);
+                bound = true;
+            }
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo->fbo);
+            const GLenum point = a < GLT_FRAMEBUFFER_MAX_COLOR ? GL_COLOR_ATTACHMENT0 + (GLenum) a : GL_DEPTH_STENCIL_ATTACHMENT;
+            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, point, GL_TEXTURE_2D, 0, 0);
+            fbo->attached[a] = 0;
+        }
+    }
+    if (bound) {
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint) prev_draw);
+    }
+}
+
+static void insert_barriers(glt_render_graph_t *graph, glt_rg_pass_t pass) {
+    GLbitfield bits = 0;
+    for (int i = 0; i < graph->access_count; ++i) {
+        const access_t *access = &graph->accesses[i];
+        const resource_t *resource = &graph->resources[access->resource];
+        if (access->pass == pass && resource->unsynced) {
+            bits |= barrier_bits[access->usage] & ~resource->synced;
+        }
+    }
+    // image load / store and storage buffers need GL 4.2+, without them nothing is ever unsynced
+    if (!bits || !glMemoryBarrier) {
+        return;
+    }
+
+    glMemoryBarrier(bits);
+    graph->barriers++;
+    // barriers are global, they cover every outstanding store
+    for (int r = 0; r < graph->resource_count; ++r) {
+        if (graph->resources[r].unsynced) {
+            graph->resources[r].synced |= bits;
+        }
+    }
+}
+
+static bool bind_targets(glt_render_graph_t *graph, glt_rg_pass_t pass, pass_targets_t *targets) {
+    GLuint ids[MAX_TARGETS] = {0};
+    int colors = 0;
+    glt_rg_resource_t depth = -1;
+    glt_rg_resource_t first = -1;
+
+    for (int i = 0; i < graph->access_count; ++i) {
+        const access_t *access = &graph->accesses[i];
+        if (access->pass != pass) {
+            continue;
+        }
+        const resource_t *resource = &graph->resources[access->resource];
+        const GLuint id = glt_texture_get_id(resource->texture);
+        if (access->usage == GLT_RG_USAGE_DEPTH_ATTACHMENT) {
+            depth = access->resource;
+            ids[GLT_FRAMEBUFFER_MAX_COLOR] = id;
+        } else if (access->usage == GLT_RG_USAGE_COLOR_ATTACHMENT) {
+            bool seen = false;
+            for (int c = 0; c < colors; ++c) {
+                seen = seen || targets->resources[c] == access->resource;
+            }
+            if (seen) {
+                continue;
+            }
+            if (colors == GLT_FRAMEBUFFER_MAX_COLOR) {
+                RENDER_GRAPH_LOG(GLT_LOG_WARNING, "pass '%s' has too many color attachments", graph->passes[pass].name);
+                continue;
+            }
+            targets->resources[colors] = access->resource;
+            targets->points[colors] = GL_COLOR_ATTACHMENT0 + colors;
+            ids[colors++] = id;
+        } else {
+            continue;
+        }
+        if (first < 0) {
+            first = access->resource;
+        }
+    }
+    if (first < 0) {
+        return false;
+    }
+
+    targets->count = colors;
+    if (depth >= 0) {
+        // imported depth textures carry no format and attach as depth only
+        targets->resources[targets->count] = depth;
+        targets->points[targets->count] = glt_texture_depth_attachment_point(graph->resources[depth].desc.format);
+        targets->count++;
+    }
+
+    if (pass >= graph->fbo_count) {
+        if (!reserve((void **) &graph->fbos, &graph->fbo_capacity, pass + 1, sizeof(pass_fbo_t))) {
+            return false;
+        }
+        memset(&graph->fbos[graph->fbo_count], 0, (size_t) (pass + 1 - graph->fbo_count) * sizeof(pass_fbo_t));
+        graph->fbo_count = pass + 1;
+    }
+    pass_fbo_t *fbo = &graph->fbos[pass];
+    if (!fbo->fbo) {
+        glGenFramebuffers(1, &fbo->fbo);
+        glt_stats_track_resource(GLT_RESOURCE_FRAMEBUFFER, 1, 0);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo->fbo);
+
+    if (memcmp(fbo->attached, ids, sizeof(ids)) != 0) {
+        GLenum buffers[GLT_FRAMEBUFFER_MAX_COLOR];
+        for (int c = 0; c < GLT_FRAMEBUFFER_MAX_COLOR; ++c) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + c, GL_TEXTURE_2D, ids[c], 0);
+            buffers[c] = GL_COLOR_ATTACHMENT0 + c;
+        }
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, 0, 0);
+        if (depth >= 0) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, targets->points[colors], GL_TEXTURE_2D, ids[GLT_FRAMEBUFFER_MAX_COLOR], 0);
+        }
+        if (colors > 0) {
+            glDrawBuffers(colors, buffers);
+            glReadBuffer(GL_COLOR_ATTACHMENT0);
+        } else {
+            glDrawBuffer(GL_NONE);
+            glReadBuffer(GL_NONE);
+        }
+
+        const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            RENDER_GRAPH_LOG(GLT_LOG_ERROR, "pass '%s' has an incomplete framebuffer (0x%x)", graph->passes[pass].name, status);
+            memset(fbo->attached, 0, sizeof(fbo->attached));
+            return false;
+        }
+        memcpy(fbo->attached, ids, sizeof(ids));
+    }
+
+    const resource_t *sized = &graph->resources[first];
+    glViewport(0, 0, sized->desc.width, sized->desc.height);
+    return true;
+}
+
+static void invalidate_targets(const glt_render_graph_t *graph, glt_rg_pass_t pass, const pass_targets_t *targets, bool first_use) {
+    if (!glInvalidateFramebuffer) {
+        return;
+    }
+    // transient contents are undefined before their first use and dead after their last
+    GLenum points[MAX_TARGETS];
+    GLsizei count = 0;
+    for (int i = 0; i < targets->count; ++i) {
+        const resource_t *resource = &graph->resources[targets->resources[i]];
+        if (!resource->imported && (first_use ? resource->first_use : resource->last_use) == pass) {
+            points[count++] = targets->points[i];
+        }
+    }
+    if (count > 0) {
+        glInvalidateFramebuffer(GL_FRAMEBUFFER, count, points);
+    }
+}
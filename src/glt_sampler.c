@@ -0,0 +1,220 @@
+#include "glt_sampler.h"
+#include "glt_log.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLER_LOG(level, msg, ...)    glt_log(level, "[SAMPLER]: " msg, ##__VA_ARGS__)
+
+typedef struct {
+    glt_sampler_desc_t desc;
+    GLuint id;
+} sampler_entry_t;
+
+// samplers are shared objects, so contexts sharing objects share one cache
+typedef struct sampler_cache_t {
+    const void *group;
+    sampler_entry_t *entries;
+    size_t count;
+    size_t capacity;
+    // 0 until the first anisotropic request
+    GLfloat max_anisotropy;
+    struct sampler_cache_t *next;
+} sampler_cache_t;
+
+static sampler_cache_t *caches = NULL;
+static pthread_mutex_t caches_mutex = PTHREAD_MUTEX_INITIALIZER;
+// share group of the context current on this thread
+static _Thread_local const void *current_group = NULL;
+
+// helper funcs
+
+static sampler_cache_t *find_cache(bool create);
+
+static glt_sampler_desc_t normalize_desc(sampler_cache_t *cache, const glt_sampler_desc_t *desc);
+
+static GLfloat query_max_anisotropy(void);
+
+static GLuint create_sampler(const glt_sampler_desc_t *desc);
+
+// public funcs
+
+GLuint glt_sampler_get(const glt_sampler_desc_t *desc) {
+    pthread_mutex_lock(&caches_mutex);
+    sampler_cache_t *cache = find_cache(true);
+    if (!cache) {
+        pthread_mutex_unlock(&caches_mutex);
+        SAMPLER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return 0;
+    }
+
+    const glt_sampler_desc_t key = normalize_desc(cache, desc);
+    for (size_t i = 0; i < cache->count; ++i) {
+        const glt_sampler_desc_t *d = &cache->entries[i].desc;
+        if (d->filter == key.filter && d->wrap == key.wrap && d->anisotropy == key.anisotropy) {
+            const GLuint id = cache->entries[i].id;
+            pthread_mutex_unlock(&caches_mutex);
+            return id;
+        }
+    }
+
+    if (cache->count == cache->capacity) {
+        const size_t capacity = cache->capacity ? cache->capacity * 2 : 8;
+        sampler_entry_t *grown = realloc(cache->entries, capacity * sizeof(sampler_entry_t));
+        if (!grown) {
+            pthread_mutex_unlock(&caches_mutex);
+            SAMPLER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+            return 0;
+        }
+        cache->entries = grown;
+        cache->capacity = capacity;
+    }
+
+    const GLuint id = create_sampler(&key);
+    if (id) {
+        cache->entries[cache->count].desc = key;
+        cache->entries[cache->count].id = id;
+        cache->count++;
+    }
+    pthread_mutex_unlock(&caches_mutex);
+
+    if (!id) {
+        SAMPLER_LOG(GLT_LOG_ERROR, "failed to create sampler");
+    }
+    return id;
+}
+
+void glt_sampler_set_group(const void *group) {
+    current_group = group;
+}
+
+const void *glt_sampler_get_group(void) {
+    return current_group;
+}
+
+void glt_sampler_cache_clear(void) {
+    pthread_mutex_lock(&caches_mutex);
+    for (sampler_cache_t **link = &caches; *link; link = &(*link)->next) {
+        sampler_cache_t *cache = *link;
+        if (cache->group != current_group) {
+            continue;
+        }
+        for (size_t i = 0; i < cache->count; ++i) {
+            glDeleteSamplers(1, &cache->entries[i].id);
+        }
+        *link = cache->next;
+        free(cache->entries);
+        free(cache);
+        break;
+    }
+    pthread_mutex_unlock(&caches_mutex);
+}
+
+size_t glt_sampler_cache_get_count(void) {
+    pthread_mutex_lock(&caches_mutex);
+    const sampler_cache_t *cache = find_cache(false);
+    const size_t count = cache ? cache->count : 0;
+    pthread_mutex_unlock(&caches_mutex);
+    return count;
+}
+
+// helper funcs
+
+static sampler_cache_t *find_cache(bool create) {
+    for (sampler_cache_t *cache = caches; cache; cache = cache->next) {
+        if (cache->group == current_group) {
+            return cache;
+        }
+    }
+    if (!create) {
+        return NULL;
+    }
+
+    sampler_cache_t *cache = calloc(1, sizeof(sampler_cache_t));
+    if (!cache) {
+        return NULL;
+    }
+    cache->group = current_group;
+    cache->next = caches;
+    caches = cache;
+    return cache;
+}
+
+// helper funcs
+
+static glt_sampler_desc_t normalize_desc(sampler_cache_t *cache, const glt_sampler_desc_t *desc) {
+    glt_sampler_desc_t key = {0};
+    if (!desc) {
+        key.anisotropy = 1.f;
+        return key;
+    }
+
+    key.filter = desc->filter < GLT_SAMPLER_FILTER__COUNT ? desc->filter : GLT_SAMPLER_FILTER_TRILINEAR;
+    key.wrap = desc->wrap < GLT_SAMPLER_WRAP__COUNT ? desc->wrap : GLT_SAMPLER_WRAP_REPEAT;
+    key.anisotropy = desc->anisotropy > 1.f ? desc->anisotropy : 1.f;
+
+    // different requests above the hardware limit share one sampler
+    if (key.anisotropy > 1.f) {
+        if (cache->max_anisotropy == 0.f) {
+            cache->max_anisotropy = query_max_anisotropy();
+        }
+        if (key.anisotropy > cache->max_anisotropy) {
+            key.anisotropy = cache->max_anisotropy;
+        }
+    }
+    return key;
+}
+
+static GLfloat query_max_anisotropy(void) {
+    // core in 4.6, the ARB / EXT extensions share the enums
+    bool supported = GLAD_GL_VERSION_4_6;
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count && !supported; ++i) {
+        const char *name = (const char *) glGetStringi(GL_EXTENSIONS, (GLuint) i);
+        supported = name && (strcmp(name, "GL_ARB_texture_filter_anisotropic") == 0
+                             || strcmp(name, "GL_EXT_texture_filter_anisotropic") == 0);
+    }
+    if (!supported) {
+        SAMPLER_LOG(GLT_LOG_WARNING, "anisotropic filtering is not supported");
+        return 1.f;
+    }
+
+    GLfloat max_anisotropy = 1.f;
+    glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &max_anisotropy);
+    return max_anisotropy > 1.f ? max_anisotropy : 1.f;
+}
+
+static GLuint create_sampler(const glt_sampler_desc_t *desc) {
+    static const GLint wraps[GLT_SAMPLER_WRAP__COUNT] = {
+        GL_REPEAT,
+        GL_CLAMP_TO_EDGE,
+        GL_MIRRORED_REPEAT
+    };
+    static const GLint min_filters[GLT_SAMPLER_FILTER__COUNT] = {
+        GL_LINEAR_MIPMAP_LINEAR,
+        GL_LINEAR_MIPMAP_NEAREST,
+        GL_NEAREST_MIPMAP_NEAREST
+    };
+
+    GLuint id = 0;
+    glGenSamplers(1, &id);
+    if (!id) {
+        return 0;
+    }
+
+    glSamplerParameteri(id, GL_TEXTURE_WRAP_S, wraps[desc->wrap]);
+    glSamplerParameteri(id, GL_TEXTURE_WRAP_T, wraps[desc->wrap]);
+    glSamplerParameteri(id, GL_TEXTURE_WRAP_R, wraps[desc->wrap]);
+    glSamplerParameteri(id, GL_TEXTURE_MIN_FILTER, min_filters[desc->filter]);
+    glSamplerParameteri(
+        id, GL_TEXTURE_MAG_FILTER,
+        desc->filter == GLT_SAMPLER_FILTER_NEAREST ? GL_NEAREST : GL_LINEAR
+    );
+    if (desc->anisotropy > 1.f) {
+        glSamplerParameterf(id, GL_TEXTURE_MAX_ANISOTROPY, desc->anisotropy);
+    }
+    return id;
+}
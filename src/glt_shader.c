@@ -1,5 +1,7 @@
 #include "glt_shader.h"
+#include "glt_debug.h"
 #include "glt_log.h"
+#include "glt_stats.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -22,6 +24,7 @@ static GLboolean check_compile_errors(GLuint shader, const char *type);
 static GLboolean check_link_errors(GLuint program);
 static void ensure_bounds(const glt_shader_t *shader);
 static char *read_from_text_file(const char *path, size_t *out_size);
+static void label_program(GLuint program, const char *vertex_shader_path, const char *fragment_shader_path);
 
 // public API
 
@@ -70,6 +73,7 @@ GLuint glt_shader_compile_path(GLenum type, const char *path) {
     if (!id) {
         SHADER_LOG(GLT_LOG_ERROR, "compile failed: '%s'", path);
     }
+    glt_debug_label(GL_SHADER, id, path);
     free(src);
     return id;
 }
@@ -106,6 +110,7 @@ glt_shader_t *glt_shader_prog_create(GLuint vertex_shader, GLuint fragment_shade
         return NULL;
     }
 
+    glt_stats_track_resource(GLT_RESOURCE_PROGRAM, 1, 0);
     return shader;
 }
 
@@ -153,6 +158,9 @@ glt_shader_t *glt_shader_prog_create_path(const char *vertex_shader_path, const
     glt_shader_t *prog = glt_shader_prog_create(vertex_shader, fragment_shader);
     glDeleteShader(vertex_shader);
     glDeleteShader(fragment_shader);
+    if (prog) {
+        label_program(prog->id, vertex_shader_path, fragment_shader_path);
+    }
     return prog;
 }
 
@@ -160,6 +168,7 @@ void glt_shader_destroy(glt_shader_t *shader) {
     if (shader) {
         if (shader->id) {
             glDeleteProgram(shader->id);
+            glt_stats_track_resource(GLT_RESOURCE_PROGRAM, -1, 0);
             shader->id = 0;
         }
         free(shader);
@@ -170,6 +179,7 @@ void glt_shader_destroy(glt_shader_t *shader) {
 void glt_shader_use(const glt_shader_t *shader) {
     if (shader && shader->id) {
         glUseProgram(shader->id);
+        glt_stats_add(GLT_STAT_PROGRAM_BINDS, 1);
     }
 }
 
@@ -200,6 +210,7 @@ void glt_shader_set_int_loc(glt_shader_t *shader, GLint loc, GLint value) {
     if (!shader || !shader->id || loc < 0) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniform1i(shader->id, loc, value);
     } else {
@@ -222,6 +233,7 @@ void glt_shader_set_ivec2_loc(glt_shader_t *shader, GLint loc, GLint x, GLint y)
     if (!shader || !shader->id || loc < 0) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniform2i(shader->id, loc, x, y);
     } else {
@@ -244,6 +256,7 @@ void glt_shader_set_ivec3_loc(glt_shader_t *shader, GLint loc, GLint x, GLint y,
     if (!shader || !shader->id || loc < 0) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniform3i(shader->id, loc, x, y, z);
     } else {
@@ -266,6 +279,7 @@ void glt_shader_set_ivec4_loc(glt_shader_t *shader, GLint loc, GLint x, GLint y,
     if (!shader || !shader->id || loc < 0) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniform4i(shader->id, loc, x, y, z, w);
     } else {
@@ -290,6 +304,7 @@ void glt_shader_set_uint_loc(const glt_shader_t *shader, GLint loc, GLuint value
     if (!shader || !shader->id || loc < 0) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniform1ui(shader->id, loc, value);
     } else {
@@ -312,6 +327,7 @@ void glt_shader_set_uvec2_loc(const glt_shader_t *shader, GLint loc, GLuint x, G
     if (!shader || !shader->id || loc < 0) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniform2ui(shader->id, loc, x, y);
     } else {
@@ -334,6 +350,7 @@ void glt_shader_set_uvec3_loc(const glt_shader_t *shader, GLint loc, GLuint x, G
     if (!shader || !shader->id || loc < 0) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniform3ui(shader->id, loc, x, y, z);
     } else {
@@ -356,6 +373,7 @@ void glt_shader_set_uvec4_loc(const glt_shader_t *shader, GLint loc, GLuint x, G
     if (!shader || !shader->id || loc < 0) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniform4ui(shader->id, loc, x, y, z, w);
     } else {
@@ -380,6 +398,7 @@ void glt_shader_set_float_loc(const glt_shader_t *shader, GLint loc, GLfloat v)
     if (!shader || !shader->id || loc < 0) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniform1f(shader->id, loc, v);
     } else {
@@ -402,6 +421,7 @@ void glt_shader_set_vec2_loc(const glt_shader_t *shader, GLint loc, GLfloat x, G
     if (!shader || !shader->id || loc < 0) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniform2f(shader->id, loc, x, y);
     } else {
@@ -424,6 +444,7 @@ void glt_shader_set_vec3_loc(const glt_shader_t *shader, GLint loc, GLfloat x, G
     if (!shader || !shader->id || loc < 0) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniform3f(shader->id, loc, x, y, z);
     } else {
@@ -446,6 +467,7 @@ void glt_shader_set_vec4_loc(const glt_shader_t *shader, GLint loc, GLfloat x, G
     if (!shader || !shader->id || loc < 0) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniform4f(shader->id, loc, x, y, z, w);
     } else {
@@ -454,6 +476,29 @@ void glt_shader_set_vec4_loc(const glt_shader_t *shader, GLint loc, GLfloat x, G
     }
 }
 
+void glt_shader_set_vec4_array(const glt_shader_t *shader, const char *name, GLsizei count, const GLfloat *values) {
+    if (!shader || !shader->id || !name) {
+        return;
+    }
+    const GLint loc = glGetUniformLocation(shader->id, name);
+    if (loc >= 0) {
+        glt_shader_set_vec4_array_loc(shader, loc, count, values);
+    }
+}
+
+void glt_shader_set_vec4_array_loc(const glt_shader_t *shader, GLint loc, GLsizei count, const GLfloat *values) {
+    if (!shader || !shader->id || loc < 0 || count <= 0 || !values) {
+        return;
+    }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
+    if (g_has_prog_uniforms) {
+        glProgramUniform4fv(shader->id, loc, count, values);
+    } else {
+        ensure_bounds(shader);
+        glUniform4fv(loc, count, values);
+    }
+}
+
 // matrices (float)
 
 void glt_shader_set_mat2(const glt_shader_t *shader, const char *name, const GLfloat *m2x2) {
@@ -470,6 +515,7 @@ void glt_shader_set_mat2_loc(const glt_shader_t *shader, GLint loc, const GLfloa
     if (!shader || !shader->id || loc < 0 || !m2x2) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniformMatrix2fv(shader->id, loc, 1, GL_FALSE, m2x2);
     } else {
@@ -492,6 +538,7 @@ void glt_shader_set_mat3_loc(const glt_shader_t *shader, GLint loc, const GLfloa
     if (!shader || !shader->id || loc < 0 || !m3x3) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniformMatrix3fv(shader->id, loc, 1, GL_FALSE, m3x3);
     } else {
@@ -514,6 +561,7 @@ void glt_shader_set_mat4_loc(const glt_shader_t *shader, GLint loc, const GLfloa
     if (!shader || !shader->id || loc < 0 || !m4x4) {
         return;
     }
+    glt_stats_add(GLT_STAT_UNIFORM_UPLOADS, 1);
     if (g_has_prog_uniforms) {
         glProgramUniformMatrix4fv(shader->id, loc, 1, GL_FALSE, m4x4);
     } else {
@@ -635,3 +683,9 @@ static char *read_from_text_file(const char *path, size_t *out_size) {
     }
     return buf;
 }
+
+static void label_program(GLuint program, const char *vertex_shader_path, const char *fragment_shader_path) {
+    char label[256];
+    snprintf(label, sizeof(label), "%s + %s", vertex_shader_path, fragment_shader_path);
+    glt_debug_label(GL_PROGRAM, program, label);
+}
@@ -0,0 +1,117 @@
+#include "glt_stats.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *stat_names[] = {
+    "draw calls",
+    "vertices",
+    "instances",
+    "program binds",
+    "vertex array binds",
+    "buffer binds",
+    "texture binds",
+    "uniform uploads",
+    "buffer uploads",
+    "buffer upload bytes",
+    "texture uploads",
+    "texture upload bytes"
+};
+
+static const char *resource_names[] = {
+    "buffers",
+    "vertex arrays",
+    "textures",
+    "programs",
+    "renderbuffers",
+    "framebuffers"
+};
+
+static atomic_uint_fast64_t current[GLT_STAT__COUNT];
+static atomic_uint_fast64_t last[GLT_STAT__COUNT];
+static atomic_int_fast64_t resource_counts[GLT_RESOURCE__COUNT];
+static atomic_int_fast64_t resource_bytes[GLT_RESOURCE__COUNT];
+
+void glt_stats_add(glt_stat_e stat, uint64_t value) {
+    assert(stat < GLT_STAT__COUNT);
+    atomic_fetch_add_explicit(&current[stat], value, memory_order_relaxed);
+}
+
+void glt_stats_track_resource(glt_resource_e resource, int64_t count, int64_t bytes) {
+    assert(resource < GLT_RESOURCE__COUNT);
+    atomic_fetch_add_explicit(&resource_counts[resource], count, memory_order_relaxed);
+    atomic_fetch_add_explicit(&resource_bytes[resource], bytes, memory_order_relaxed);
+}
+
+void glt_stats_end_frame(void) {
+    for (int i = 0; i < GLT_STAT__COUNT; ++i) {
+        const uint64_t value = atomic_exchange_explicit(&current[i], 0, memory_order_relaxed);
+        atomic_store_explicit(&last[i], value, memory_order_relaxed);
+    }
+}
+
+void glt_stats_get_frame(glt_frame_counters_t *counters) {
+    if (!counters) {
+        return;
+    }
+    for (int i = 0; i < GLT_STAT__COUNT; ++i) {
+        counters->counters[i] = atomic_load_explicit(&last[i], memory_order_relaxed);
+    }
+}
+
+void glt_stats_get_current(glt_frame_counters_t *counters) {
+    if (!counters) {
+        return;
+    }
+    for (int i = 0; i < GLT_STAT__COUNT; ++i) {
+        counters->counters[i] = atomic_load_explicit(&current[i], memory_order_relaxed);
+    }
+}
+
+uint64_t glt_stats_get(glt_stat_e stat) {
+    return stat < GLT_STAT__COUNT ? atomic_load_explicit(&last[stat], memory_order_relaxed) : 0;
+}
+
+void glt_stats_get_resource(glt_resource_e resource, glt_resource_usage_t *usage) {
+    if (!usage) {
+        return;
+    }
+    memset(usage, 0, sizeof(glt_resource_usage_t));
+    if (resource < GLT_RESOURCE__COUNT) {
+        usage->count = atomic_load_explicit(&resource_counts[resource], memory_order_relaxed);
+        usage->bytes = atomic_load_explicit(&resource_bytes[resource], memory_order_relaxed);
+    }
+}
+
+const char *glt_stats_get_name(glt_stat_e stat) {
+    return stat < GLT_STAT__COUNT ? stat_names[stat] : "?";
+}
+
+const char *glt_stats_get_resource_name(glt_resource_e resource) {
+    return resource < GLT_RESOURCE__COUNT ? resource_names[resource] : "?";
+}
+
+void glt_stats_print(FILE *out) {
+    if (!out) {
+        return;
+    }
+
+    glt_frame_counters_t frame;
+    glt_stats_get_frame(&frame);
+
+    fprintf(out, "---------------- Frame stats ----------------\n");
+    for (int i = 0; i < GLT_STAT__COUNT; ++i) {
+        fprintf(out, "%-22s %llu\n", stat_names[i], (unsigned long long) frame.counters[i]);
+    }
+    fprintf(out, "---------------- Resources ------------------\n");
+    for (int i = 0; i < GLT_RESOURCE__COUNT; ++i) {
+        glt_resource_usage_t usage;
+        glt_stats_get_resource((glt_resource_e) i, &usage);
+        fprintf(
+            out, "%-22s %lld (%.2f MiB)\n", resource_names[i],
+            (long long) usage.count, (double) usage.bytes / (1024.0 * 1024.0)
+        );
+    }
+    fprintf(out, "---------------------------------------------\n");
+}
@@ -1,4 +1,11 @@
 #include "glt_texture.h"
+#include "glt_texture_internal.h"
+#include "glt_container.h"
+#include "glt_bc.h"
+#include "glt_image.h"
+#include "glt_stats.h"
+#include "glt_trace.h"
+#include "glt_debug.h"
 #include "glt_log.h"
 
 #include <stdio.h>
@@ -10,55 +17,189 @@
 
 #define TEXTURE_LOG(level, msg, ...)    glt_log(level, "[TEXTURE]: " msg, ##__VA_ARGS__)
 
-struct glt_texture_t {
-    GLuint id;
-    GLsizei width;
-    GLsizei height;
-};
+#define BIND_BATCH 16
 
-static void set_default_params(void);
+static GLuint create_gl_texture_from_pixels(
+    int width, int height, int channels, const unsigned char *pixels,
+    const glt_texture_options_t *options, size_t *bytes
+);
 
-static bool choose_formats(int channels, GLenum *internal_format, GLenum *format);
+static GLuint create_gl_texture_from_container(
+    const glt_container_t *container, const glt_texture_options_t *options, size_t *bytes
+);
 
-static GLuint create_gl_texture_from_pixels(int width, int height, int channels, const unsigned char *pixels);
+static GLenum choose_compressed_format(const unsigned char *rgba, int width, int height, const glt_texture_options_t *options);
 
-static GLuint texture_load(const char *path, int *w, int *h);
+static GLuint create_gl_texture_compressed(
+    int width, int height, const unsigned char *rgba, GLenum format,
+    const glt_texture_options_t *options, size_t *bytes
+);
+
+static GLuint create_gl_texture_decoded(const glt_container_t *container, GLint levels);
+
+static size_t container_bytes(const glt_container_t *container, GLint levels, bool decoded);
+
+static void pixel_format_for(GLenum internal_format, GLenum *format, GLenum *type);
+
+static GLint clamp_levels(GLint requested, GLint available);
+
+static glt_texture_t *wrap_texture(GLuint id, GLsizei width, GLsizei height, size_t bytes, GLuint sampler);
 
 glt_texture_t *glt_texture_load(const char *path) {
+    return glt_texture_load_ex(path, NULL);
+}
+
+glt_texture_t *glt_texture_load_from_memory(const void *data, size_t size) {
+    return glt_texture_load_from_memory_ex(data, size, NULL);
+}
+
+glt_texture_t *glt_texture_load_ex(const char *path, const glt_texture_options_t *options) {
     if (!path) {
         return NULL;
     }
+    GLT_ZONE("glt_texture_load");
+
+    size_t size = 0;
+    unsigned char *data = glt_texture_read_file(path, &size);
+    if (!data) {
+        TEXTURE_LOG(GLT_LOG_ERROR, "can't read file: '%s'", path);
+        return NULL;
+    }
+
+    const glt_texture_options_t defaults = {0};
+    if (!options) {
+        options = &defaults;
+    }
 
     GLsizei width, height;
-    const GLuint id = texture_load(path, &width, &height);
+    size_t bytes = 0;
+    const GLuint id = glt_texture_create_gl(data, size, options, &width, &height, &bytes);
+    free(data);
     if (!id) {
+        TEXTURE_LOG(GLT_LOG_ERROR, "failed to load image '%s'", path);
         return NULL;
     }
+    glt_debug_label(GL_TEXTURE, id, path);
 
-    glt_texture_t *tex = malloc(sizeof(glt_texture_t));
-    if (!tex) {
-        glDeleteTextures(1, &id);
+    return wrap_texture(id, width, height, bytes, glt_sampler_get(&options->sampler));
+}
+
+glt_texture_t *glt_texture_load_from_memory_ex(const void *data, size_t size, const glt_texture_options_t *options) {
+    if (!data || size == 0) {
         return NULL;
     }
-    tex->id = id;
-    tex->width = width;
-    tex->height = height;
-    return tex;
+    GLT_ZONE("glt_texture_load_from_memory");
+
+    const glt_texture_options_t defaults = {0};
+    if (!options) {
+        options = &defaults;
+    }
+
+    GLsizei width, height;
+    size_t bytes = 0;
+    const GLuint id = glt_texture_create_gl(data, size, options, &width, &height, &bytes);
+    if (!id) {
+        return NULL;
+    }
+
+    return wrap_texture(id, width, height, bytes, glt_sampler_get(&options->sampler));
+}
+
+glt_texture_t *glt_texture_create_from_container(const glt_container_t *container, const glt_texture_options_t *options) {
+    const glt_texture_options_t defaults = {0};
+    if (!options) {
+        options = &defaults;
+    }
+
+    size_t bytes = 0;
+    const GLuint id = create_gl_texture_from_container(container, options, &bytes);
+    if (!id) {
+        return NULL;
+    }
+
+    return wrap_texture(id, container->width, container->height, bytes, glt_sampler_get(&options->sampler));
 }
 
 void glt_texture_destroy(glt_texture_t *texture) {
     if (!texture) {
         return;
     }
+    if (texture->cache) {
+        // shared textures only go away once the cache evicts them
+        glt_texture_cache_release(texture->cache, texture);
+        return;
+    }
+    if (texture->job) {
+        glt_texture_loader_detach(texture->loader, texture);
+    }
+    if (texture->stream) {
+        glt_texture_streamer_detach(texture->streamer, texture);
+    }
+    if (texture->upload) {
+        glt_uploader_detach(texture->uploader, texture);
+    }
     if (texture->id) {
         glDeleteTextures(1, &texture->id);
+        glt_stats_track_resource(GLT_RESOURCE_TEXTURE, -1, -(int64_t) texture->bytes);
         texture->id = 0;
     }
     free(texture);
 }
 
 GLuint glt_texture_get_id(const glt_texture_t *texture) {
-    return texture ? texture->id : 0;
+    if (!texture) {
+        return 0;
+    }
+    if (texture->state != GLT_TEXTURE_READY) {
+        // uploader textures and failed loads have no placeholder and sample as incomplete (black)
+        return texture->streamer
+                   ? glt_texture_streamer_get_placeholder(texture->streamer)
+                   : glt_texture_loader_get_placeholder(texture->loader);
+    }
+    return texture->id;
+}
+
+GLuint glt_texture_get_sampler(const glt_texture_t *texture) {
+    return texture ? texture->sampler : 0;
+}
+
+void glt_texture_bind(const glt_texture_t *texture, GLuint unit) {
+    glt_texture_bind_many(&texture, unit, 1);
+}
+
+void glt_texture_bind_many(const glt_texture_t *const *textures, GLuint first, GLsizei count) {
+    if (!textures || count <= 0) {
+        return;
+    }
+
+    GLuint ids[BIND_BATCH];
+    GLuint samplers[BIND_BATCH];
+    for (GLsizei base = 0; base < count; base += BIND_BATCH) {
+        const GLsizei n = count - base < BIND_BATCH ? count - base : BIND_BATCH;
+        for (GLsizei i = 0; i < n; ++i) {
+            const glt_texture_t *texture = textures[base + i];
+            ids[i] = glt_texture_get_id(texture);
+            samplers[i] = glt_texture_get_sampler(texture);
+        }
+
+        glt_stats_add(GLT_STAT_TEXTURE_BINDS, (uint64_t) n);
+        if (glBindTextures && glBindSamplers) {
+            glBindTextures(first + (GLuint) base, n, ids);
+            glBindSamplers(first + (GLuint) base, n, samplers);
+            continue;
+        }
+
+        // pre-4.4 contexts, restores the active unit afterwards
+        GLint prev_active = 0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &prev_active);
+        for (GLsizei i = 0; i < n; ++i) {
+            const GLuint unit = first + (GLuint) (base + i);
+            glActiveTexture(GL_TEXTURE0 + unit);
+            glBindTexture(GL_TEXTURE_2D, ids[i]);
+            glBindSampler(unit, samplers[i]);
+        }
+        glActiveTexture((GLenum) prev_active);
+    }
 }
 
 GLsizei glt_texture_get_width(const glt_texture_t *texture) {
@@ -69,15 +210,175 @@ GLsizei glt_texture_get_height(const glt_texture_t *texture) {
     return texture ? texture->height : 0;
 }
 
-static void set_default_params(void) {
-    // repeat + trilinear (with mipmaps)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+glt_texture_state_e glt_texture_get_state(const glt_texture_t *texture) {
+    return texture ? texture->state : GLT_TEXTURE_FAILED;
+}
+
+bool glt_texture_is_ready(const glt_texture_t *texture) {
+    return texture && texture->state == GLT_TEXTURE_READY;
+}
+
+size_t glt_texture_get_memory_size(const glt_texture_t *texture) {
+    return texture ? texture->bytes : 0;
+}
+
+unsigned char *glt_texture_prepare_pixels(
+    unsigned char *pixels, int *width, int *height, int *channels, const glt_texture_options_t *options
+) {
+    const glt_texture_options_t defaults = {0};
+    if (!options) {
+        options = &defaults;
+    }
+
+    glt_image_flip_vertical(pixels, *width, *height, *channels);
+
+    // RGB8 uploads take a slow path on many drivers
+    if (*channels == 3) {
+        const size_t count = (size_t) *width * (size_t) *height;
+        unsigned char *rgba = malloc(count * 4);
+        if (!rgba) {
+            TEXTURE_LOG(GLT_LOG_ERROR, "failed to allocate %zu bytes", count * 4);
+            free(pixels);
+            return NULL;
+        }
+        glt_image_rgb_to_rgba(pixels, rgba, count);
+        free(pixels);
+        pixels = rgba;
+        *channels = 4;
+    }
+
+    // before resizing, so filtering doesn't bleed color out of transparent texels
+    if (options->premultiply_alpha && *channels == 4) {
+        glt_image_premultiply_alpha(pixels, (size_t) *width * (size_t) *height);
+    }
+
+    int fit_width = 0, fit_height = 0;
+    glt_image_fit(*width, *height, options->max_size, &fit_width, &fit_height);
+    if (fit_width != *width || fit_height != *height) {
+        unsigned char *resized = NULL;
+        if (*channels == 4) {
+            resized = glt_image_resize(
+                pixels, *width, *height, fit_width, fit_height, GLT_IMAGE_FILTER_LANCZOS3, options->srgb
+            );
+        }
+        if (resized) {
+            free(pixels);
+            pixels = resized;
+            *width = fit_width;
+            *height = fit_height;
+        } else {
+            TEXTURE_LOG(GLT_LOG_WARNING, "can't downscale %dx%d image, uploading it at full size", *width, *height);
+        }
+    }
+
+    return pixels;
+}
+
+GLint glt_texture_mip_count(GLsizei width, GLsizei height) {
+    GLsizei size = width > height ? width : height;
+    GLint levels = 1;
+    while (size > 1) {
+        size /= 2;
+        levels++;
+    }
+    return levels;
+}
+
+size_t glt_texture_mip_chain_bytes(GLsizei width, GLsizei height, int channels, GLint levels) {
+    const size_t texel = channels == 3 ? 4 : (size_t) channels;
+    size_t total = 0;
+    for (GLint i = 0; i < levels; ++i) {
+        total += (size_t) width * (size_t) height * texel;
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return total;
+}
+
+size_t glt_texture_format_bytes(GLenum format) {
+    switch (format) {
+        case GL_R8:
+        case GL_STENCIL_INDEX8:
+            return 1;
+        case GL_RG8:
+        case GL_R16F:
+        case GL_DEPTH_COMPONENT16:
+            return 2;
+        case GL_RGBA16F:
+        case GL_RG32F:
+        case GL_DEPTH32F_STENCIL8:
+            return 8;
+        case GL_RGBA32F:
+            return 16;
+        default:
+            // RGBA8, sRGB8_A8, RGB10_A2, R11F_G11F_B10F, RG16F, R32F, 24/32-bit depth and D24S8
+            return 4;
+    }
+}
+
+GLenum glt_texture_depth_attachment_point(GLenum format) {
+    switch (format) {
+        case GL_DEPTH24_STENCIL8:
+        case GL_DEPTH32F_STENCIL8:
+            return GL_DEPTH_STENCIL_ATTACHMENT;
+        case GL_STENCIL_INDEX8:
+            return GL_STENCIL_ATTACHMENT;
+        default:
+            return GL_DEPTH_ATTACHMENT;
+    }
+}
+
+glt_texture_t *glt_texture_create_render_target(GLenum format, GLsizei width, GLsizei height) {
+    GLuint texture_id = 0;
+    glGenTextures(1, &texture_id);
+    if (!texture_id) {
+        return NULL;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    glt_texture_allocate(GL_TEXTURE_2D, 1, format, width, height, 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    const size_t bytes = (size_t) width * (size_t) height * glt_texture_format_bytes(format);
+    return wrap_texture(texture_id, width, height, bytes, glt_sampler_get(NULL));
+}
+
+void glt_texture_allocate(
+    GLenum target, GLint levels, GLenum internal_format, GLsizei width, GLsizei height, GLsizei depth
+) {
+    if (GLAD_GL_VERSION_4_2) {
+        if (target == GL_TEXTURE_2D_ARRAY) {
+            glTexStorage3D(target, levels, internal_format, width, height, depth);
+        } else {
+            glTexStorage2D(target, levels, internal_format, width, height);
+        }
+        return;
+    }
+
+    // format / type only have to be compatible with internal_format, no pixels are read
+    const bool compressed = glt_container_block_bytes(internal_format) != 0;
+    GLenum format = GL_RGBA, type = GL_UNSIGNED_BYTE;
+    pixel_format_for(internal_format, &format, &type);
+
+    for (GLint i = 0; i < levels; ++i) {
+        const GLsizei w = width >> i > 0 ? width >> i : 1;
+        const GLsizei h = height >> i > 0 ? height >> i : 1;
+        if (compressed) {
+            const GLsizei size = (GLsizei) (glt_container_level_size(internal_format, w, h) * (size_t) depth);
+            if (target == GL_TEXTURE_2D_ARRAY) {
+                glCompressedTexImage3D(target, i, internal_format, w, h, depth, 0, size, NULL);
+            } else {
+                glCompressedTexImage2D(target, i, internal_format, w, h, 0, size, NULL);
+            }
+        } else if (target == GL_TEXTURE_2D_ARRAY) {
+            glTexImage3D(target, i, (GLint) internal_format, w, h, depth, 0, format, type, NULL);
+        } else {
+            glTexImage2D(target, i, (GLint) internal_format, w, h, 0, format, type, NULL);
+        }
+    }
+    glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, levels - 1);
 }
 
-static bool choose_formats(int channels, GLenum *internal_format, GLenum *format) {
+bool glt_texture_choose_formats(int channels, bool srgb, GLenum *internal_format, GLenum *format) {
     switch (channels) {
         case 1: *internal_format = GL_R8;
             *format = GL_RED;
@@ -85,10 +386,10 @@ static bool choose_formats(int channels, GLenum *internal_format, GLenum *format
         case 2: *internal_format = GL_RG8;
             *format = GL_RG;
             return true;
-        case 3: *internal_format = GL_RGB8;
+        case 3: *internal_format = srgb ? GL_SRGB8 : GL_RGB8;
             *format = GL_RGB;
             return true;
-        case 4: *internal_format = GL_RGBA8;
+        case 4: *internal_format = srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
             *format = GL_RGBA;
             return true;
         default:
@@ -96,17 +397,79 @@ static bool choose_formats(int channels, GLenum *internal_format, GLenum *format
     }
 }
 
-static GLuint create_gl_texture_from_pixels(int width, int height, int channels, const unsigned char *pixels) {
+static GLuint create_gl_texture_from_pixels(
+    int width, int height, int channels, const unsigned char *pixels,
+    const glt_texture_options_t *options, size_t *bytes
+) {
     if (!pixels || width <= 0 || height <= 0) {
         return 0;
     }
 
     GLenum internal_format = 0, format = 0;
-    if (!choose_formats(channels, &internal_format, &format)) {
+    if (!glt_texture_choose_formats(channels, options->srgb, &internal_format, &format)) {
         TEXTURE_LOG(GLT_LOG_ERROR, "unsupported channel count: %d", channels);
         return 0;
     }
 
+    if (options->compression != GLT_TEXTURE_COMPRESSION_NONE && channels == 4) {
+        const GLenum compressed = choose_compressed_format(pixels, width, height, options);
+        if (compressed && glt_texture_compressed_format_supported(compressed)) {
+            return create_gl_texture_compressed(width, height, pixels, compressed, options, bytes);
+        }
+        TEXTURE_LOG(GLT_LOG_WARNING, "requested compression is not supported, uploading uncompressed");
+    }
+
+    GLuint texture_id = 0;
+    glGenTextures(1, &texture_id);
+    if (!texture_id) {
+        return 0;
+    }
+
+    const GLint levels = clamp_levels(options->mip_levels, glt_texture_mip_count(width, height));
+
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    glt_texture_allocate(GL_TEXTURE_2D, levels, internal_format, width, height, 1);
+
+    // RGBA rows are always 4-aligned, the others need tight rows for arbitrary widths
+    GLint prev_unpack = 0;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prev_unpack);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, channels == 4 ? 4 : 1);
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, pixels);
+    glt_stats_add(GLT_STAT_TEXTURE_UPLOADS, 1);
+    glt_stats_add(GLT_STAT_TEXTURE_UPLOAD_BYTES, (uint64_t) width * (uint64_t) height * (uint64_t) channels);
+    if (levels > 1) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    // restore state and unbind
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prev_unpack);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    *bytes = glt_texture_mip_chain_bytes(width, height, channels, levels);
+    return texture_id;
+}
+
+static GLuint create_gl_texture_from_container(
+    const glt_container_t *container, const glt_texture_options_t *options, size_t *bytes
+) {
+    // stored chains are uploaded as they are, compressed formats can't be glGenerateMipmap'ed
+    const bool generate = !container->compressed && container->levels == 1;
+    const GLint levels = generate
+                             ? clamp_levels(options->mip_levels, glt_texture_mip_count(container->width, container->height))
+                             : clamp_levels(options->mip_levels, container->levels);
+
+    if (container->compressed && !glt_texture_compressed_format_supported(container->internal_format)) {
+        if (!glt_bc_can_decode(container->internal_format)) {
+            TEXTURE_LOG(GLT_LOG_ERROR, "compressed format 0x%04X is not supported", container->internal_format);
+            return 0;
+        }
+        TEXTURE_LOG(GLT_LOG_WARNING, "format 0x%04X is not supported, decoding on the CPU", container->internal_format);
+        *bytes = container_bytes(container, levels, true);
+        return create_gl_texture_decoded(container, levels);
+    }
+    *bytes = container_bytes(container, levels, false);
+
     GLuint texture_id = 0;
     glGenTextures(1, &texture_id);
     if (!texture_id) {
@@ -114,37 +477,347 @@ static GLuint create_gl_texture_from_pixels(int width, int height, int channels,
     }
 
     glBindTexture(GL_TEXTURE_2D, texture_id);
-    set_default_params();
+    glt_texture_allocate(GL_TEXTURE_2D, levels, container->internal_format, container->width, container->height, 1);
 
-    // Ensure tight rows for arbitrary widths
     GLint prev_unpack = 0;
     glGetIntegerv(GL_UNPACK_ALIGNMENT, &prev_unpack);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    glTexImage2D(
-        GL_TEXTURE_2D, 0, (GLint) internal_format, width, height,
-        0, format, GL_UNSIGNED_BYTE, pixels
+    const GLint stored = generate ? 1 : levels;
+    for (GLint i = 0; i < stored; ++i) {
+        const glt_container_level_t *level = &container->level[i];
+        if (container->compressed) {
+            glCompressedTexSubImage2D(
+                GL_TEXTURE_2D, i, 0, 0, level->width, level->height,
+                container->internal_format, (GLsizei) level->size, level->data
+            );
+        } else {
+            glTexSubImage2D(
+                GL_TEXTURE_2D, i, 0, 0, level->width, level->height,
+                container->format, container->type, level->data
+            );
+        }
+        glt_stats_add(GLT_STAT_TEXTURE_UPLOADS, 1);
+        glt_stats_add(GLT_STAT_TEXTURE_UPLOAD_BYTES, level->size);
+    }
+    if (generate && levels > 1) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prev_unpack);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return texture_id;
+}
+
+static GLenum choose_compressed_format(const unsigned char *rgba, int width, int height, const glt_texture_options_t *options) {
+    glt_texture_compression_e compression = options->compression;
+    if (compression == GLT_TEXTURE_COMPRESSION_AUTO) {
+        compression = GLT_TEXTURE_COMPRESSION_BC1;
+        const size_t count = (size_t) width * (size_t) height;
+        for (size_t i = 0; i < count; ++i) {
+            if (rgba[i * 4 + 3] != 255) {
+                compression = GLT_TEXTURE_COMPRESSION_BC3;
+                break;
+            }
+        }
+    }
+
+    switch (compression) {
+        case GLT_TEXTURE_COMPRESSION_BC1:
+            return options->srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case GLT_TEXTURE_COMPRESSION_BC3:
+            return options->srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case GLT_TEXTURE_COMPRESSION_BC7:
+            return options->srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+        default:
+            return 0;
+    }
+}
+
+static GLuint create_gl_texture_compressed(
+    int width, int height, const unsigned char *rgba, GLenum format,
+    const glt_texture_options_t *options, size_t *bytes
+) {
+    unsigned char *blocks = malloc(glt_bc_encoded_size(format, width, height));
+    if (!blocks) {
+        TEXTURE_LOG(GLT_LOG_ERROR, "failed to allocate %zu bytes", glt_bc_encoded_size(format, width, height));
+        return 0;
+    }
+
+    GLuint texture_id = 0;
+    glGenTextures(1, &texture_id);
+    if (!texture_id) {
+        free(blocks);
+        return 0;
+    }
+
+    const GLint levels = clamp_levels(options->mip_levels, glt_texture_mip_count(width, height));
+
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    glt_texture_allocate(GL_TEXTURE_2D, levels, format, width, height, 1);
+
+    // block formats can't be glGenerateMipmap'ed, the chain is built before encoding
+    *bytes = 0;
+    const unsigned char *level = rgba;
+    unsigned char *scratch = NULL;
+    for (GLint i = 0; i < levels; ++i) {
+        const size_t size = glt_bc_encoded_size(format, width, height);
+        glt_bc_encode(format, level, width, height, blocks, options->compression_quality, 0);
+        glCompressedTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, width, height, format, (GLsizei) size, blocks);
+        glt_stats_add(GLT_STAT_TEXTURE_UPLOADS, 1);
+        glt_stats_add(GLT_STAT_TEXTURE_UPLOAD_BYTES, size);
+        *bytes += size;
+
+        if (i + 1 == levels) {
+            break;
+        }
+        const int next_width = width > 1 ? width / 2 : 1;
+        const int next_height = height > 1 ? height / 2 : 1;
+        unsigned char *next = glt_image_resize(
+            level, width, height, next_width, next_height, GLT_IMAGE_FILTER_BOX, options->srgb
+        );
+        free(scratch);
+        if (!next) {
+            // the remaining levels stay undefined, clamp sampling to what was uploaded
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, i);
+            scratch = NULL;
+            break;
+        }
+        scratch = next;
+        level = next;
+        width = next_width;
+        height = next_height;
+    }
+
+    free(scratch);
+    free(blocks);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return texture_id;
+}
+
+static GLuint create_gl_texture_decoded(const glt_container_t *container, GLint levels) {
+    const GLenum format = container->internal_format;
+    const bool srgb = format >= GL_COMPRESSED_SRGB_S3TC_DXT1_EXT && format <= GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+
+    const size_t max_size = (size_t) container->width * (size_t) container->height * 4;
+    unsigned char *pixels = malloc(max_size);
+    if (!pixels) {
+        TEXTURE_LOG(GLT_LOG_ERROR, "failed to allocate %zu bytes", max_size);
+        return 0;
+    }
+
+    GLuint texture_id = 0;
+    glGenTextures(1, &texture_id);
+    if (!texture_id) {
+        free(pixels);
+        return 0;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    glt_texture_allocate(
+        GL_TEXTURE_2D, levels, srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8,
+        container->width, container->height, 1
     );
-    glGenerateMipmap(GL_TEXTURE_2D);
 
-    // restore state and unbind
+    GLint prev_unpack = 0;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prev_unpack);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    for (GLint i = 0; i < levels; ++i) {
+        const glt_container_level_t *level = &container->level[i];
+        glt_bc_decode(format, level->data, level->width, level->height, pixels);
+        glTexSubImage2D(
+            GL_TEXTURE_2D, i, 0, 0, level->width, level->height,
+            GL_RGBA, GL_UNSIGNED_BYTE, pixels
+        );
+        glt_stats_add(GLT_STAT_TEXTURE_UPLOADS, 1);
+        glt_stats_add(GLT_STAT_TEXTURE_UPLOAD_BYTES, (uint64_t) level->width * (uint64_t) level->height * 4);
+    }
+
     glPixelStorei(GL_UNPACK_ALIGNMENT, prev_unpack);
     glBindTexture(GL_TEXTURE_2D, 0);
+    free(pixels);
 
     return texture_id;
 }
 
-static GLuint texture_load(const char *path, int *w, int *h) {
+bool glt_texture_compressed_format_supported(GLenum format) {
+    if (glGetInternalformativ) {
+        GLint supported = GL_FALSE;
+        glGetInternalformativ(GL_TEXTURE_2D, format, GL_INTERNALFORMAT_SUPPORTED, 1, &supported);
+        return supported == GL_TRUE;
+    }
+
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+    if (count <= 0) {
+        return false;
+    }
+    GLint *formats = malloc((size_t) count * sizeof(GLint));
+    if (!formats) {
+        return false;
+    }
+    glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats);
+
+    bool found = false;
+    for (GLint i = 0; i < count && !found; ++i) {
+        found = (GLenum) formats[i] == format;
+    }
+    free(formats);
+    return found;
+}
+
+static size_t container_bytes(const glt_container_t *container, GLint levels, bool decoded) {
+    if (!container->compressed && container->levels == 1) {
+        const size_t texel = container->level[0].size / ((size_t) container->width * (size_t) container->height);
+        return glt_texture_mip_chain_bytes(container->width, container->height, (int) texel, levels);
+    }
+
+    size_t total = 0;
+    for (GLint i = 0; i < levels; ++i) {
+        const glt_container_level_t *level = &container->level[i];
+        total += decoded ? (size_t) level->width * (size_t) level->height * 4 : level->size;
+    }
+    return total;
+}
+
+GLuint glt_texture_create_gl(
+    const unsigned char *data, size_t size, const glt_texture_options_t *options, int *w, int *h, size_t *bytes
+) {
+    if (glt_container_is_known(data, size)) {
+        glt_container_t container;
+        if (!glt_container_parse(data, size, &container)) {
+            return 0;
+        }
+        *w = container.width;
+        *h = container.height;
+        return create_gl_texture_from_container(&container, options, bytes);
+    }
+
     int width = 0, height = 0, channels = 0;
-    stbi_set_flip_vertically_on_load(GL_TRUE);
-    unsigned char *data = stbi_load(path, &width, &height, &channels, 0);
-    if (!data) {
-        TEXTURE_LOG(GLT_LOG_ERROR, "failed to load image '%s'", path);
+    unsigned char *pixels = stbi_load_from_memory(data, (int) size, &width, &height, &channels, 0);
+    if (!pixels) {
+        TEXTURE_LOG(GLT_LOG_ERROR, "failed to decode image: %s", stbi_failure_reason());
+        return 0;
+    }
+    pixels = glt_texture_prepare_pixels(pixels, &width, &height, &channels, options);
+    if (!pixels) {
         return 0;
     }
-    const GLuint id = create_gl_texture_from_pixels(width, height, channels, data);
+    const GLuint id = create_gl_texture_from_pixels(width, height, channels, pixels, options, bytes);
     *w = width;
     *h = height;
-    stbi_image_free(data);
+    free(pixels);
     return id;
 }
+
+static void pixel_format_for(GLenum internal_format, GLenum *format, GLenum *type) {
+    switch (internal_format) {
+        case GL_DEPTH_COMPONENT16:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32F:
+            *format = GL_DEPTH_COMPONENT;
+            *type = GL_FLOAT;
+            break;
+        case GL_DEPTH24_STENCIL8:
+            *format = GL_DEPTH_STENCIL;
+            *type = GL_UNSIGNED_INT_24_8;
+            break;
+        case GL_DEPTH32F_STENCIL8:
+            *format = GL_DEPTH_STENCIL;
+            *type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+            break;
+        case GL_STENCIL_INDEX8:
+            *format = GL_STENCIL_INDEX;
+            *type = GL_UNSIGNED_BYTE;
+            break;
+        case GL_R8:
+        case GL_R16F:
+        case GL_R32F:
+            *format = GL_RED;
+            *type = GL_UNSIGNED_BYTE;
+            break;
+        case GL_RG8:
+        case GL_RG16F:
+        case GL_RG32F:
+            *format = GL_RG;
+            *type = GL_UNSIGNED_BYTE;
+            break;
+        case GL_RGB8:
+        case GL_SRGB8:
+        case GL_R11F_G11F_B10F:
+            *format = GL_RGB;
+            *type = GL_UNSIGNED_BYTE;
+            break;
+        default:
+            *format = GL_RGBA;
+            *type = GL_UNSIGNED_BYTE;
+            break;
+    }
+}
+
+static GLint clamp_levels(GLint requested, GLint available) {
+    return requested > 0 && requested < available ? requested : available;
+}
+
+static glt_texture_t *wrap_texture(GLuint id, GLsizei width, GLsizei height, size_t bytes, GLuint sampler) {
+    glt_texture_t *tex = malloc(sizeof(glt_texture_t));
+    if (!tex) {
+        glDeleteTextures(1, &id);
+        return NULL;
+    }
+    tex->id = id;
+    tex->width = width;
+    tex->height = height;
+    tex->state = GLT_TEXTURE_READY;
+    tex->sampler = sampler;
+    tex->loader = NULL;
+    tex->job = NULL;
+    tex->cache = NULL;
+    tex->cache_entry = NULL;
+    tex->streamer = NULL;
+    tex->stream = NULL;
+    tex->uploader = NULL;
+    tex->upload = NULL;
+    tex->bytes = bytes;
+    glt_stats_track_resource(GLT_RESOURCE_TEXTURE, 1, (int64_t) bytes);
+    return tex;
+}
+
+unsigned char *glt_texture_read_file(const char *path, size_t *out_size) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+
+    if (fseek(f, 0, SEEK_END) != 0) {
+        fclose(f);
+        return NULL;
+    }
+    const long len = ftell(f);
+    if (len <= 0 || fseek(f, 0, SEEK_SET) != 0) {
+        fclose(f);
+        return NULL;
+    }
+
+    // one spare byte so text can be nul-terminated in place
+    const size_t n = len;
+    unsigned char *buf = malloc(n + 1);
+    if (!buf) {
+        fclose(f);
+        return NULL;
+    }
+
+    const size_t rd = fread(buf, 1, n, f);
+    fclose(f);
+    if (rd != n) {
+        free(buf);
+        return NULL;
+    }
+
+    buf[n] = '\0';
+    *out_size = n;
+    return buf;
+}
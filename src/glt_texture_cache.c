@@ -0,0 +1,373 @@
+#include "glt_texture_cache.h"
+#include "glt_texture_internal.h"
+#include "glt_log.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LOG(level, msg, ...)    glt_log(level, "[TEXTURE CACHE]: " msg, ##__VA_ARGS__)
+
+#define INITIAL_BUCKETS 64
+
+struct texture_cache_entry_t {
+    char *key;
+    uint32_t hash;
+    // owns the GL texture, callers get handles that share it
+    glt_texture_t *texture;
+    size_t refs;
+
+    texture_cache_entry_t *next_in_bucket;
+    // unreferenced entries only, head is the most recently released
+    texture_cache_entry_t *lru_prev;
+    texture_cache_entry_t *lru_next;
+};
+
+struct glt_texture_cache_t {
+    texture_cache_entry_t **buckets;
+    size_t bucket_count;
+    size_t count;
+    size_t usage;
+    size_t budget;
+    texture_cache_entry_t *lru_head;
+    texture_cache_entry_t *lru_tail;
+};
+
+// helper funcs
+
+static char *make_key(const char *path, const glt_texture_options_t *options);
+
+static char *canonical_path(const char *path);
+
+static glt_texture_t *make_handle(glt_texture_cache_t *cache, texture_cache_entry_t *entry, const glt_sampler_desc_t *sampler);
+
+static uint32_t hash_string(const char *s);
+
+static texture_cache_entry_t *find_entry(const glt_texture_cache_t *cache, const char *key, uint32_t hash);
+
+static bool insert_entry(glt_texture_cache_t *cache, texture_cache_entry_t *entry);
+
+static void remove_entry(glt_texture_cache_t *cache, texture_cache_entry_t *entry);
+
+static bool grow_buckets(glt_texture_cache_t *cache);
+
+static void lru_push(glt_texture_cache_t *cache, texture_cache_entry_t *entry);
+
+static void lru_unlink(glt_texture_cache_t *cache, texture_cache_entry_t *entry);
+
+static void destroy_entry(glt_texture_cache_t *cache, texture_cache_entry_t *entry);
+
+// public funcs
+
+glt_texture_cache_t *glt_texture_cache_create(size_t budget) {
+    glt_texture_cache_t *cache = calloc(1, sizeof(glt_texture_cache_t));
+    if (!cache) {
+        CACHE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+
+    cache->buckets = calloc(INITIAL_BUCKETS, sizeof(texture_cache_entry_t *));
+    if (!cache->buckets) {
+        CACHE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        free(cache);
+        return NULL;
+    }
+    cache->bucket_count = INITIAL_BUCKETS;
+    cache->budget = budget;
+
+    return cache;
+}
+
+void glt_texture_cache_destroy(glt_texture_cache_t *cache) {
+    if (!cache) {
+        return;
+    }
+
+    for (size_t i = 0; i < cache->bucket_count; ++i) {
+        texture_cache_entry_t *entry = cache->buckets[i];
+        while (entry) {
+            texture_cache_entry_t *next = entry->next_in_bucket;
+            if (entry->refs > 0) {
+                CACHE_LOG(GLT_LOG_WARNING, "'%s' is still referenced %zu time(s)", entry->key, entry->refs);
+            }
+            destroy_entry(cache, entry);
+            entry = next;
+        }
+    }
+
+    free(cache->buckets);
+    free(cache);
+}
+
+glt_texture_t *glt_texture_cache_acquire(glt_texture_cache_t *cache, const char *path) {
+    return glt_texture_cache_acquire_ex(cache, path, NULL);
+}
+
+glt_texture_t *glt_texture_cache_acquire_ex(
+    glt_texture_cache_t *cache, const char *path, const glt_texture_options_t *options
+) {
+    if (!cache || !path) {
+        return NULL;
+    }
+
+    const glt_texture_options_t defaults = {0};
+    if (!options) {
+        options = &defaults;
+    }
+
+    char *key = make_key(path, options);
+    if (!key) {
+        CACHE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+    const uint32_t hash = hash_string(key);
+
+    texture_cache_entry_t *entry = find_entry(cache, key, hash);
+    if (entry) {
+        free(key);
+        glt_texture_t *handle = make_handle(cache, entry, &options->sampler);
+        if (handle && entry->refs++ == 0) {
+            lru_unlink(cache, entry);
+        }
+        return handle;
+    }
+
+    glt_texture_t *texture = glt_texture_load_ex(path, options);
+    if (!texture) {
+        free(key);
+        return NULL;
+    }
+
+    entry = calloc(1, sizeof(texture_cache_entry_t));
+    if (!entry) {
+        CACHE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        glt_texture_destroy(texture);
+        free(key);
+        return NULL;
+    }
+    entry->key = key;
+    entry->hash = hash;
+    entry->texture = texture;
+    entry->refs = 1;
+
+    glt_texture_t *handle = make_handle(cache, entry, &options->sampler);
+    if (!handle || !insert_entry(cache, entry)) {
+        free(handle);
+        glt_texture_destroy(texture);
+        free(key);
+        free(entry);
+        return NULL;
+    }
+    cache->usage += texture->bytes;
+
+    // the new texture may push unreferenced ones over the budget
+    glt_texture_cache_trim(cache);
+
+    return handle;
+}
+
+void glt_texture_cache_release(glt_texture_cache_t *cache, glt_texture_t *texture) {
+    if (!cache || !texture || texture->cache != cache) {
+        return;
+    }
+
+    texture_cache_entry_t *entry = texture->cache_entry;
+    if (entry->refs == 0) {
+        CACHE_LOG(GLT_LOG_WARNING, "'%s' released more often than acquired", entry->key);
+        return;
+    }
+    free(texture);
+    if (--entry->refs == 0) {
+        lru_push(cache, entry);
+        glt_texture_cache_trim(cache);
+    }
+}
+
+void glt_texture_cache_set_budget(glt_texture_cache_t *cache, size_t budget) {
+    if (cache) {
+        cache->budget = budget;
+        glt_texture_cache_trim(cache);
+    }
+}
+
+void glt_texture_cache_trim(glt_texture_cache_t *cache) {
+    if (!cache) {
+        return;
+    }
+    while (cache->usage > cache->budget && cache->lru_tail) {
+        texture_cache_entry_t *victim = cache->lru_tail;
+        remove_entry(cache, victim);
+        destroy_entry(cache, victim);
+    }
+}
+
+size_t glt_texture_cache_get_usage(const glt_texture_cache_t *cache) {
+    return cache ? cache->usage : 0;
+}
+
+size_t glt_texture_cache_get_count(const glt_texture_cache_t *cache) {
+    return cache ? cache->count : 0;
+}
+
+// helper funcs
+
+static char *make_key(const char *path, const glt_texture_options_t *options) {
+    char *canonical = canonical_path(path);
+    if (!canonical) {
+        return NULL;
+    }
+
+    // only what changes the pixels, the sampler is per handle
+    char suffix[128];
+    const int n = snprintf(
+        suffix, sizeof(suffix), "?levels=%d&srgb=%d&max=%d&premul=%d&bc=%d&bcq=%d",
+        options->mip_levels, options->srgb, options->max_size, options->premultiply_alpha,
+        options->compression, options->compression_quality
+    );
+    const size_t len = strlen(canonical);
+    char *key = realloc(canonical, len + (size_t) n + 1);
+    if (!key) {
+        free(canonical);
+        return NULL;
+    }
+    memcpy(key + len, suffix, (size_t) n + 1);
+    return key;
+}
+
+static char *canonical_path(const char *path) {
+#ifdef _WIN32
+    char *resolved = _fullpath(NULL, path, 0);
+#else
+    char *resolved = realpath(path, NULL);
+#endif
+    if (resolved) {
+        return resolved;
+    }
+
+    // missing files still get a key, the load reports the error
+    char *copy = malloc(strlen(path) + 1);
+    if (copy) {
+        strcpy(copy, path);
+    }
+    return copy;
+}
+
+static glt_texture_t *make_handle(glt_texture_cache_t *cache, texture_cache_entry_t *entry, const glt_sampler_desc_t *sampler) {
+    glt_texture_t *handle = malloc(sizeof(glt_texture_t));
+    if (!handle) {
+        CACHE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+    *handle = *entry->texture;
+    handle->sampler = glt_sampler_get(sampler);
+    handle->cache = cache;
+    handle->cache_entry = entry;
+    return handle;
+}
+
+static uint32_t hash_string(const char *s) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (; *s; ++s) {
+        hash ^= (unsigned char) *s;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static texture_cache_entry_t *find_entry(const glt_texture_cache_t *cache, const char *key, uint32_t hash) {
+    texture_cache_entry_t *entry = cache->buckets[hash & (cache->bucket_count - 1)];
+    for (; entry; entry = entry->next_in_bucket) {
+        if (entry->hash == hash && strcmp(entry->key, key) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static bool insert_entry(glt_texture_cache_t *cache, texture_cache_entry_t *entry) {
+    if (cache->count + 1 > cache->bucket_count * 3 / 4 && !grow_buckets(cache)) {
+        return false;
+    }
+
+    const size_t index = entry->hash & (cache->bucket_count - 1);
+    entry->next_in_bucket = cache->buckets[index];
+    cache->buckets[index] = entry;
+    cache->count++;
+    return true;
+}
+
+static void remove_entry(glt_texture_cache_t *cache, texture_cache_entry_t *entry) {
+    texture_cache_entry_t **link = &cache->buckets[entry->hash & (cache->bucket_count - 1)];
+    while (*link && *link != entry) {
+        link = &(*link)->next_in_bucket;
+    }
+    if (*link) {
+        *link = entry->next_in_bucket;
+        cache->count--;
+    }
+}
+
+static bool grow_buckets(glt_texture_cache_t *cache) {
+    const size_t count = cache->bucket_count * 2;
+    texture_cache_entry_t **buckets = calloc(count, sizeof(texture_cache_entry_t *));
+    if (!buckets) {
+        CACHE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return false;
+    }
+
+    for (size_t i = 0; i < cache->bucket_count; ++i) {
+        texture_cache_entry_t *entry = cache->buckets[i];
+        while (entry) {
+            texture_cache_entry_t *next = entry->next_in_bucket;
+            const size_t index = entry->hash & (count - 1);
+            entry->next_in_bucket = buckets[index];
+            buckets[index] = entry;
+            entry = next;
+        }
+    }
+
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucket_count = count;
+    return true;
+}
+
+static void lru_push(glt_texture_cache_t *cache, texture_cache_entry_t *entry) {
+    entry->lru_prev = NULL;
+    entry->lru_next = cache->lru_head;
+    if (cache->lru_head) {
+        cache->lru_head->lru_prev = entry;
+    } else {
+        cache->lru_tail = entry;
+    }
+    cache->lru_head = entry;
+}
+
+static void lru_unlink(glt_texture_cache_t *cache, texture_cache_entry_t *entry) {
+    if (entry->lru_prev) {
+        entry->lru_prev->lru_next = entry->lru_next;
+    } else {
+        cache->lru_head = entry->lru_next;
+    }
+    if (entry->lru_next) {
+        entry->lru_next->lru_prev = entry->lru_prev;
+    } else {
+        cache->lru_tail = entry->lru_prev;
+    }
+    entry->lru_prev = NULL;
+    entry->lru_next = NULL;
+}
+
+static void destroy_entry(glt_texture_cache_t *cache, texture_cache_entry_t *entry) {
+    if (entry->refs == 0) {
+        lru_unlink(cache, entry);
+    }
+    cache->usage -= entry->texture->bytes;
+
+    glt_texture_destroy(entry->texture);
+
+    free(entry->key);
+    free(entry);
+}
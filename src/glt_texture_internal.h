@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "glt_texture.h"
+#include "glt_texture_loader.h"
+#include "glt_texture_cache.h"
+#include "glt_texture_streamer.h"
+#include "glt_uploader.h"
+#include "glt_container.h"
+
+typedef struct texture_job_t texture_job_t;
+
+typedef struct texture_cache_entry_t texture_cache_entry_t;
+
+typedef struct texture_stream_t texture_stream_t;
+
+typedef struct upload_job_t upload_job_t;
+
+struct glt_texture_t {
+    GLuint id;
+    GLsizei width;
+    GLsizei height;
+    glt_texture_state_e state;
+    GLuint sampler;
+    glt_texture_loader_t *loader;
+    texture_job_t *job;
+    glt_texture_cache_t *cache;
+    texture_cache_entry_t *cache_entry;
+    glt_texture_streamer_t *streamer;
+    texture_stream_t *stream;
+    glt_uploader_t *uploader;
+    upload_job_t *upload;
+    size_t bytes;
+};
+
+// uploads the container's levels, which may point into any caller-owned memory
+glt_texture_t *glt_texture_create_from_container(const glt_container_t *container, const glt_texture_options_t *options);
+
+// flips, expands RGB to RGBA and applies max_size / premultiply_alpha; takes ownership of a
+// malloc'd (stbi) image and returns one to release with free, NULL on failure; options may be NULL
+unsigned char *glt_texture_prepare_pixels(
+    unsigned char *pixels, int *width, int *height, int *channels, const glt_texture_options_t *options
+);
+
+// levels of the full chain down to 1x1
+GLint glt_texture_mip_count(GLsizei width, GLsizei height);
+
+bool glt_texture_choose_formats(int channels, bool srgb, GLenum *internal_format, GLenum *format);
+
+// three-channel formats are counted as padded to four
+size_t glt_texture_mip_chain_bytes(GLsizei width, GLsizei height, int channels, GLint levels);
+
+bool glt_texture_compressed_format_supported(GLenum format);
+
+// estimated bytes per texel of a sized render target format
+size_t glt_texture_format_bytes(GLenum format);
+
+// framebuffer attachment point of a depth and/or stencil format
+GLenum glt_texture_depth_attachment_point(GLenum format);
+
+// storage for the texture bound to target (GL_TEXTURE_2D, or GL_TEXTURE_2D_ARRAY with depth layers):
+// immutable from OpenGL 4.2 on, glTexImage levels capped by GL_TEXTURE_MAX_LEVEL before
+void glt_texture_allocate(
+    GLenum target, GLint levels, GLenum internal_format, GLsizei width, GLsizei height, GLsizei depth
+);
+
+// single level, uninitialized storage for rendering into; NULL on failure
+glt_texture_t *glt_texture_create_render_target(GLenum format, GLsizei width, GLsizei height);
+
+// decodes an image or parses a container and uploads it into a new texture of the current context,
+// 0 on failure; touches no shared glt state, so it also runs on threads with a shared context
+GLuint glt_texture_create_gl(
+    const unsigned char *data, size_t size, const glt_texture_options_t *options, int *w, int *h, size_t *bytes
+);
+
+// malloc'd file contents followed by a nul that out_size doesn't count, NULL on failure or an empty file
+unsigned char *glt_texture_read_file(const char *path, size_t *out_size);
+
+// called by glt_texture_destroy for textures that are still pending
+void glt_texture_loader_detach(glt_texture_loader_t *loader, glt_texture_t *texture);
+
+// called by glt_texture_destroy for streamed textures
+void glt_texture_streamer_detach(glt_texture_streamer_t *streamer, glt_texture_t *texture);
+
+// called by glt_texture_destroy for textures still uploading on a glt_uploader_t
+void glt_uploader_detach(glt_uploader_t *uploader, glt_texture_t *texture);
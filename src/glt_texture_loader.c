@@ -0,0 +1,492 @@
+#include "glt_texture_loader.h"
+#include "glt_texture_internal.h"
+#include "glt_job_queue.h"
+#include "glt_stats.h"
+#include "glt_trace.h"
+#include "glt_debug.h"
+#include "glt_log.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stb_image.h"
+
+#define LOADER_LOG(level, msg, ...)    glt_log(level, "[TEXTURE LOADER]: " msg, ##__VA_ARGS__)
+
+struct texture_job_t {
+    glt_texture_loader_t *loader;
+    glt_texture_t *texture; // GL thread only, NULL once the texture was destroyed
+    char *path;
+
+    // written by the worker before the job is queued as decoded
+    unsigned char *pixels;
+    int width;
+    int height;
+    int channels;
+
+    // upload progress, GL thread only
+    GLuint id;
+    int rows_uploaded;
+
+    texture_job_t *prev;
+    texture_job_t *next;
+    texture_job_t *next_decoded;
+};
+
+typedef struct {
+    texture_job_t *job;
+    int rows;
+    size_t offset;
+} upload_region_t;
+
+struct glt_texture_loader_t {
+    glt_job_queue_t *workers;
+    atomic_bool shutting_down;
+
+    // filled by workers, drained by update
+    pthread_mutex_t mutex;
+    texture_job_t *decoded_head;
+    texture_job_t *decoded_tail;
+
+    // GL thread only
+    texture_job_t *jobs;
+    texture_job_t *upload_head;
+    texture_job_t *upload_tail;
+    size_t pending;
+    size_t budget;
+    GLuint pbo;
+    GLuint placeholder;
+    upload_region_t *regions;
+    size_t regions_cap;
+};
+
+// helper funcs
+
+static void decode_job(void *user);
+
+static void collect_decoded(glt_texture_loader_t *loader);
+
+static bool begin_upload(texture_job_t *job);
+
+static void upload_regions(glt_texture_loader_t *loader, size_t count, size_t capacity);
+
+static void finish_job(glt_texture_loader_t *loader, texture_job_t *job, bool ok);
+
+static void free_job(glt_texture_loader_t *loader, texture_job_t *job);
+
+static bool push_region(glt_texture_loader_t *loader, size_t index, texture_job_t *job, int rows, size_t offset);
+
+static GLuint create_placeholder(void);
+
+// public funcs
+
+glt_texture_loader_t *glt_texture_loader_create(int n_threads, size_t upload_budget) {
+    glt_texture_loader_t *loader = calloc(1, sizeof(glt_texture_loader_t));
+    if (!loader) {
+        LOADER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+
+    atomic_init(&loader->shutting_down, false);
+    pthread_mutex_init(&loader->mutex, NULL);
+    loader->budget = upload_budget ? upload_budget : GLT_TEXTURE_UPLOAD_BUDGET_DEFAULT;
+
+    loader->workers = glt_job_queue_create(n_threads);
+    if (!loader->workers) {
+        LOADER_LOG(GLT_LOG_ERROR, "failed to start worker pool");
+        pthread_mutex_destroy(&loader->mutex);
+        free(loader);
+        return NULL;
+    }
+
+    glGenBuffers(1, &loader->pbo);
+    loader->placeholder = create_placeholder();
+    if (!loader->pbo || !loader->placeholder) {
+        LOADER_LOG(GLT_LOG_ERROR, "failed to create GL objects");
+        glt_texture_loader_destroy(loader);
+        return NULL;
+    }
+
+    return loader;
+}
+
+void glt_texture_loader_destroy(glt_texture_loader_t *loader) {
+    if (!loader) {
+        return;
+    }
+
+    // workers skip decoding from now on, so draining the pool is quick
+    atomic_store(&loader->shutting_down, true);
+    glt_job_queue_destroy(loader->workers);
+
+    while (loader->jobs) {
+        texture_job_t *job = loader->jobs;
+        if (job->texture) {
+            job->texture->state = GLT_TEXTURE_FAILED;
+            job->texture->loader = NULL;
+            job->texture->job = NULL;
+        }
+        free_job(loader, job);
+    }
+
+    if (loader->pbo) {
+        glDeleteBuffers(1, &loader->pbo);
+    }
+    if (loader->placeholder) {
+        glDeleteTextures(1, &loader->placeholder);
+    }
+    pthread_mutex_destroy(&loader->mutex);
+    free(loader->regions);
+    free(loader);
+}
+
+glt_texture_t *glt_texture_load_async(glt_texture_loader_t *loader, const char *path) {
+    if (!loader || !path) {
+        return NULL;
+    }
+
+    glt_texture_t *tex = malloc(sizeof(glt_texture_t));
+    texture_job_t *job = calloc(1, sizeof(texture_job_t));
+    char *path_copy = malloc(strlen(path) + 1);
+    if (!tex || !job || !path_copy) {
+        LOADER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        free(tex);
+        free(job);
+        free(path_copy);
+        return NULL;
+    }
+    strcpy(path_copy, path);
+
+    tex->id = 0;
+    tex->width = 0;
+    tex->height = 0;
+    tex->state = GLT_TEXTURE_PENDING;
+    tex->sampler = glt_sampler_get(NULL);
+    tex->loader = loader;
+    tex->job = job;
+    tex->cache = NULL;
+    tex->cache_entry = NULL;
+    tex->streamer = NULL;
+    tex->stream = NULL;
+    tex->uploader = NULL;
+    tex->upload = NULL;
+    tex->bytes = 0;
+
+    job->loader = loader;
+    job->texture = tex;
+    job->path = path_copy;
+
+    job->next = loader->jobs;
+    if (loader->jobs) {
+        loader->jobs->prev = job;
+    }
+    loader->jobs = job;
+    loader->pending++;
+
+    if (!glt_job_queue_push(loader->workers, decode_job, job)) {
+        free_job(loader, job);
+        free(tex);
+        return NULL;
+    }
+
+    return tex;
+}
+
+void glt_texture_loader_update(glt_texture_loader_t *loader) {
+    if (!loader) {
+        return;
+    }
+    GLT_ZONE("glt_texture_loader_update");
+
+    collect_decoded(loader);
+    if (!loader->upload_head) {
+        return;
+    }
+
+    // a single row always fits, even when it is larger than the budget
+    size_t capacity = loader->budget;
+    for (texture_job_t *job = loader->upload_head; job; job = job->next_decoded) {
+        if (job->texture && job->pixels) {
+            const size_t row_bytes = (size_t) job->width * (size_t) job->channels;
+            capacity = row_bytes > capacity ? row_bytes : capacity;
+            break;
+        }
+    }
+
+    // plan this frame's regions and allocate storage for textures seen the first time
+    size_t regions_count = 0;
+    size_t used = 0;
+    for (texture_job_t *job = loader->upload_head; job && used < capacity; job = job->next_decoded) {
+        if (!job->texture || !job->pixels) {
+            continue;
+        }
+        if (!job->id && !begin_upload(job)) {
+            job->rows_uploaded = job->height;
+            continue;
+        }
+
+        const size_t row_bytes = (size_t) job->width * (size_t) job->channels;
+        int rows = job->height - job->rows_uploaded;
+        if ((size_t) rows * row_bytes > capacity - used) {
+            rows = (int) ((capacity - used) / row_bytes);
+        }
+        if (rows <= 0 || !push_region(loader, regions_count, job, rows, used)) {
+            break;
+        }
+        used += (size_t) rows * row_bytes;
+        regions_count++;
+    }
+
+    if (regions_count > 0) {
+        upload_regions(loader, regions_count, capacity);
+    }
+
+    while (loader->upload_head) {
+        texture_job_t *job = loader->upload_head;
+        if (job->texture && job->pixels && job->rows_uploaded < job->height) {
+            break;
+        }
+        loader->upload_head = job->next_decoded;
+        if (!loader->upload_head) {
+            loader->upload_tail = NULL;
+        }
+        finish_job(loader, job, job->id != 0);
+    }
+}
+
+void glt_texture_loader_set_budget(glt_texture_loader_t *loader, size_t upload_budget) {
+    if (loader) {
+        loader->budget = upload_budget ? upload_budget : GLT_TEXTURE_UPLOAD_BUDGET_DEFAULT;
+    }
+}
+
+size_t glt_texture_loader_get_pending(const glt_texture_loader_t *loader) {
+    return loader ? loader->pending : 0;
+}
+
+GLuint glt_texture_loader_get_placeholder(const glt_texture_loader_t *loader) {
+    return loader ? loader->placeholder : 0;
+}
+
+// internal funcs
+
+void glt_texture_loader_detach(glt_texture_loader_t *loader, glt_texture_t *texture) {
+    if (!loader || !texture || !texture->job) {
+        return;
+    }
+    // the job stays alive until the worker hands it back, update then frees it
+    texture->job->texture = NULL;
+    texture->job = NULL;
+    texture->loader = NULL;
+}
+
+// helper funcs
+
+static void decode_job(void *user) {
+    texture_job_t *job = user;
+    glt_texture_loader_t *loader = job->loader;
+    GLT_ZONE("texture decode");
+
+    if (!atomic_load(&loader->shutting_down)) {
+        job->pixels = stbi_load(job->path, &job->width, &job->height, &job->channels, 0);
+        if (!job->pixels) {
+            LOADER_LOG(GLT_LOG_ERROR, "failed to load image '%s': %s", job->path, stbi_failure_reason());
+        } else {
+            // pixel conversion stays on the worker too
+            job->pixels = glt_texture_prepare_pixels(job->pixels, &job->width, &job->height, &job->channels, NULL);
+        }
+    }
+
+    pthread_mutex_lock(&loader->mutex);
+    if (loader->decoded_tail) {
+        loader->decoded_tail->next_decoded = job;
+    } else {
+        loader->decoded_head = job;
+    }
+    loader->decoded_tail = job;
+    pthread_mutex_unlock(&loader->mutex);
+}
+
+static void collect_decoded(glt_texture_loader_t *loader) {
+    pthread_mutex_lock(&loader->mutex);
+    texture_job_t *head = loader->decoded_head;
+    texture_job_t *tail = loader->decoded_tail;
+    loader->decoded_head = NULL;
+    loader->decoded_tail = NULL;
+    pthread_mutex_unlock(&loader->mutex);
+
+    if (!head) {
+        return;
+    }
+
+    for (texture_job_t *job = head; job; job = job->next_decoded) {
+        GLenum internal_format = 0, format = 0;
+        if (job->pixels && !glt_texture_choose_formats(job->channels, false, &internal_format, &format)) {
+            LOADER_LOG(GLT_LOG_ERROR, "unsupported channel count %d in '%s'", job->channels, job->path);
+            free(job->pixels);
+            job->pixels = NULL;
+        }
+        if (job->texture && job->pixels) {
+            job->texture->width = job->width;
+            job->texture->height = job->height;
+        }
+    }
+
+    if (loader->upload_tail) {
+        loader->upload_tail->next_decoded = head;
+    } else {
+        loader->upload_head = head;
+    }
+    loader->upload_tail = tail;
+}
+
+static bool begin_upload(texture_job_t *job) {
+    GLenum internal_format = 0, format = 0;
+    glt_texture_choose_formats(job->channels, false, &internal_format, &format);
+
+    glGenTextures(1, &job->id);
+    if (!job->id) {
+        LOADER_LOG(GLT_LOG_ERROR, "failed to create texture for '%s'", job->path);
+        return false;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, job->id);
+    glt_texture_allocate(
+        GL_TEXTURE_2D, glt_texture_mip_count(job->width, job->height), internal_format,
+        job->width, job->height, 1
+    );
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+static void upload_regions(glt_texture_loader_t *loader, size_t count, size_t capacity) {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, loader->pbo);
+    // orphan the previous frame's storage so mapping never waits on pending uploads
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) capacity, NULL, GL_STREAM_DRAW);
+    unsigned char *dst = glMapBufferRange(
+        GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr) capacity,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+    );
+    if (!dst) {
+        LOADER_LOG(GLT_LOG_ERROR, "failed to map pixel unpack buffer");
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const upload_region_t *region = &loader->regions[i];
+        const texture_job_t *job = region->job;
+        const size_t row_bytes = (size_t) job->width * (size_t) job->channels;
+        const unsigned char *src = job->pixels + (size_t) job->rows_uploaded * row_bytes;
+        memcpy(dst + region->offset, src, (size_t) region->rows * row_bytes);
+    }
+
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    GLint prev_unpack = 0;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prev_unpack);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    for (size_t i = 0; i < count; ++i) {
+        const upload_region_t *region = &loader->regions[i];
+        texture_job_t *job = region->job;
+
+        GLenum internal_format = 0, format = 0;
+        glt_texture_choose_formats(job->channels, false, &internal_format, &format);
+
+        glBindTexture(GL_TEXTURE_2D, job->id);
+        glTexSubImage2D(
+            GL_TEXTURE_2D, 0, 0, job->rows_uploaded, job->width, region->rows,
+            format, GL_UNSIGNED_BYTE, (const void *) region->offset
+        );
+        glt_stats_add(GLT_STAT_TEXTURE_UPLOADS, 1);
+        glt_stats_add(GLT_STAT_TEXTURE_UPLOAD_BYTES, (uint64_t) region->rows * (uint64_t) job->width * (uint64_t) job->channels);
+        job->rows_uploaded += region->rows;
+        if (job->rows_uploaded == job->height) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prev_unpack);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+static void finish_job(glt_texture_loader_t *loader, texture_job_t *job, bool ok) {
+    glt_texture_t *tex = job->texture;
+    if (tex) {
+        // the texture may outlive the loader, so it must not keep pointing at it
+        tex->job = NULL;
+        tex->loader = NULL;
+        if (ok && job->pixels) {
+            tex->id = job->id;
+            tex->state = GLT_TEXTURE_READY;
+            glt_debug_label(GL_TEXTURE, tex->id, job->path);
+            tex->bytes = glt_texture_mip_chain_bytes(
+                job->width, job->height, job->channels, glt_texture_mip_count(job->width, job->height)
+            );
+            glt_stats_track_resource(GLT_RESOURCE_TEXTURE, 1, (int64_t) tex->bytes);
+            job->id = 0;
+        } else {
+            tex->state = GLT_TEXTURE_FAILED;
+        }
+    }
+    free_job(loader, job);
+}
+
+static void free_job(glt_texture_loader_t *loader, texture_job_t *job) {
+    if (job->prev) {
+        job->prev->next = job->next;
+    } else {
+        loader->jobs = job->next;
+    }
+    if (job->next) {
+        job->next->prev = job->prev;
+    }
+    loader->pending--;
+
+    if (job->id) {
+        glDeleteTextures(1, &job->id);
+    }
+    if (job->pixels) {
+        free(job->pixels);
+    }
+    free(job->path);
+    free(job);
+}
+
+static bool push_region(glt_texture_loader_t *loader, size_t index, texture_job_t *job, int rows, size_t offset) {
+    if (index == loader->regions_cap) {
+        const size_t cap = loader->regions_cap ? loader->regions_cap * 2 : 16;
+        upload_region_t *regions = realloc(loader->regions, cap * sizeof(upload_region_t));
+        if (!regions) {
+            LOADER_LOG(GLT_LOG_ERROR, "failed to allocate upload regions");
+            return false;
+        }
+        loader->regions = regions;
+        loader->regions_cap = cap;
+    }
+
+    loader->regions[index].job = job;
+    loader->regions[index].rows = rows;
+    loader->regions[index].offset = offset;
+    return true;
+}
+
+static GLuint create_placeholder(void) {
+    static const unsigned char grey[4] = {128, 128, 128, 255};
+
+    GLuint id = 0;
+    glGenTextures(1, &id);
+    if (!id) {
+        return 0;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, id);
+    glt_texture_allocate(GL_TEXTURE_2D, 1, GL_RGBA8, 1, 1, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, grey);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return id;
+}
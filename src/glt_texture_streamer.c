@@ -0,0 +1,676 @@
+#include "glt_texture_streamer.h"
+#include "glt_texture_internal.h"
+#include "glt_container.h"
+#include "glt_image.h"
+#include "glt_job_queue.h"
+#include "glt_stats.h"
+#include "glt_trace.h"
+#include "glt_log.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stb_image.h"
+
+#define STREAMER_LOG(level, msg, ...)    glt_log(level, "[TEXTURE STREAMER]: " msg, ##__VA_ARGS__)
+
+// levels up to this size are uploaded as soon as the image is decoded
+#define TAIL_SIZE 64
+
+struct texture_stream_t {
+    glt_texture_streamer_t *streamer;
+    glt_texture_t *texture; // GL thread only, NULL once the texture was destroyed
+    char *path;
+    glt_texture_options_t options;
+
+    // written by the worker before the stream is queued as decoded
+    unsigned char *data; // file contents for containers, the decoded mip chain otherwise
+    glt_container_t source;
+    bool ok;
+
+    // GL thread only, levels index the source chain
+    bool decoded;
+    GLint tail;
+    GLint allocated; // finest level in the storage, source.levels when there is none
+    GLint resident; // finest level uploaded, sampling is clamped to it
+    GLint wanted; // finest level requested this frame, source.levels if none
+    GLint target;
+    uint64_t last_request;
+    size_t bytes;
+
+    texture_stream_t *prev;
+    texture_stream_t *next;
+    texture_stream_t *next_decoded;
+};
+
+struct glt_texture_streamer_t {
+    glt_job_queue_t *workers;
+    atomic_bool shutting_down;
+
+    // filled by workers, drained by update
+    pthread_mutex_t mutex;
+    texture_stream_t *decoded_head;
+    texture_stream_t *decoded_tail;
+
+    // GL thread only
+    texture_stream_t *streams;
+    size_t pending;
+    size_t budget;
+    size_t upload_budget;
+    size_t usage;
+    uint64_t frame;
+    GLuint placeholder;
+};
+
+// helper funcs
+
+static void decode_stream(void *user);
+
+static bool build_mip_chain(texture_stream_t *stream, unsigned char *pixels, int width, int height);
+
+static void collect_decoded(glt_texture_streamer_t *streamer);
+
+static bool activate_stream(glt_texture_streamer_t *streamer, texture_stream_t *stream);
+
+static void stream_levels(glt_texture_streamer_t *streamer, texture_stream_t *stream, size_t *uploaded);
+
+static bool make_room(glt_texture_streamer_t *streamer, const texture_stream_t *keep, size_t needed);
+
+static bool resize_storage(glt_texture_streamer_t *streamer, texture_stream_t *stream, GLint finest);
+
+static void upload_level(const texture_stream_t *stream, GLint level);
+
+static void set_base_level(const texture_stream_t *stream);
+
+static size_t storage_bytes(const texture_stream_t *stream, GLint finest);
+
+static void fail_stream(glt_texture_streamer_t *streamer, texture_stream_t *stream);
+
+static void free_stream(glt_texture_streamer_t *streamer, texture_stream_t *stream);
+
+static GLuint create_placeholder(void);
+
+// public funcs
+
+glt_texture_streamer_t *glt_texture_streamer_create(int n_threads, size_t budget) {
+    glt_texture_streamer_t *streamer = calloc(1, sizeof(glt_texture_streamer_t));
+    if (!streamer) {
+        STREAMER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+
+    atomic_init(&streamer->shutting_down, false);
+    pthread_mutex_init(&streamer->mutex, NULL);
+    streamer->budget = budget ? budget : GLT_TEXTURE_STREAM_BUDGET_DEFAULT;
+    streamer->upload_budget = GLT_TEXTURE_UPLOAD_BUDGET_DEFAULT;
+
+    streamer->workers = glt_job_queue_create(n_threads);
+    if (!streamer->workers) {
+        STREAMER_LOG(GLT_LOG_ERROR, "failed to start worker pool");
+        pthread_mutex_destroy(&streamer->mutex);
+        free(streamer);
+        return NULL;
+    }
+
+    streamer->placeholder = create_placeholder();
+    if (!streamer->placeholder) {
+        STREAMER_LOG(GLT_LOG_ERROR, "failed to create GL objects");
+        glt_texture_streamer_destroy(streamer);
+        return NULL;
+    }
+
+    return streamer;
+}
+
+void glt_texture_streamer_destroy(glt_texture_streamer_t *streamer) {
+    if (!streamer) {
+        return;
+    }
+
+    // workers skip decoding from now on, so draining the pool is quick
+    atomic_store(&streamer->shutting_down, true);
+    glt_job_queue_destroy(streamer->workers);
+
+    while (streamer->streams) {
+        texture_stream_t *stream = streamer->streams;
+        if (stream->texture) {
+            if (!stream->decoded) {
+                stream->texture->state = GLT_TEXTURE_FAILED;
+            }
+            stream->texture->streamer = NULL;
+            stream->texture->stream = NULL;
+        }
+        free_stream(streamer, stream);
+    }
+
+    if (streamer->placeholder) {
+        glDeleteTextures(1, &streamer->placeholder);
+    }
+    pthread_mutex_destroy(&streamer->mutex);
+    free(streamer);
+}
+
+glt_texture_t *glt_texture_stream(
+    glt_texture_streamer_t *streamer, const char *path, const glt_texture_options_t *options
+) {
+    if (!streamer || !path) {
+        return NULL;
+    }
+
+    glt_texture_t *tex = malloc(sizeof(glt_texture_t));
+    texture_stream_t *stream = calloc(1, sizeof(texture_stream_t));
+    char *path_copy = malloc(strlen(path) + 1);
+    if (!tex || !stream || !path_copy) {
+        STREAMER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        free(tex);
+        free(stream);
+        free(path_copy);
+        return NULL;
+    }
+    strcpy(path_copy, path);
+
+    if (options) {
+        stream->options = *options;
+    }
+    stream->streamer = streamer;
+    stream->texture = tex;
+    stream->path = path_copy;
+
+    tex->id = 0;
+    tex->width = 0;
+    tex->height = 0;
+    tex->state = GLT_TEXTURE_PENDING;
+    tex->sampler = glt_sampler_get(&stream->options.sampler);
+    tex->loader = NULL;
+    tex->job = NULL;
+    tex->cache = NULL;
+    tex->cache_entry = NULL;
+    tex->streamer = streamer;
+    tex->stream = stream;
+    tex->uploader = NULL;
+    tex->upload = NULL;
+    tex->bytes = 0;
+
+    stream->next = streamer->streams;
+    if (streamer->streams) {
+        streamer->streams->prev = stream;
+    }
+    streamer->streams = stream;
+    streamer->pending++;
+
+    if (!glt_job_queue_push(streamer->workers, decode_stream, stream)) {
+        free_stream(streamer, stream);
+        free(tex);
+        return NULL;
+    }
+
+    return tex;
+}
+
+void glt_texture_streamer_request(
+    glt_texture_streamer_t *streamer, glt_texture_t *texture, float screen_width, float screen_height
+) {
+    if (!streamer || !texture || texture->streamer != streamer || !texture->stream) {
+        return;
+    }
+    texture_stream_t *stream = texture->stream;
+    if (!stream->decoded || screen_width <= 0.f || screen_height <= 0.f) {
+        return;
+    }
+
+    // the axis with more texels per pixel would alias less, the other one picks the level
+    const float ratio_x = (float) stream->source.width / screen_width;
+    const float ratio_y = (float) stream->source.height / screen_height;
+    const float ratio = ratio_x < ratio_y ? ratio_x : ratio_y;
+
+    GLint level = ratio > 1.f ? (GLint) floorf(log2f(ratio)) : 0;
+    if (level > stream->source.levels - 1) {
+        level = stream->source.levels - 1;
+    }
+    if (level < stream->wanted) {
+        stream->wanted = level;
+    }
+    stream->last_request = streamer->frame;
+}
+
+void glt_texture_streamer_update(glt_texture_streamer_t *streamer) {
+    if (!streamer) {
+        return;
+    }
+    GLT_ZONE("glt_texture_streamer_update");
+
+    collect_decoded(streamer);
+
+    // targets first, eviction compares against every stream's current one
+    for (texture_stream_t *stream = streamer->streams; stream; stream = stream->next) {
+        if (stream->decoded && stream->texture) {
+            stream->target = stream->wanted < stream->tail ? stream->wanted : stream->tail;
+            stream->wanted = stream->source.levels;
+        }
+    }
+
+    GLint prev_unpack = 0;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prev_unpack);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    size_t uploaded = 0;
+    for (texture_stream_t *stream = streamer->streams; stream; stream = stream->next) {
+        if (stream->decoded && stream->texture && stream->target < stream->resident) {
+            stream_levels(streamer, stream, &uploaded);
+        }
+    }
+
+    // the budget may have been lowered since the last frame
+    make_room(streamer, NULL, 0);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prev_unpack);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    streamer->frame++;
+}
+
+void glt_texture_streamer_set_budget(glt_texture_streamer_t *streamer, size_t budget) {
+    if (streamer) {
+        streamer->budget = budget ? budget : GLT_TEXTURE_STREAM_BUDGET_DEFAULT;
+    }
+}
+
+void glt_texture_streamer_set_upload_budget(glt_texture_streamer_t *streamer, size_t upload_budget) {
+    if (streamer) {
+        streamer->upload_budget = upload_budget ? upload_budget : GLT_TEXTURE_UPLOAD_BUDGET_DEFAULT;
+    }
+}
+
+size_t glt_texture_streamer_get_usage(const glt_texture_streamer_t *streamer) {
+    return streamer ? streamer->usage : 0;
+}
+
+size_t glt_texture_streamer_get_pending(const glt_texture_streamer_t *streamer) {
+    return streamer ? streamer->pending : 0;
+}
+
+GLuint glt_texture_streamer_get_placeholder(const glt_texture_streamer_t *streamer) {
+    return streamer ? streamer->placeholder : 0;
+}
+
+GLint glt_texture_streamer_get_resident_level(const glt_texture_t *texture) {
+    if (!texture || texture->state != GLT_TEXTURE_READY) {
+        return -1;
+    }
+    return texture->stream ? texture->stream->resident : 0;
+}
+
+// internal funcs
+
+void glt_texture_streamer_detach(glt_texture_streamer_t *streamer, glt_texture_t *texture) {
+    if (!streamer || !texture || !texture->stream) {
+        return;
+    }
+
+    texture_stream_t *stream = texture->stream;
+    texture->stream = NULL;
+    texture->streamer = NULL;
+    stream->texture = NULL;
+
+    // the storage goes away with the texture; undecoded streams are freed once the worker hands them back
+    streamer->usage -= stream->bytes;
+    stream->bytes = 0;
+    if (stream->decoded) {
+        free_stream(streamer, stream);
+    }
+}
+
+// helper funcs
+
+static void decode_stream(void *user) {
+    texture_stream_t *stream = user;
+    glt_texture_streamer_t *streamer = stream->streamer;
+    GLT_ZONE("texture stream decode");
+
+    if (!atomic_load(&streamer->shutting_down)) {
+        size_t size = 0;
+        unsigned char *data = glt_texture_read_file(stream->path, &size);
+        if (!data) {
+            STREAMER_LOG(GLT_LOG_ERROR, "can't read file: '%s'", stream->path);
+        } else if (glt_container_is_known(data, size)) {
+            stream->data = data;
+            stream->ok = glt_container_parse(data, size, &stream->source);
+            if (stream->ok && stream->options.mip_levels > 0 && stream->options.mip_levels < stream->source.levels) {
+                stream->source.levels = stream->options.mip_levels;
+            }
+        } else {
+            int width = 0, height = 0, channels = 0;
+            unsigned char *pixels = stbi_load_from_memory(data, (int) size, &width, &height, &channels, 4);
+            free(data);
+            if (!pixels) {
+                STREAMER_LOG(GLT_LOG_ERROR, "failed to load image '%s': %s", stream->path, stbi_failure_reason());
+            } else {
+                channels = 4;
+                pixels = glt_texture_prepare_pixels(pixels, &width, &height, &channels, &stream->options);
+                stream->ok = pixels && build_mip_chain(stream, pixels, width, height);
+            }
+        }
+    }
+
+    pthread_mutex_lock(&streamer->mutex);
+    if (streamer->decoded_tail) {
+        streamer->decoded_tail->next_decoded = stream;
+    } else {
+        streamer->decoded_head = stream;
+    }
+    streamer->decoded_tail = stream;
+    pthread_mutex_unlock(&streamer->mutex);
+}
+
+static bool build_mip_chain(texture_stream_t *stream, unsigned char *pixels, int width, int height) {
+    GLint levels = glt_texture_mip_count(width, height);
+    if (levels > GLT_CONTAINER_MAX_LEVELS) {
+        levels = GLT_CONTAINER_MAX_LEVELS;
+    }
+    if (stream->options.mip_levels > 0 && stream->options.mip_levels < levels) {
+        levels = stream->options.mip_levels;
+    }
+
+    const size_t total = glt_texture_mip_chain_bytes(width, height, 4, levels);
+    unsigned char *chain = malloc(total);
+    if (!chain) {
+        STREAMER_LOG(GLT_LOG_ERROR, "failed to allocate %zu bytes", total);
+        free(pixels);
+        return false;
+    }
+
+    glt_container_t *source = &stream->source;
+    source->compressed = false;
+    source->internal_format = stream->options.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+    source->format = GL_RGBA;
+    source->type = GL_UNSIGNED_BYTE;
+    source->width = width;
+    source->height = height;
+    source->levels = levels;
+
+    // each level is filtered from the previous one, a failed resize truncates the chain
+    size_t offset = 0;
+    unsigned char *level = pixels;
+    for (GLint i = 0; i < levels; ++i) {
+        const size_t size = (size_t) width * (size_t) height * 4;
+        memcpy(chain + offset, level, size);
+        source->level[i].data = chain + offset;
+        source->level[i].size = size;
+        source->level[i].width = width;
+        source->level[i].height = height;
+        offset += size;
+
+        if (i + 1 == levels) {
+            break;
+        }
+        const int next_width = width > 1 ? width / 2 : 1;
+        const int next_height = height > 1 ? height / 2 : 1;
+        unsigned char *next = glt_image_resize(
+            level, width, height, next_width, next_height, GLT_IMAGE_FILTER_BOX, stream->options.srgb
+        );
+        if (!next) {
+            source->levels = i + 1;
+            break;
+        }
+        free(level);
+        level = next;
+        width = next_width;
+        height = next_height;
+    }
+    free(level);
+
+    stream->data = chain;
+    return true;
+}
+
+static void collect_decoded(glt_texture_streamer_t *streamer) {
+    pthread_mutex_lock(&streamer->mutex);
+    texture_stream_t *stream = streamer->decoded_head;
+    streamer->decoded_head = NULL;
+    streamer->decoded_tail = NULL;
+    pthread_mutex_unlock(&streamer->mutex);
+
+    while (stream) {
+        texture_stream_t *next = stream->next_decoded;
+        stream->next_decoded = NULL;
+        stream->decoded = true;
+        streamer->pending--;
+
+        if (!stream->texture) {
+            free_stream(streamer, stream);
+        } else if (!stream->ok || !activate_stream(streamer, stream)) {
+            fail_stream(streamer, stream);
+        }
+        stream = next;
+    }
+}
+
+static bool activate_stream(glt_texture_streamer_t *streamer, texture_stream_t *stream) {
+    const glt_container_t *source = &stream->source;
+    if (source->compressed && !glt_texture_compressed_format_supported(source->internal_format)) {
+        STREAMER_LOG(
+            GLT_LOG_ERROR, "compressed format 0x%04X of '%s' is not supported", source->internal_format, stream->path
+        );
+        return false;
+    }
+
+    stream->tail = source->levels - 1;
+    for (GLint i = 0; i < source->levels; ++i) {
+        if (source->level[i].width <= TAIL_SIZE && source->level[i].height <= TAIL_SIZE) {
+            stream->tail = i;
+            break;
+        }
+    }
+    stream->allocated = source->levels;
+    stream->resident = source->levels;
+    stream->wanted = source->levels;
+    stream->target = stream->tail;
+
+    if (!resize_storage(streamer, stream, stream->tail)) {
+        return false;
+    }
+
+    // the tail is small, it goes up regardless of the upload budget
+    GLint prev_unpack = 0;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prev_unpack);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (GLint i = source->levels - 1; i >= stream->tail; --i) {
+        upload_level(stream, i);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prev_unpack);
+
+    stream->resident = stream->tail;
+    set_base_level(stream);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    stream->texture->width = source->width;
+    stream->texture->height = source->height;
+    stream->texture->state = GLT_TEXTURE_READY;
+    return true;
+}
+
+static void stream_levels(glt_texture_streamer_t *streamer, texture_stream_t *stream, size_t *uploaded) {
+    // the storage grows once to the target, then levels fill in coarse to fine
+    GLint finest = stream->target;
+    if (finest < stream->allocated) {
+        while (finest < stream->allocated
+               && !make_room(streamer, stream, storage_bytes(stream, finest) - stream->bytes)) {
+            finest++;
+        }
+        if (finest < stream->allocated && !resize_storage(streamer, stream, finest)) {
+            return;
+        }
+    }
+
+    const GLint limit = stream->allocated > stream->target ? stream->allocated : stream->target;
+    const GLint previous = stream->resident;
+    while (stream->resident > limit) {
+        const size_t size = stream->source.level[stream->resident - 1].size;
+        // one level always fits, even when it is larger than the budget
+        if (*uploaded > 0 && *uploaded + size > streamer->upload_budget) {
+            break;
+        }
+        upload_level(stream, stream->resident - 1);
+        stream->resident--;
+        *uploaded += size;
+    }
+    if (stream->resident != previous) {
+        set_base_level(stream);
+    }
+}
+
+static bool make_room(glt_texture_streamer_t *streamer, const texture_stream_t *keep, size_t needed) {
+    while (streamer->usage + needed > streamer->budget) {
+        // least recently requested stream holding levels finer than its target
+        texture_stream_t *victim = NULL;
+        for (texture_stream_t *stream = streamer->streams; stream; stream = stream->next) {
+            if (stream == keep || !stream->decoded || !stream->texture || stream->allocated >= stream->target) {
+                continue;
+            }
+            if (!victim || stream->last_request < victim->last_request) {
+                victim = stream;
+            }
+        }
+        if (!victim || !resize_storage(streamer, victim, victim->target)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool resize_storage(glt_texture_streamer_t *streamer, texture_stream_t *stream, GLint finest) {
+    const glt_container_t *source = &stream->source;
+    glt_texture_t *tex = stream->texture;
+
+    GLuint id = 0;
+    glGenTextures(1, &id);
+    if (!id) {
+        STREAMER_LOG(GLT_LOG_ERROR, "failed to create texture for '%s'", stream->path);
+        return false;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, id);
+    glt_texture_allocate(
+        GL_TEXTURE_2D, source->levels - finest, source->internal_format,
+        source->level[finest].width, source->level[finest].height, 1
+    );
+
+    // levels both storages hold are copied on the GPU, or uploaded again without copy support
+    const GLint keep = stream->resident > finest ? stream->resident : finest;
+    const bool had_storage = tex->id != 0;
+    if (had_storage && glCopyImageSubData) {
+        for (GLint i = keep; i < source->levels; ++i) {
+            glCopyImageSubData(
+                tex->id, GL_TEXTURE_2D, i - stream->allocated, 0, 0, 0,
+                id, GL_TEXTURE_2D, i - finest, 0, 0, 0,
+                source->level[i].width, source->level[i].height, 1
+            );
+        }
+    }
+    if (had_storage) {
+        glDeleteTextures(1, &tex->id);
+    }
+
+    tex->id = id;
+    stream->allocated = finest;
+    stream->resident = keep;
+    if (had_storage && !glCopyImageSubData) {
+        for (GLint i = keep; i < source->levels; ++i) {
+            upload_level(stream, i);
+        }
+    }
+    set_base_level(stream);
+
+    const size_t bytes = storage_bytes(stream, finest);
+    glt_stats_track_resource(GLT_RESOURCE_TEXTURE, had_storage ? 0 : 1, (int64_t) bytes - (int64_t) tex->bytes);
+    streamer->usage = streamer->usage - stream->bytes + bytes;
+    stream->bytes = bytes;
+    tex->bytes = bytes;
+    return true;
+}
+
+static void upload_level(const texture_stream_t *stream, GLint level) {
+    const glt_container_t *source = &stream->source;
+    const glt_container_level_t *data = &source->level[level];
+
+    glBindTexture(GL_TEXTURE_2D, stream->texture->id);
+    if (source->compressed) {
+        glCompressedTexSubImage2D(
+            GL_TEXTURE_2D, level - stream->allocated, 0, 0, data->width, data->height,
+            source->internal_format, (GLsizei) data->size, data->data
+        );
+    } else {
+        glTexSubImage2D(
+            GL_TEXTURE_2D, level - stream->allocated, 0, 0, data->width, data->height,
+            source->format, source->type, data->data
+        );
+    }
+    glt_stats_add(GLT_STAT_TEXTURE_UPLOADS, 1);
+    glt_stats_add(GLT_STAT_TEXTURE_UPLOAD_BYTES, data->size);
+}
+
+static void set_base_level(const texture_stream_t *stream) {
+    // sampler objects override the texture's LOD range, the base level is texture-only state
+    glBindTexture(GL_TEXTURE_2D, stream->texture->id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, stream->resident - stream->allocated);
+}
+
+static size_t storage_bytes(const texture_stream_t *stream, GLint finest) {
+    size_t total = 0;
+    for (GLint i = finest; i < stream->source.levels; ++i) {
+        total += stream->source.level[i].size;
+    }
+    return total;
+}
+
+static void fail_stream(glt_texture_streamer_t *streamer, texture_stream_t *stream) {
+    glt_texture_t *tex = stream->texture;
+    if (tex->id) {
+        glDeleteTextures(1, &tex->id);
+        glt_stats_track_resource(GLT_RESOURCE_TEXTURE, -1, -(int64_t) tex->bytes);
+        tex->id = 0;
+    }
+    tex->state = GLT_TEXTURE_FAILED;
+    tex->bytes = 0;
+    tex->streamer = NULL;
+    tex->stream = NULL;
+    streamer->usage -= stream->bytes;
+    free_stream(streamer, stream);
+}
+
+static void free_stream(glt_texture_streamer_t *streamer, texture_stream_t *stream) {
+    if (stream->prev) {
+        stream->prev->next = stream->next;
+    } else {
+        streamer->streams = stream->next;
+    }
+    if (stream->next) {
+        stream->next->prev = stream->prev;
+    }
+    if (!stream->decoded) {
+        streamer->pending--;
+    }
+
+    free(stream->data);
+    free(stream->path);
+    free(stream);
+}
+
+static GLuint create_placeholder(void) {
+    static const unsigned char grey[4] = {128, 128, 128, 255};
+
+    GLuint id = 0;
+    glGenTextures(1, &id);
+    if (!id) {
+        return 0;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, id);
+    glt_texture_allocate(GL_TEXTURE_2D, 1, GL_RGBA8, 1, 1, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, grey);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return id;
+}
@@ -0,0 +1,257 @@
+#include "glt_time.h"
+#include "glt_log.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define TIME_LOG(level, msg, ...)    glt_log(level, "[TIME]: " msg, ##__VA_ARGS__)
+
+// granularity of the sleeping phase
+#define SLEEP_QUANTUM 0.001
+// share of each new sample in the sleep estimate, about the last 50 sleeps count
+#define SLEEP_ESTIMATE_WEIGHT 0.02
+
+struct glt_frame_clock_t {
+    double start;
+    double last;
+    double delta;
+    double period;
+    double deadline;
+    uint64_t frames;
+
+    double samples[GLT_FRAME_CLOCK_SAMPLES];
+    size_t sample_count;
+    size_t sample_next;
+};
+
+// exponentially weighted mean / variance of how long a SLEEP_QUANTUM sleep really takes,
+// so the estimate keeps following the system and one slow wakeup fades out again
+typedef struct {
+    double mean;
+    double variance;
+} sleep_estimate_t;
+
+static _Thread_local sleep_estimate_t sleep_estimate = {SLEEP_QUANTUM * 5, 0.0};
+
+// helper funcs
+
+static void os_sleep(double seconds);
+
+static int compare_doubles(const void *a, const void *b);
+
+// public funcs
+
+double glt_time_now(void) {
+    return (double) glt_time_now_ns() * 1e-9;
+}
+
+uint64_t glt_time_now_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    // split so the multiplication can't overflow
+    const uint64_t ticks = (uint64_t) counter.QuadPart;
+    const uint64_t freq = (uint64_t) frequency.QuadPart;
+    return ticks / freq * 1000000000u + ticks % freq * 1000000000u / freq;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+void glt_time_sleep_until(double deadline) {
+    sleep_estimate_t *est = &sleep_estimate;
+
+    for (;;) {
+        const double margin = est->mean + sqrt(est->variance);
+        const double start = glt_time_now();
+        if (deadline - start <= margin) {
+            break;
+        }
+
+        os_sleep(SLEEP_QUANTUM);
+        const double observed = glt_time_now() - start;
+
+        const double diff = observed - est->mean;
+        est->mean += SLEEP_ESTIMATE_WEIGHT * diff;
+        est->variance = (1.0 - SLEEP_ESTIMATE_WEIGHT) * (est->variance + SLEEP_ESTIMATE_WEIGHT * diff * diff);
+    }
+
+    while (glt_time_now() < deadline) {
+        // spin
+    }
+}
+
+void glt_time_sleep(double seconds) {
+    if (seconds > 0.0) {
+        glt_time_sleep_until(glt_time_now() + seconds);
+    }
+}
+
+glt_frame_clock_t *glt_frame_clock_create(void) {
+    glt_frame_clock_t *clock = calloc(1, sizeof(glt_frame_clock_t));
+    if (!clock) {
+        TIME_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+
+    clock->start = glt_time_now();
+    clock->last = clock->start;
+    return clock;
+}
+
+void glt_frame_clock_destroy(glt_frame_clock_t *clock) {
+    free(clock);
+}
+
+double glt_frame_clock_tick(glt_frame_clock_t *clock) {
+    if (!clock) {
+        return 0.0;
+    }
+
+    if (clock->period > 0.0) {
+        // deadlines advance by whole periods so pacing doesn't drift, a frame that ran
+        // more than a period late restarts the schedule instead of rushing to catch up
+        if (clock->deadline == 0.0) {
+            clock->deadline = clock->last + clock->period;
+        }
+        if (glt_time_now() > clock->deadline + clock->period) {
+            clock->deadline = glt_time_now();
+        } else {
+            glt_time_sleep_until(clock->deadline);
+        }
+        clock->deadline += clock->period;
+    }
+
+    const double now = glt_time_now();
+    clock->delta = now - clock->last;
+    clock->last = now;
+    clock->frames++;
+
+    clock->samples[clock->sample_next] = clock->delta;
+    clock->sample_next = (clock->sample_next + 1) % GLT_FRAME_CLOCK_SAMPLES;
+    if (clock->sample_count < GLT_FRAME_CLOCK_SAMPLES) {
+        clock->sample_count++;
+    }
+
+    return clock->delta;
+}
+
+void glt_frame_clock_set_limit(glt_frame_clock_t *clock, double fps) {
+    if (clock) {
+        clock->period = fps > 0.0 ? 1.0 / fps : 0.0;
+        clock->deadline = 0.0;
+    }
+}
+
+double glt_frame_clock_get_limit(const glt_frame_clock_t *clock) {
+    return clock && clock->period > 0.0 ? 1.0 / clock->period : 0.0;
+}
+
+double glt_frame_clock_get_delta(const glt_frame_clock_t *clock) {
+    return clock ? clock->delta : 0.0;
+}
+
+double glt_frame_clock_get_time(const glt_frame_clock_t *clock) {
+    return clock ? glt_time_now() - clock->start : 0.0;
+}
+
+uint64_t glt_frame_clock_get_frame_count(const glt_frame_clock_t *clock) {
+    return clock ? clock->frames : 0;
+}
+
+void glt_frame_clock_get_stats(const glt_frame_clock_t *clock, glt_frame_stats_t *stats) {
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(glt_frame_stats_t));
+    if (!clock || clock->sample_count == 0) {
+        return;
+    }
+
+    double sorted[GLT_FRAME_CLOCK_SAMPLES];
+    const size_t n = clock->sample_count;
+    memcpy(sorted, clock->samples, n * sizeof(double));
+    qsort(sorted, n, sizeof(double), compare_doubles);
+
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += sorted[i];
+    }
+
+    // nearest rank
+    size_t p99 = (size_t) ceil(0.99 * (double) n);
+    p99 = p99 > 0 ? p99 - 1 : 0;
+
+    stats->min_ms = sorted[0] * 1000.0;
+    stats->max_ms = sorted[n - 1] * 1000.0;
+    stats->avg_ms = sum / (double) n * 1000.0;
+    stats->p99_ms = sorted[p99] * 1000.0;
+    stats->fps = sum > 0.0 ? (double) n / sum : 0.0;
+    stats->samples = n;
+}
+
+void glt_frame_clock_reset_stats(glt_frame_clock_t *clock) {
+    if (clock) {
+        clock->sample_count = 0;
+        clock->sample_next = 0;
+    }
+}
+
+int glt_fixed_step_advance(glt_fixed_step_t *fixed, double delta) {
+    if (!fixed || fixed->step <= 0.0) {
+        return 0;
+    }
+
+    const int max_steps = fixed->max_steps > 0 ? fixed->max_steps : GLT_FIXED_STEP_MAX_DEFAULT;
+    fixed->accumulator += delta > 0.0 ? delta : 0.0;
+
+    int steps = (int) (fixed->accumulator / fixed->step);
+    if (steps > max_steps) {
+        // a long stall would otherwise make every following frame slower too
+        steps = max_steps;
+        fixed->accumulator = fmod(fixed->accumulator, fixed->step);
+    } else {
+        fixed->accumulator -= (double) steps * fixed->step;
+    }
+    return steps;
+}
+
+double glt_fixed_step_get_alpha(const glt_fixed_step_t *fixed) {
+    if (!fixed || fixed->step <= 0.0) {
+        return 0.0;
+    }
+    const double alpha = fixed->accumulator / fixed->step;
+    return alpha < 1.0 ? alpha : 0.0;
+}
+
+// helper funcs
+
+static void os_sleep(double seconds) {
+#ifdef _WIN32
+    Sleep((DWORD) (seconds * 1000.0));
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t) seconds;
+    ts.tv_nsec = (long) ((seconds - (double) ts.tv_sec) * 1e9);
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    const double x = *(const double *) a;
+    const double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
@@ -0,0 +1,398 @@
+#include "glt_trace.h"
+#include "glt_time.h"
+#include "glt_log.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_LOG(level, msg, ...)    glt_log(level, "[TRACE]: " msg, ##__VA_ARGS__)
+
+#define THREAD_NAME_SIZE 32
+#define GPU_TID 0
+
+typedef struct {
+    const char *name;
+    uint64_t start;
+    uint64_t end;
+} trace_event_t;
+
+// single producer (the owning thread), single consumer (the collector under trace_mutex)
+typedef struct trace_ring_t {
+    trace_event_t events[GLT_TRACE_RING_CAPACITY];
+    atomic_size_t head;
+    atomic_size_t tail;
+    atomic_uint_fast64_t dropped;
+    // set when the owning thread exits, the ring is handed to a new thread once drained
+    atomic_bool orphaned;
+    uint32_t tid;
+    char name[THREAD_NAME_SIZE];
+    struct trace_ring_t *next;
+} trace_ring_t;
+
+typedef struct {
+    trace_event_t event;
+    uint32_t tid;
+} collected_event_t;
+
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static trace_ring_t *rings;
+static uint32_t next_tid = GPU_TID + 1;
+static atomic_bool recording = true;
+static _Thread_local trace_ring_t *local_ring;
+// its destructor orphans the exiting thread's ring
+static pthread_key_t ring_key;
+static bool ring_key_created;
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+
+// guarded by trace_mutex
+static collected_event_t *collected;
+static size_t collected_count;
+static size_t collected_cap;
+static uint64_t gpu_frame = UINT64_MAX;
+// GPU scope names are owned by their profiler and others come from glt_trace_intern, the trace
+// keeps its own copies
+static char **interned;
+static size_t interned_count;
+static size_t interned_cap;
+
+// helper funcs
+
+static trace_ring_t *get_ring(void);
+
+static trace_ring_t *reuse_ring(void);
+
+static void create_ring_key(void);
+
+static void orphan_ring(void *ring);
+
+static void drain_rings(void);
+
+static bool push_collected(const trace_event_t *event, uint32_t tid);
+
+static const char *intern(const char *name);
+
+static int compare_events(const void *a, const void *b);
+
+static void write_string(FILE *f, const char *s);
+
+// public funcs
+
+glt_trace_zone_t glt_trace_zone_begin(const char *name) {
+    glt_trace_zone_t zone = {name, 0};
+    if (atomic_load_explicit(&recording, memory_order_relaxed)) {
+        zone.start = glt_time_now_ns();
+    }
+    return zone;
+}
+
+void glt_trace_zone_end(glt_trace_zone_t *zone) {
+    if (!zone || zone->start == 0 || !atomic_load_explicit(&recording, memory_order_relaxed)) {
+        return;
+    }
+    const uint64_t end = glt_time_now_ns();
+
+    trace_ring_t *ring = get_ring();
+    if (!ring) {
+        return;
+    }
+
+    const size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    const size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail == GLT_TRACE_RING_CAPACITY) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    trace_event_t *event = &ring->events[head % GLT_TRACE_RING_CAPACITY];
+    event->name = zone->name;
+    event->start = zone->start;
+    event->end = end;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void glt_trace_set_thread_name(const char *name) {
+    trace_ring_t *ring = get_ring();
+    if (!ring || !name) {
+        return;
+    }
+    pthread_mutex_lock(&trace_mutex);
+    snprintf(ring->name, sizeof(ring->name), "%s", name);
+    pthread_mutex_unlock(&trace_mutex);
+}
+
+const char *glt_trace_intern(const char *name) {
+    if (!name) {
+        return NULL;
+    }
+    pthread_mutex_lock(&trace_mutex);
+    const char *copy = intern(name);
+    pthread_mutex_unlock(&trace_mutex);
+    // zones need some name, intern already logged the failure
+    return copy ? copy : "?";
+}
+
+void glt_trace_set_active(bool active) {
+    atomic_store(&recording, active);
+}
+
+bool glt_trace_is_active(void) {
+    return atomic_load(&recording);
+}
+
+void glt_trace_collect(void) {
+    pthread_mutex_lock(&trace_mutex);
+    drain_rings();
+    pthread_mutex_unlock(&trace_mutex);
+}
+
+void glt_trace_add_gpu_frame(const glt_gpu_profiler_t *profiler) {
+    const uint64_t frame = glt_gpu_profiler_get_timeline_frame(profiler);
+    if (frame == UINT64_MAX || !atomic_load(&recording)) {
+        return;
+    }
+
+    pthread_mutex_lock(&trace_mutex);
+    if (frame != gpu_frame) {
+        gpu_frame = frame;
+
+        const double start = glt_gpu_profiler_get_timeline_start(profiler);
+        size_t count = 0;
+        const glt_gpu_event_t *events = glt_gpu_profiler_get_timeline(profiler, &count);
+        for (size_t i = 0; i < count; ++i) {
+            const double begin = start + events[i].start_ms * 1e-3;
+            trace_event_t event;
+            event.name = intern(events[i].name);
+            event.start = (uint64_t) (begin * 1e9);
+            event.end = (uint64_t) ((begin + events[i].duration_ms * 1e-3) * 1e9);
+            if (!event.name || !push_collected(&event, GPU_TID)) {
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&trace_mutex);
+}
+
+bool glt_trace_write_json(const char *path) {
+    if (!path) {
+        return false;
+    }
+
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        TRACE_LOG(GLT_LOG_ERROR, "can't open '%s' for writing", path);
+        return false;
+    }
+
+    pthread_mutex_lock(&trace_mutex);
+    drain_rings();
+    qsort(collected, collected_count, sizeof(collected_event_t), compare_events);
+
+    // timestamps relative to the first event keep the numbers readable
+    const uint64_t base = collected_count > 0 ? collected[0].event.start : 0;
+    bool gpu_used = false;
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (size_t i = 0; i < collected_count; ++i) {
+        const collected_event_t *c = &collected[i];
+        gpu_used |= c->tid == GPU_TID;
+        fprintf(f, "{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"name\":", c->tid);
+        write_string(f, c->event.name);
+        fprintf(
+            f, ",\"ts\":%.3f,\"dur\":%.3f},\n",
+            (double) (c->event.start - base) * 1e-3, (double) (c->event.end - c->event.start) * 1e-3
+        );
+    }
+
+    // thread names as metadata, the GPU track sorts first
+    for (const trace_ring_t *ring = rings; ring; ring = ring->next) {
+        fprintf(f, "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", ring->tid);
+        if (ring->name[0]) {
+            write_string(f, ring->name);
+        } else {
+            fprintf(f, "\"thread %u\"", ring->tid);
+        }
+        fprintf(f, "}},\n");
+    }
+    if (gpu_used) {
+        fprintf(f, "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"GPU\"}},\n", GPU_TID);
+    }
+    fprintf(f, "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"glt\"}}\n]}\n");
+    pthread_mutex_unlock(&trace_mutex);
+
+    const bool ok = !ferror(f);
+    if (fclose(f) != 0 || !ok) {
+        TRACE_LOG(GLT_LOG_ERROR, "failed to write '%s'", path);
+        return false;
+    }
+    return true;
+}
+
+void glt_trace_clear(void) {
+    pthread_mutex_lock(&trace_mutex);
+    drain_rings();
+    collected_count = 0;
+    for (trace_ring_t *ring = rings; ring; ring = ring->next) {
+        atomic_store_explicit(&ring->dropped, 0, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&trace_mutex);
+}
+
+uint64_t glt_trace_get_dropped(void) {
+    uint64_t dropped = 0;
+    pthread_mutex_lock(&trace_mutex);
+    for (trace_ring_t *ring = rings; ring; ring = ring->next) {
+        dropped += atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&trace_mutex);
+    return dropped;
+}
+
+// helper funcs
+
+static trace_ring_t *get_ring(void) {
+    if (local_ring) {
+        return local_ring;
+    }
+
+    pthread_once(&ring_key_once, create_ring_key);
+
+    // rings outlive their threads, so zones recorded before a thread exits still get collected
+    trace_ring_t *ring = reuse_ring();
+    if (!ring) {
+        ring = calloc(1, sizeof(trace_ring_t));
+        if (!ring) {
+            TRACE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+            return NULL;
+        }
+        atomic_init(&ring->head, 0);
+        atomic_init(&ring->tail, 0);
+        atomic_init(&ring->dropped, 0);
+        atomic_init(&ring->orphaned, false);
+
+        pthread_mutex_lock(&trace_mutex);
+        ring->tid = next_tid++;
+        ring->next = rings;
+        rings = ring;
+        pthread_mutex_unlock(&trace_mutex);
+    }
+
+    if (ring_key_created) {
+        pthread_setspecific(ring_key, ring);
+    }
+    local_ring = ring;
+    return ring;
+}
+
+static trace_ring_t *reuse_ring(void) {
+    pthread_mutex_lock(&trace_mutex);
+    trace_ring_t *ring = rings;
+    for (; ring; ring = ring->next) {
+        // the old thread's events are all collected, the new one continues its track
+        if (atomic_load_explicit(&ring->orphaned, memory_order_acquire)
+            && atomic_load_explicit(&ring->tail, memory_order_relaxed)
+               == atomic_load_explicit(&ring->head, memory_order_relaxed)) {
+            atomic_store_explicit(&ring->orphaned, false, memory_order_relaxed);
+            ring->name[0] = '\0';
+            break;
+        }
+    }
+    pthread_mutex_unlock(&trace_mutex);
+    return ring;
+}
+
+static void create_ring_key(void) {
+    ring_key_created = pthread_key_create(&ring_key, orphan_ring) == 0;
+    if (!ring_key_created) {
+        TRACE_LOG(GLT_LOG_WARNING, "no thread exit hook, rings of finished threads won't be reused");
+    }
+}
+
+static void orphan_ring(void *ring) {
+    atomic_store_explicit(&((trace_ring_t *) ring)->orphaned, true, memory_order_release);
+}
+
+static void drain_rings(void) {
+    for (trace_ring_t *ring = rings; ring; ring = ring->next) {
+        const size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        const size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        size_t i = tail;
+        for (; i != head; ++i) {
+            if (!push_collected(&ring->events[i % GLT_TRACE_RING_CAPACITY], ring->tid)) {
+                break;
+            }
+        }
+        atomic_store_explicit(&ring->tail, i, memory_order_release);
+    }
+}
+
+static bool push_collected(const trace_event_t *event, uint32_t tid) {
+    if (collected_count == collected_cap) {
+        const size_t cap = collected_cap ? collected_cap * 2 : 4096;
+        collected_event_t *events = realloc(collected, cap * sizeof(collected_event_t));
+        if (!events) {
+            TRACE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+            return false;
+        }
+        collected = events;
+        collected_cap = cap;
+    }
+
+    collected[collected_count].event = *event;
+    collected[collected_count].tid = tid;
+    collected_count++;
+    return true;
+}
+
+static const char *intern(const char *name) {
+    for (size_t i = 0; i < interned_count; ++i) {
+        if (strcmp(interned[i], name) == 0) {
+            return interned[i];
+        }
+    }
+
+    if (interned_count == interned_cap) {
+        const size_t cap = interned_cap ? interned_cap * 2 : 32;
+        char **names = realloc(interned, cap * sizeof(char *));
+        if (!names) {
+            TRACE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+            return NULL;
+        }
+        interned = names;
+        interned_cap = cap;
+    }
+
+    char *copy = malloc(strlen(name) + 1);
+    if (!copy) {
+        TRACE_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+    strcpy(copy, name);
+    interned[interned_count++] = copy;
+    return copy;
+}
+
+static int compare_events(const void *a, const void *b) {
+    const uint64_t x = ((const collected_event_t *) a)->event.start;
+    const uint64_t y = ((const collected_event_t *) b)->event.start;
+    return (x > y) - (x < y);
+}
+
+static void write_string(FILE *f, const char *s) {
+    fputc('"', f);
+    for (; *s; ++s) {
+        const unsigned char c = (unsigned char) *s;
+        if (c == '"' || c == '\\') {
+            fputc('\\', f);
+            fputc(c, f);
+        } else if (c < 0x20) {
+            fprintf(f, "\\u%04x", c);
+        } else {
+            fputc(c, f);
+        }
+    }
+    fputc('"', f);
+}
@@ -0,0 +1,322 @@
+#include "glt_uploader.h"
+#include "glt_texture_internal.h"
+#include "glt_job_queue.h"
+#include "glt_sampler.h"
+#include "glt_stats.h"
+#include "glt_trace.h"
+#include "glt_log.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UPLOADER_LOG(level, msg, ...)    glt_log(level, "[UPLOADER]: " msg, ##__VA_ARGS__)
+
+struct upload_job_t {
+    glt_uploader_t *uploader;
+    glt_upload_fn upload;
+    glt_upload_done_fn done;
+    void *user;
+
+    // texture loads; texture is render thread only, NULL once the texture was destroyed
+    glt_texture_t *texture;
+    char *path;
+    glt_texture_options_t options;
+
+    // written by the upload thread before the job is queued as uploaded
+    GLuint id;
+    int width;
+    int height;
+    size_t bytes;
+    GLsync fence;
+
+    upload_job_t *next;
+};
+
+struct glt_uploader_t {
+    glt_window_t *context;
+    // a single worker, so every job runs on the thread the shared context is current on
+    glt_job_queue_t *thread;
+
+    // filled by the upload thread, drained by update
+    pthread_mutex_t mutex;
+    upload_job_t *uploaded_head;
+    upload_job_t *uploaded_tail;
+
+    // render thread only, waiting on their fences in submission order
+    upload_job_t *fenced_head;
+    upload_job_t *fenced_tail;
+    size_t pending;
+};
+
+// helper funcs
+
+static bool push_job(glt_uploader_t *uploader, upload_job_t *job);
+
+static void run_job(void *user);
+
+static void bind_context(void *user);
+
+static void release_context(void *user);
+
+static size_t complete_jobs(glt_uploader_t *uploader, bool block);
+
+static void complete_job(upload_job_t *job);
+
+// public funcs
+
+glt_uploader_t *glt_uploader_create(glt_window_t *window) {
+    glt_uploader_t *uploader = calloc(1, sizeof(glt_uploader_t));
+    if (!uploader) {
+        UPLOADER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return NULL;
+    }
+
+    uploader->context = glt_window_create_shared(window);
+    if (!uploader->context) {
+        UPLOADER_LOG(GLT_LOG_ERROR, "failed to create a shared context");
+        free(uploader);
+        return NULL;
+    }
+
+    uploader->thread = glt_job_queue_create(1);
+    if (!uploader->thread || !glt_job_queue_push(uploader->thread, bind_context, uploader->context)) {
+        glt_job_queue_destroy(uploader->thread);
+        glt_window_destroy(uploader->context);
+        free(uploader);
+        return NULL;
+    }
+
+    pthread_mutex_init(&uploader->mutex, NULL);
+    return uploader;
+}
+
+void glt_uploader_destroy(glt_uploader_t *uploader) {
+    if (!uploader) {
+        return;
+    }
+
+    glt_uploader_finish(uploader);
+
+    // the context has to be released on its thread before it can be destroyed
+    glt_job_queue_push(uploader->thread, release_context, NULL);
+    glt_job_queue_destroy(uploader->thread);
+    glt_window_destroy(uploader->context);
+
+    pthread_mutex_destroy(&uploader->mutex);
+    free(uploader);
+}
+
+bool glt_uploader_submit(glt_uploader_t *uploader, glt_upload_fn upload, glt_upload_done_fn done, void *user) {
+    if (!uploader) {
+        return false;
+    }
+
+    upload_job_t *job = calloc(1, sizeof(upload_job_t));
+    if (!job) {
+        UPLOADER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        return false;
+    }
+    job->upload = upload;
+    job->done = done;
+    job->user = user;
+    return push_job(uploader, job);
+}
+
+glt_texture_t *glt_uploader_load_texture(glt_uploader_t *uploader, const char *path, const glt_texture_options_t *options) {
+    static const glt_texture_options_t defaults = {0};
+    if (!uploader || !path) {
+        return NULL;
+    }
+    if (!options) {
+        options = &defaults;
+    }
+
+    glt_texture_t *tex = calloc(1, sizeof(glt_texture_t));
+    upload_job_t *job = calloc(1, sizeof(upload_job_t));
+    char *path_copy = malloc(strlen(path) + 1);
+    if (!tex || !job || !path_copy) {
+        UPLOADER_LOG(GLT_LOG_ERROR, "failed to allocate memory");
+        free(tex);
+        free(job);
+        free(path_copy);
+        return NULL;
+    }
+    strcpy(path_copy, path);
+
+    tex->state = GLT_TEXTURE_PENDING;
+    tex->sampler = glt_sampler_get(&options->sampler);
+    tex->uploader = uploader;
+    tex->upload = job;
+
+    job->texture = tex;
+    job->path = path_copy;
+    job->options = *options;
+
+    if (!push_job(uploader, job)) {
+        free(tex);
+        return NULL;
+    }
+    return tex;
+}
+
+size_t glt_uploader_update(glt_uploader_t *uploader) {
+    if (!uploader) {
+        return 0;
+    }
+    GLT_ZONE("glt_uploader_update");
+    return complete_jobs(uploader, false);
+}
+
+void glt_uploader_finish(glt_uploader_t *uploader) {
+    if (!uploader) {
+        return;
+    }
+    glt_job_queue_wait(uploader->thread);
+    complete_jobs(uploader, true);
+}
+
+size_t glt_uploader_get_pending(const glt_uploader_t *uploader) {
+    return uploader ? uploader->pending : 0;
+}
+
+// internal funcs
+
+void glt_uploader_detach(glt_uploader_t *uploader, glt_texture_t *texture) {
+    if (!uploader || !texture || !texture->upload) {
+        return;
+    }
+    // the job still completes, its texture is deleted then
+    texture->upload->texture = NULL;
+    texture->upload = NULL;
+    texture->uploader = NULL;
+}
+
+// helper funcs
+
+static bool push_job(glt_uploader_t *uploader, upload_job_t *job) {
+    job->uploader = uploader;
+    uploader->pending++;
+    if (!glt_job_queue_push(uploader->thread, run_job, job)) {
+        uploader->pending--;
+        free(job->path);
+        free(job);
+        return false;
+    }
+    return true;
+}
+
+static void run_job(void *user) {
+    upload_job_t *job = user;
+    glt_uploader_t *uploader = job->uploader;
+    GLT_ZONE("upload job");
+
+    if (job->path) {
+        size_t size = 0;
+        unsigned char *data = glt_texture_read_file(job->path, &size);
+        if (data) {
+            job->id = glt_texture_create_gl(data, size, &job->options, &job->width, &job->height, &job->bytes);
+            free(data);
+        }
+        if (!job->id) {
+            UPLOADER_LOG(GLT_LOG_ERROR, "failed to load '%s'", job->path);
+        }
+    } else if (job->upload) {
+        job->upload(job->user);
+    }
+
+    // the flush gets the fence to the GPU, an unflushed fence could never signal for the render thread
+    job->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+
+    pthread_mutex_lock(&uploader->mutex);
+    if (uploader->uploaded_tail) {
+        uploader->uploaded_tail->next = job;
+    } else {
+        uploader->uploaded_head = job;
+    }
+    uploader->uploaded_tail = job;
+    pthread_mutex_unlock(&uploader->mutex);
+}
+
+static void bind_context(void *user) {
+    glt_window_set_current(user);
+    GLT_TRACE_THREAD_NAME("glt uploader");
+}
+
+static void release_context(void *user) {
+    (void) user;
+    glt_window_set_current(NULL);
+}
+
+static size_t complete_jobs(glt_uploader_t *uploader, bool block) {
+    pthread_mutex_lock(&uploader->mutex);
+    upload_job_t *head = uploader->uploaded_head;
+    upload_job_t *tail = uploader->uploaded_tail;
+    uploader->uploaded_head = NULL;
+    uploader->uploaded_tail = NULL;
+    pthread_mutex_unlock(&uploader->mutex);
+
+    if (head) {
+        if (uploader->fenced_tail) {
+            uploader->fenced_tail->next = head;
+        } else {
+            uploader->fenced_head = head;
+        }
+        uploader->fenced_tail = tail;
+    }
+
+    size_t completed = 0;
+    while (uploader->fenced_head) {
+        upload_job_t *job = uploader->fenced_head;
+        if (job->fence) {
+            const GLenum status = block
+                                      ? glClientWaitSync(job->fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX)
+                                      : glClientWaitSync(job->fence, 0, 0);
+            // fences signal in order, so nothing behind an unsignaled one is done either
+            if (status == GL_TIMEOUT_EXPIRED) {
+                break;
+            }
+            if (status == GL_WAIT_FAILED) {
+                UPLOADER_LOG(GLT_LOG_WARNING, "waiting on an upload fence failed");
+            }
+            glDeleteSync(job->fence);
+        }
+
+        uploader->fenced_head = job->next;
+        if (!uploader->fenced_head) {
+            uploader->fenced_tail = NULL;
+        }
+        uploader->pending--;
+        complete_job(job);
+        completed++;
+    }
+    return completed;
+}
+
+static void complete_job(upload_job_t *job) {
+    glt_texture_t *tex = job->texture;
+    if (tex) {
+        tex->upload = NULL;
+        tex->uploader = NULL;
+        if (job->id) {
+            tex->id = job->id;
+            tex->width = job->width;
+            tex->height = job->height;
+            tex->bytes = job->bytes;
+            tex->state = GLT_TEXTURE_READY;
+            glt_stats_track_resource(GLT_RESOURCE_TEXTURE, 1, (int64_t) job->bytes);
+        } else {
+            tex->state = GLT_TEXTURE_FAILED;
+        }
+    } else if (job->id) {
+        glDeleteTextures(1, &job->id);
+    }
+
+    if (job->done) {
+        job->done(job->user);
+    }
+    free(job->path);
+    free(job);
+}
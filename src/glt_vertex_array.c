@@ -1,5 +1,6 @@
 #include "glt_vertex_array.h"
 #include "glt_log.h"
+#include "glt_stats.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -26,6 +27,7 @@ glt_vertex_array_t *glt_vertex_array_create(void) {
         free(array);
         return NULL;
     }
+    glt_stats_track_resource(GLT_RESOURCE_VERTEX_ARRAY, 1, 0);
     return array;
 }
 
@@ -33,6 +35,7 @@ void glt_vertex_array_destroy(glt_vertex_array_t *array) {
     if (array) {
         if (array->id) {
             glDeleteVertexArrays(1, &array->id);
+            glt_stats_track_resource(GLT_RESOURCE_VERTEX_ARRAY, -1, 0);
             array->id = 0;
         }
         free(array);
@@ -42,6 +45,7 @@ void glt_vertex_array_destroy(glt_vertex_array_t *array) {
 void glt_vertex_array_bind(const glt_vertex_array_t *array) {
     if (array && array->id) {
         glBindVertexArray(array->id);
+        glt_stats_add(GLT_STAT_VERTEX_ARRAY_BINDS, 1);
     }
 }
 
@@ -1,5 +1,6 @@
 #include "glt_vertex_buffer.h"
 #include "glt_log.h"
+#include "glt_stats.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -50,6 +51,9 @@ glt_vertex_buffer_t *glt_vertex_buffer_create(const void *data, GLsizeiptr size,
     }
 
     buffer->size = size;
+    glt_stats_track_resource(GLT_RESOURCE_BUFFER, 1, size);
+    glt_stats_add(GLT_STAT_BUFFER_UPLOADS, 1);
+    glt_stats_add(GLT_STAT_BUFFER_UPLOAD_BYTES, (uint64_t) size);
 
     return buffer;
 }
@@ -58,6 +62,7 @@ void glt_vertex_buffer_destroy(glt_vertex_buffer_t *buffer) {
     if (buffer) {
         if (buffer->id) {
             glDeleteBuffers(1, &buffer->id);
+            glt_stats_track_resource(GLT_RESOURCE_BUFFER, -1, -buffer->size);
             buffer->id = 0;
         }
         free(buffer);
@@ -68,6 +73,7 @@ void glt_vertex_buffer_destroy(glt_vertex_buffer_t *buffer) {
 void glt_vertex_buffer_bind(const glt_vertex_buffer_t *buffer) {
     if (buffer && buffer->id) {
         glBindBuffer(GL_ARRAY_BUFFER, buffer->id);
+        glt_stats_add(GLT_STAT_BUFFER_BINDS, 1);
     }
 }
 
@@ -80,10 +86,28 @@ void glt_vertex_buffer_set_data(glt_vertex_buffer_t *buffer, const void *data, G
         glBindBuffer(GL_ARRAY_BUFFER, buffer->id);
         glBufferData(GL_ARRAY_BUFFER, size, data, buffer->usage);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glt_stats_track_resource(GLT_RESOURCE_BUFFER, 0, size - buffer->size);
+        glt_stats_add(GLT_STAT_BUFFER_UPLOADS, 1);
+        glt_stats_add(GLT_STAT_BUFFER_UPLOAD_BYTES, (uint64_t) size);
         buffer->size = size;
     }
 }
 
+void glt_vertex_buffer_set_sub_data(glt_vertex_buffer_t *buffer, GLintptr offset, const void *data, GLsizeiptr size) {
+    if (!buffer || !buffer->id || !data || size <= 0) {
+        return;
+    }
+    if (offset < 0 || offset + size > buffer->size) {
+        VB_LOG(GLT_LOG_ERROR, "range %ld + %ld is outside the buffer of %ld bytes", offset, size, buffer->size);
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, buffer->id);
+    glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glt_stats_add(GLT_STAT_BUFFER_UPLOADS, 1);
+    glt_stats_add(GLT_STAT_BUFFER_UPLOAD_BYTES, (uint64_t) size);
+}
+
 GLuint glt_vertex_buffer_get_id(const glt_vertex_buffer_t *buffer) {
     return buffer ? buffer->id : 0;
 }
@@ -1,73 +1,238 @@
 #include "glt_window.h"
+#include "glt_debug.h"
 #include "glt_log.h"
+#include "glt_image.h"
+#include "glt_sampler.h"
+#include "glt_stats.h"
+#include "glt_trace.h"
 
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <glad/glad.h>
 #include "GLFW/glfw3.h"
 
+#ifdef GLT_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
 #define WINDOW_LOG(level, msg, ...)    glt_log(level, "[WINDOW]: " msg, ##__VA_ARGS__)
 #define GLAD_LOG(level, msg, ...)      glt_log(level, "[GLAD]: " msg, ##__VA_ARGS__)
 
 struct glt_window_t {
     GLFWwindow *handle;
+    glt_frame_clock_t *clock;
+    bool glfw_initialized;
+    int major_ver;
+    int minor_ver;
+    // hidden context created by glt_window_create_shared, meant for another thread
+    bool shared;
+    // the window whose context created the share group, keys the sampler cache
+    const glt_window_t *group;
+    bool debug;
+
+    // headless windows render into fbo, sized once at creation
+    bool headless;
+    bool should_close;
+    int width;
+    int height;
+    // of GLFW windows, kept current by framebuffer_size_callback
+    int framebuffer_width;
+    int framebuffer_height;
+    GLuint fbo;
+    GLuint renderbuffers[2];
+
+    // filled by the GLFW callbacks while events are polled or waited for
+    glt_event_t events[GLT_WINDOW_EVENT_CAPACITY];
+    size_t event_head;
+    size_t event_count;
+    uint64_t dropped_events;
+    bool escape_down;
+
+    bool on_demand;
+    double max_wait;
+    double last_frame;
+    atomic_bool dirty;
+
+#ifdef GLT_HAS_EGL
+    EGLDisplay egl_display;
+    EGLContext egl_context;
+    EGLSurface egl_surface;
+#endif
 };
 
+// glfwTerminate destroys every window, so it waits for the last one
+static int glfw_windows = 0;
+
+#ifdef GLT_HAS_EGL
+// every headless window shares the display, eglTerminate would take the others' contexts down
+static int egl_display_refs = 0;
+#endif
+
+// whatever context the calling thread had current, so glt_window_destroy can put it back
+typedef struct {
+    GLFWwindow *glfw;
+    const void *group;
+#ifdef GLT_HAS_EGL
+    EGLDisplay egl_display;
+    EGLSurface egl_draw;
+    EGLSurface egl_read;
+    EGLContext egl_context;
+#endif
+} saved_context_t;
+
 // helper funcs
 
+static void push_event(glt_window_t *window, const glt_event_t *event);
+
+static void key_callback(GLFWwindow *handle, int key, int scancode, int action, int mods);
+
+static void char_callback(GLFWwindow *handle, unsigned int codepoint);
+
+static void mouse_button_callback(GLFWwindow *handle, int button, int action, int mods);
+
+static void cursor_pos_callback(GLFWwindow *handle, double x, double y);
+
+static void scroll_callback(GLFWwindow *handle, double dx, double dy);
+
 static void framebuffer_size_callback(GLFWwindow *handle, int width, int height);
 
-static bool init_glad(void);
+static void focus_callback(GLFWwindow *handle, int focused);
+
+static void close_callback(GLFWwindow *handle);
+
+static bool init_glad(GLADloadproc loader);
+
+// a share window gets a context sharing its objects, left uncurrent so the caller's context stays
+static bool create_glfw_context(glt_window_t *window, const char *title, bool visible, GLFWwindow *share);
+
+static bool create_offscreen(glt_window_t *window);
+
+static bool make_current(const glt_window_t *window);
+
+static void release_current(void);
+
+static saved_context_t save_current(void);
+
+// falls back to releasing when the saved context belonged to the window being destroyed
+static void restore_current(const saved_context_t *saved, const glt_window_t *destroyed);
+
+#ifdef GLT_HAS_EGL
+static bool create_egl_context(glt_window_t *window, EGLContext share);
+
+static void destroy_egl_context(glt_window_t *window);
+#endif
 
 // public funcs
 
 glt_window_t *glt_window_create(int width, int height, const char *title, int major_ver, int minor_ver) {
-    if (!glfwInit()) {
-        WINDOW_LOG(GLT_LOG_ERROR, "failed to initialize GLFW");
+    const glt_window_options_t options = {0};
+    return glt_window_create_ex(width, height, title, major_ver, minor_ver, &options);
+}
+
+glt_window_t *glt_window_create_ex(
+    int width, int height, const char *title, int major_ver, int minor_ver,
+    const glt_window_options_t *options
+) {
+    static const glt_window_options_t defaults = {0};
+    if (!options) {
+        options = &defaults;
+    }
+    if (width <= 0 || height <= 0) {
+        WINDOW_LOG(GLT_LOG_ERROR, "invalid window size: %dx%d", width, height);
         return NULL;
     }
 
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, major_ver);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor_ver);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glt_window_t *window = calloc(1, sizeof(glt_window_t));
+    if (!window) {
+        WINDOW_LOG(GLT_LOG_ERROR, "failed to allocate memory for window");
+        return NULL;
+    }
+    window->headless = options->mode == GLT_WINDOW_MODE_HEADLESS;
+    window->width = width;
+    window->height = height;
+    window->major_ver = major_ver;
+    window->minor_ver = minor_ver;
+    window->debug = options->debug;
+    window->group = window;
+    // the first frame is always drawn
+    atomic_init(&window->dirty, true);
+
+    bool ok = false;
+    if (window->headless) {
+#ifdef GLT_HAS_EGL
+        ok = create_egl_context(window, EGL_NO_CONTEXT);
+        if (!ok) {
+            WINDOW_LOG(GLT_LOG_WARNING, "no EGL context, falling back to an invisible GLFW window");
+        }
 #endif
+        if (!ok) {
+            ok = create_glfw_context(window, title, false, NULL);
+        }
+        ok = ok && create_offscreen(window);
+    } else {
+        ok = create_glfw_context(window, title, true, NULL);
+    }
 
-    GLFWwindow *handle = glfwCreateWindow(width, height, title, NULL, NULL);
-    if (!handle) {
-        WINDOW_LOG(GLT_LOG_ERROR, "failed to create GLFW window");
-        glfwDestroyWindow(handle);
-        glfwTerminate();
+    if (ok) {
+        window->clock = glt_frame_clock_create();
+        ok = window->clock != NULL;
+    }
+    if (!ok) {
+        glt_window_destroy(window);
         return NULL;
     }
 
-    glfwMakeContextCurrent(handle);
-
-    if (!init_glad()) {
-        glfwTerminate();
-        return NULL;
+    // a window without debug output is still usable, glt_debug_enable logs why
+    if (window->debug) {
+        glt_debug_enable(NULL);
     }
 
-    glfwSwapInterval(1); // VSync
+    return window;
+}
 
-    int fbw = 0, fbh = 0;
-    glfwGetFramebufferSize(handle, &fbw, &fbh);
-    glViewport(0, 0, fbw, fbh);
-    glfwSetFramebufferSizeCallback(handle, framebuffer_size_callback);
+glt_window_t *glt_window_create_shared(const glt_window_t *window) {
+    if (!window || window->shared) {
+        WINDOW_LOG(GLT_LOG_ERROR, "can't share with a missing or shared window");
+        return NULL;
+    }
 
-    glt_window_t *window = malloc(sizeof(glt_window_t));
-    if (!window) {
+    glt_window_t *shared = calloc(1, sizeof(glt_window_t));
+    if (!shared) {
         WINDOW_LOG(GLT_LOG_ERROR, "failed to allocate memory for window");
-        glfwDestroyWindow(handle);
-        glfwTerminate();
         return NULL;
     }
+    shared->shared = true;
+    shared->headless = true;
+    shared->width = 1;
+    shared->height = 1;
+    shared->major_ver = window->major_ver;
+    shared->minor_ver = window->minor_ver;
+    shared->debug = window->debug;
+    shared->group = window->group;
+
+    bool ok = false;
+#ifdef GLT_HAS_EGL
+    if (window->egl_context != EGL_NO_CONTEXT) {
+        ok = create_egl_context(shared, window->egl_context);
+    } else
+#endif
+    {
+        ok = create_glfw_context(shared, "", false, window->handle);
+    }
 
-    window->handle = handle;
-
-    return window;
+    if (ok) {
+        shared->clock = glt_frame_clock_create();
+        ok = shared->clock != NULL;
+    }
+    if (!ok) {
+        glt_window_destroy(shared);
+        return NULL;
+    }
+    return shared;
 }
 
 void glt_window_destroy(glt_window_t *window) {
@@ -75,49 +240,179 @@ void glt_window_destroy(glt_window_t *window) {
         return;
     }
 
+    // samplers and the offscreen framebuffer belong to this window's context; shared windows own
+    // neither and are destroyed from the thread whose context must stay current
+    const saved_context_t saved = save_current();
+    if (!window->shared && make_current(window)) {
+        glt_sampler_cache_clear();
+        if (window->fbo) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &window->fbo);
+        }
+        if (window->renderbuffers[0]) {
+            glDeleteRenderbuffers(2, window->renderbuffers);
+        }
+        restore_current(&saved, window);
+    }
+
     if (window->handle) {
         glfwDestroyWindow(window->handle);
         window->handle = NULL;
     }
+#ifdef GLT_HAS_EGL
+    destroy_egl_context(window);
+#endif
+    glt_frame_clock_destroy(window->clock);
+
+    const bool glfw_initialized = window->glfw_initialized;
     free(window);
 
-    glfwTerminate();
+    if (glfw_initialized && --glfw_windows == 0) {
+        glfwTerminate();
+    }
 }
 
 void *glt_window_get_handle(const glt_window_t *window) {
     return window ? window->handle : NULL;
 }
 
+bool glt_window_is_headless(const glt_window_t *window) {
+    return window && window->headless;
+}
+
 void glt_window_set_vsync(bool enabled) {
-    glfwSwapInterval(enabled ? 1 : 0);
+#ifdef GLT_HAS_EGL
+    // EGL contexts are headless, nothing is presented
+    if (eglGetCurrentContext() != EGL_NO_CONTEXT) {
+        return;
+    }
+#endif
+    if (glfw_windows > 0 && glfwGetCurrentContext()) {
+        glfwSwapInterval(enabled ? 1 : 0);
+    }
 }
 
 bool glt_window_should_close(const glt_window_t *window) {
-    if (!window || !window->handle) {
+    if (!window) {
         return true;
     }
-    return glfwWindowShouldClose(window->handle);
+    if (window->headless) {
+        return window->should_close;
+    }
+    return !window->handle || glfwWindowShouldClose(window->handle);
+}
+
+void glt_window_set_should_close(glt_window_t *window, bool close) {
+    if (!window) {
+        return;
+    }
+    window->should_close = close;
+    if (window->handle) {
+        glfwSetWindowShouldClose(window->handle, close ? GLFW_TRUE : GLFW_FALSE);
+    }
 }
 
 void glt_window_process_input(const glt_window_t *window) {
-    if (!window || !window->handle) {
+    if (!window || !window->handle || window->headless) {
         return;
     }
-    if (glfwGetKey(glt_window_get_handle(window), GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-        glfwSetWindowShouldClose(glt_window_get_handle(window), GLFW_TRUE);
+    // tracked by the key callback, no per-frame key query
+    if (window->escape_down) {
+        glfwSetWindowShouldClose(window->handle, GLFW_TRUE);
     }
 }
 
 void glt_window_swap_buffers(const glt_window_t *window) {
-    if (window && window->handle) {
+    GLT_ZONE("glt_window_swap_buffers");
+    if (!window) {
+        return;
+    }
+    // nothing is presented offscreen, frames still pace and count the same way
+    if (!window->headless && window->handle) {
         glfwSwapBuffers(window->handle);
     }
+    glt_frame_clock_tick(window->clock);
+    glt_stats_end_frame();
+    glt_debug_end_frame();
 }
 
 void glt_window_poll_events(void) {
     glfwPollEvents();
 }
 
+bool glt_window_next_event(glt_window_t *window, glt_event_t *event) {
+    if (!window || !event || window->event_count == 0) {
+        return false;
+    }
+    *event = window->events[window->event_head];
+    window->event_head = (window->event_head + 1) % GLT_WINDOW_EVENT_CAPACITY;
+    window->event_count--;
+    return true;
+}
+
+uint64_t glt_window_get_dropped_events(const glt_window_t *window) {
+    return window ? window->dropped_events : 0;
+}
+
+void glt_window_set_on_demand(glt_window_t *window, bool enabled, double max_wait) {
+    if (window) {
+        window->on_demand = enabled;
+        window->max_wait = max_wait > 0.0 ? max_wait : 0.0;
+        window->last_frame = glt_time_now();
+        glt_window_request_redraw(window);
+    }
+}
+
+bool glt_window_is_on_demand(const glt_window_t *window) {
+    return window && window->on_demand;
+}
+
+void glt_window_request_redraw(glt_window_t *window) {
+    if (!window) {
+        return;
+    }
+    atomic_store(&window->dirty, true);
+    if (window->handle) {
+        // wakes a glfwWaitEvents* on the main thread
+        glfwPostEmptyEvent();
+    }
+}
+
+bool glt_window_wait_frame(glt_window_t *window) {
+    if (!window) {
+        return false;
+    }
+    if (!window->on_demand || !window->handle || window->headless) {
+        if (window->handle) {
+            glfwPollEvents();
+        }
+        atomic_store(&window->dirty, false);
+        return true;
+    }
+
+    GLT_ZONE("glt_window_wait_frame");
+    glfwPollEvents();
+    bool draw = atomic_exchange(&window->dirty, false);
+    if (!draw) {
+        if (window->max_wait > 0.0) {
+            const double remaining = window->last_frame + window->max_wait - glt_time_now();
+            if (remaining > 0.0) {
+                glfwWaitEventsTimeout(remaining);
+            }
+        } else {
+            glfwWaitEvents();
+        }
+        // wakeups for other windows or empty events without a redraw request draw nothing
+        draw = atomic_exchange(&window->dirty, false)
+               || (window->max_wait > 0.0 && glt_time_now() >= window->last_frame + window->max_wait);
+    }
+
+    if (draw) {
+        window->last_frame = glt_time_now();
+    }
+    return draw;
+}
+
 void glt_window_set_clear_color(float r, float g, float b, float a) {
     glClearColor(r, g, b, a);
 }
@@ -127,11 +422,21 @@ void glt_window_clear(void) {
 }
 
 void glt_window_set_current(glt_window_t *window) {
-    glfwMakeContextCurrent(window->handle);
+    if (window) {
+        make_current(window);
+    } else {
+        release_current();
+    }
 }
 
 int glt_window_get_width(const glt_window_t *window) {
-    if (!window || !window->handle) {
+    if (!window) {
+        return 0;
+    }
+    if (window->headless) {
+        return window->width;
+    }
+    if (!window->handle) {
         return 0;
     }
 
@@ -141,7 +446,13 @@ int glt_window_get_width(const glt_window_t *window) {
 }
 
 int glt_window_get_height(const glt_window_t *window) {
-    if (!window || !window->handle) {
+    if (!window) {
+        return 0;
+    }
+    if (window->headless) {
+        return window->height;
+    }
+    if (!window->handle) {
         return 0;
     }
 
@@ -150,17 +461,404 @@ int glt_window_get_height(const glt_window_t *window) {
     return height;
 }
 
+void glt_window_get_framebuffer_size(const glt_window_t *window, int *width, int *height) {
+    int w = 0, h = 0;
+    if (window && window->headless) {
+        w = window->width;
+        h = window->height;
+    } else if (window) {
+        w = window->framebuffer_width;
+        h = window->framebuffer_height;
+    }
+    if (width) {
+        *width = w;
+    }
+    if (height) {
+        *height = h;
+    }
+}
+
+GLuint glt_window_get_framebuffer(const glt_window_t *window) {
+    return window ? window->fbo : 0;
+}
+
+bool glt_window_read_pixels(const glt_window_t *window, unsigned char *rgba) {
+    if (!window || !rgba) {
+        return false;
+    }
+    int width = 0, height = 0;
+    glt_window_get_framebuffer_size(window, &width, &height);
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    GLint prev_read = 0, prev_pack = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prev_read);
+    glGetIntegerv(GL_PACK_ALIGNMENT, &prev_pack);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, window->fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, prev_pack);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint) prev_read);
+
+    // GL rows go bottom-up
+    glt_image_flip_vertical(rgba, width, height, 4);
+    return true;
+}
+
+glt_frame_clock_t *glt_window_get_clock(const glt_window_t *window) {
+    return window ? window->clock : NULL;
+}
+
+double glt_window_get_delta_time(const glt_window_t *window) {
+    return window ? glt_frame_clock_get_delta(window->clock) : 0.0;
+}
+
+void glt_window_set_frame_limit(glt_window_t *window, double fps) {
+    if (window) {
+        glt_frame_clock_set_limit(window->clock, fps);
+    }
+}
+
 // helper funcs
 
+static void push_event(glt_window_t *window, const glt_event_t *event) {
+    if (!window) {
+        return;
+    }
+    atomic_store(&window->dirty, true);
+
+    if (event->type == GLT_EVENT_MOUSE_MOVE && window->event_count > 0) {
+        const size_t last = (window->event_head + window->event_count - 1) % GLT_WINDOW_EVENT_CAPACITY;
+        if (window->events[last].type == GLT_EVENT_MOUSE_MOVE) {
+            window->events[last] = *event;
+            return;
+        }
+    }
+
+    if (window->event_count == GLT_WINDOW_EVENT_CAPACITY) {
+        window->event_head = (window->event_head + 1) % GLT_WINDOW_EVENT_CAPACITY;
+        window->event_count--;
+        window->dropped_events++;
+    }
+    window->events[(window->event_head + window->event_count) % GLT_WINDOW_EVENT_CAPACITY] = *event;
+    window->event_count++;
+}
+
+static void key_callback(GLFWwindow *handle, int key, int scancode, int action, int mods) {
+    glt_window_t *window = glfwGetWindowUserPointer(handle);
+    if (window && key == GLFW_KEY_ESCAPE) {
+        window->escape_down = action != GLFW_RELEASE;
+    }
+    glt_event_t event = {.type = GLT_EVENT_KEY, .time = glt_time_now()};
+    event.key.key = key;
+    event.key.scancode = scancode;
+    event.key.action = action;
+    event.key.mods = mods;
+    push_event(window, &event);
+}
+
+static void char_callback(GLFWwindow *handle, unsigned int codepoint) {
+    glt_event_t event = {.type = GLT_EVENT_CHAR, .time = glt_time_now()};
+    event.character.codepoint = codepoint;
+    push_event(glfwGetWindowUserPointer(handle), &event);
+}
+
+static void mouse_button_callback(GLFWwindow *handle, int button, int action, int mods) {
+    glt_event_t event = {.type = GLT_EVENT_MOUSE_BUTTON, .time = glt_time_now()};
+    event.mouse_button.button = button;
+    event.mouse_button.action = action;
+    event.mouse_button.mods = mods;
+    glfwGetCursorPos(handle, &event.mouse_button.x, &event.mouse_button.y);
+    push_event(glfwGetWindowUserPointer(handle), &event);
+}
+
+static void cursor_pos_callback(GLFWwindow *handle, double x, double y) {
+    glt_event_t event = {.type = GLT_EVENT_MOUSE_MOVE, .time = glt_time_now()};
+    event.mouse_move.x = x;
+    event.mouse_move.y = y;
+    push_event(glfwGetWindowUserPointer(handle), &event);
+}
+
+static void scroll_callback(GLFWwindow *handle, double dx, double dy) {
+    glt_event_t event = {.type = GLT_EVENT_SCROLL, .time = glt_time_now()};
+    event.scroll.dx = dx;
+    event.scroll.dy = dy;
+    push_event(glfwGetWindowUserPointer(handle), &event);
+}
+
 static void framebuffer_size_callback(GLFWwindow *handle, int width, int height) {
-    (void) handle;
     glViewport(0, 0, width, height);
+
+    glt_window_t *window = glfwGetWindowUserPointer(handle);
+    if (window) {
+        window->framebuffer_width = width;
+        window->framebuffer_height = height;
+    }
+
+    glt_event_t event = {.type = GLT_EVENT_RESIZE, .time = glt_time_now()};
+    event.resize.width = width;
+    event.resize.height = height;
+    push_event(glfwGetWindowUserPointer(handle), &event);
 }
 
-static bool init_glad(void) {
-    if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress)) {
+static void focus_callback(GLFWwindow *handle, int focused) {
+    glt_event_t event = {.type = GLT_EVENT_FOCUS, .time = glt_time_now()};
+    event.focus.focused = focused == GLFW_TRUE;
+    push_event(glfwGetWindowUserPointer(handle), &event);
+}
+
+static void close_callback(GLFWwindow *handle) {
+    const glt_event_t event = {.type = GLT_EVENT_CLOSE, .time = glt_time_now()};
+    push_event(glfwGetWindowUserPointer(handle), &event);
+}
+
+static bool init_glad(GLADloadproc loader) {
+    if (!gladLoadGLLoader(loader)) {
         GLAD_LOG(GLT_LOG_ERROR, "failed to initialize GLAD");
         return 0;
     }
     return 1;
 }
+
+static bool create_glfw_context(glt_window_t *window, const char *title, bool visible, GLFWwindow *share) {
+    if (!glfwInit()) {
+        WINDOW_LOG(GLT_LOG_ERROR, "failed to initialize GLFW");
+        return false;
+    }
+    window->glfw_initialized = true;
+    glfw_windows++;
+
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, window->major_ver);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, window->minor_ver);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, window->debug ? GLFW_TRUE : GLFW_FALSE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+    window->handle = glfwCreateWindow(window->width, window->height, title ? title : "", NULL, share);
+    if (!window->handle) {
+        WINDOW_LOG(GLT_LOG_ERROR, "failed to create GLFW window");
+        return false;
+    }
+    if (share) {
+        return true;
+    }
+
+    glfwMakeContextCurrent(window->handle);
+    glt_sampler_set_group(window->group);
+
+    if (!init_glad((GLADloadproc) glfwGetProcAddress)) {
+        return false;
+    }
+
+    if (visible) {
+        glfwSwapInterval(1); // VSync
+
+        glfwGetFramebufferSize(window->handle, &window->framebuffer_width, &window->framebuffer_height);
+        glViewport(0, 0, window->framebuffer_width, window->framebuffer_height);
+        glfwSetWindowUserPointer(window->handle, window);
+        glfwSetFramebufferSizeCallback(window->handle, framebuffer_size_callback);
+        glfwSetKeyCallback(window->handle, key_callback);
+        glfwSetCharCallback(window->handle, char_callback);
+        glfwSetMouseButtonCallback(window->handle, mouse_button_callback);
+        glfwSetCursorPosCallback(window->handle, cursor_pos_callback);
+        glfwSetScrollCallback(window->handle, scroll_callback);
+        glfwSetWindowFocusCallback(window->handle, focus_callback);
+        glfwSetWindowCloseCallback(window->handle, close_callback);
+    }
+    return true;
+}
+
+static bool create_offscreen(glt_window_t *window) {
+    glGenFramebuffers(1, &window->fbo);
+    glGenRenderbuffers(2, window->renderbuffers);
+    if (!window->fbo || !window->renderbuffers[0] || !window->renderbuffers[1]) {
+        WINDOW_LOG(GLT_LOG_ERROR, "failed to create offscreen framebuffer");
+        return false;
+    }
+
+    glBindRenderbuffer(GL_RENDERBUFFER, window->renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, window->width, window->height);
+    glBindRenderbuffer(GL_RENDERBUFFER, window->renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, window->width, window->height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, window->fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, window->renderbuffers[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, window->renderbuffers[1]);
+
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        WINDOW_LOG(GLT_LOG_ERROR, "offscreen framebuffer is incomplete: 0x%04X", status);
+        return false;
+    }
+
+    glViewport(0, 0, window->width, window->height);
+    return true;
+}
+
+static bool make_current(const glt_window_t *window) {
+    if (!window) {
+        return false;
+    }
+#ifdef GLT_HAS_EGL
+    if (window->egl_context != EGL_NO_CONTEXT) {
+        if (!eglMakeCurrent(window->egl_display, window->egl_surface, window->egl_surface, window->egl_context)) {
+            return false;
+        }
+        glt_sampler_set_group(window->group);
+        return true;
+    }
+#endif
+    if (window->handle) {
+        glfwMakeContextCurrent(window->handle);
+        glt_sampler_set_group(window->group);
+        return true;
+    }
+    return false;
+}
+
+static void release_current(void) {
+    glt_sampler_set_group(NULL);
+#ifdef GLT_HAS_EGL
+    if (eglGetCurrentContext() != EGL_NO_CONTEXT) {
+        eglMakeCurrent(eglGetCurrentDisplay(), EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        return;
+    }
+#endif
+    if (glfw_windows > 0) {
+        glfwMakeContextCurrent(NULL);
+    }
+}
+
+static saved_context_t save_current(void) {
+    saved_context_t saved = {
+        .glfw = glfw_windows > 0 ? glfwGetCurrentContext() : NULL,
+        .group = glt_sampler_get_group(),
+    };
+#ifdef GLT_HAS_EGL
+    saved.egl_display = eglGetCurrentDisplay();
+    saved.egl_draw = eglGetCurrentSurface(EGL_DRAW);
+    saved.egl_read = eglGetCurrentSurface(EGL_READ);
+    saved.egl_context = eglGetCurrentContext();
+#endif
+    return saved;
+}
+
+static void restore_current(const saved_context_t *saved, const glt_window_t *destroyed) {
+    bool was_destroyed = saved->glfw && saved->glfw == destroyed->handle;
+#ifdef GLT_HAS_EGL
+    was_destroyed = was_destroyed
+                    || (saved->egl_context != EGL_NO_CONTEXT && saved->egl_context == destroyed->egl_context);
+#endif
+    release_current();
+    if (was_destroyed) {
+        return;
+    }
+
+#ifdef GLT_HAS_EGL
+    if (saved->egl_context != EGL_NO_CONTEXT) {
+        eglMakeCurrent(saved->egl_display, saved->egl_draw, saved->egl_read, saved->egl_context);
+    } else
+#endif
+    if (saved->glfw) {
+        glfwMakeContextCurrent(saved->glfw);
+    }
+    glt_sampler_set_group(saved->group);
+}
+
+#ifdef GLT_HAS_EGL
+static bool create_egl_context(glt_window_t *window, EGLContext share) {
+    EGLDisplay display = EGL_NO_DISPLAY;
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+    // surfaceless needs neither a display server nor a GPU, llvmpipe renders into the fbo
+    const PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (get_platform_display) {
+        display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+#endif
+    if (display == EGL_NO_DISPLAY) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    EGLint egl_major = 0, egl_minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &egl_major, &egl_minor)) {
+        WINDOW_LOG(GLT_LOG_WARNING, "failed to initialize EGL");
+        return false;
+    }
+    egl_display_refs++;
+    window->egl_display = display;
+
+    const EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint count = 0;
+    if (!eglChooseConfig(display, config_attribs, &config, 1, &count) || count == 0 || !eglBindAPI(EGL_OPENGL_API)) {
+        WINDOW_LOG(GLT_LOG_WARNING, "no EGL config with desktop OpenGL");
+        destroy_egl_context(window);
+        return false;
+    }
+
+    const EGLint context_attribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, window->major_ver,
+        EGL_CONTEXT_MINOR_VERSION, window->minor_ver,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        // KHR_create_context flags, accepted by EGL 1.4 and 1.5 alike
+        EGL_CONTEXT_FLAGS_KHR, window->debug ? EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR : 0,
+        EGL_NONE
+    };
+    window->egl_context = eglCreateContext(display, config, share, context_attribs);
+    if (window->egl_context == EGL_NO_CONTEXT) {
+        WINDOW_LOG(GLT_LOG_WARNING, "failed to create EGL context for OpenGL %d.%d", window->major_ver, window->minor_ver);
+        destroy_egl_context(window);
+        return false;
+    }
+
+    // without surfaceless contexts a 1x1 pbuffer stands in, the fbo is the real target either way
+    const char *extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!extensions || !strstr(extensions, "EGL_KHR_surfaceless_context")) {
+        const EGLint pbuffer_attribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+        window->egl_surface = eglCreatePbufferSurface(display, config, pbuffer_attribs);
+    }
+    if (share != EGL_NO_CONTEXT) {
+        return true;
+    }
+
+    if (!make_current(window) || !init_glad((GLADloadproc) eglGetProcAddress)) {
+        WINDOW_LOG(GLT_LOG_WARNING, "failed to make the EGL context current");
+        destroy_egl_context(window);
+        return false;
+    }
+    return true;
+}
+
+static void destroy_egl_context(glt_window_t *window) {
+    if (window->egl_display == EGL_NO_DISPLAY) {
+        return;
+    }
+    if (window->egl_context != EGL_NO_CONTEXT && eglGetCurrentContext() == window->egl_context) {
+        eglMakeCurrent(window->egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+    if (window->egl_surface != EGL_NO_SURFACE) {
+        eglDestroySurface(window->egl_display, window->egl_surface);
+    }
+    if (window->egl_context != EGL_NO_CONTEXT) {
+        eglDestroyContext(window->egl_display, window->egl_context);
+    }
+    if (--egl_display_refs == 0) {
+        eglTerminate(window->egl_display);
+    }
+    window->egl_display = EGL_NO_DISPLAY;
+    window->egl_context = EGL_NO_CONTEXT;
+    window->egl_surface = EGL_NO_SURFACE;
+}
+#endif
@@ -0,0 +1,337 @@
+#include "glt_bundle.h"
+#include "glt_bundle_format.h"
+#include "glt_container.h"
+#include "glt_image.h"
+#include "glt_texture_internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stb_image.h"
+
+// glt_pack <out.gltb> [-t|-s|-v|-i|-b] <name> <path> ...
+//
+//   -t  texture: png/jpg/tga/bmp are decoded to RGBA8 with a box-filtered mip chain,
+//       KTX2/DDS keep their stored format and levels
+//   -s  shader source, stage from the extension (.vert .frag .geom .comp .tesc .tese)
+//   -v  vertex data, stored as is
+//   -i  32-bit indices, stored as is
+//   -b  anything else, stored as is
+
+typedef struct {
+    glt_bundle_toc_entry_t toc;
+    unsigned char *payload;
+    size_t payload_size;
+} item_t;
+
+static bool pack_texture(item_t *item, const char *path);
+
+static bool pack_shader(item_t *item, const char *path);
+
+static bool pack_raw(item_t *item, const char *path, glt_bundle_entry_type_e type);
+
+static unsigned char *build_rgba_chain(const unsigned char *pixels, int width, int height, int *levels, size_t *size);
+
+static int compare_items(const void *a, const void *b);
+
+static bool write_bundle(const char *path, item_t *items, int count);
+
+static bool write_padding(FILE *f, uint64_t from, uint64_t to);
+
+int main(int argc, char **argv) {
+    if (argc < 5 || (argc - 2) % 3 != 0) {
+        fprintf(stderr, "usage: %s <out.gltb> [-t|-s|-v|-i|-b] <name> <path> ...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const int count = (argc - 2) / 3;
+    item_t *items = calloc((size_t) count, sizeof(item_t));
+    if (!items) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    bool ok = true;
+    for (int i = 0; i < count && ok; ++i) {
+        const char *kind = argv[2 + i * 3];
+        const char *name = argv[3 + i * 3];
+        const char *path = argv[4 + i * 3];
+
+        if (strlen(name) >= GLT_BUNDLE_NAME_MAX) {
+            fprintf(stderr, "name '%s' is longer than %d characters\n", name, GLT_BUNDLE_NAME_MAX - 1);
+            ok = false;
+            break;
+        }
+        strcpy(items[i].toc.name, name);
+
+        if (strcmp(kind, "-t") == 0) {
+            ok = pack_texture(&items[i], path);
+        } else if (strcmp(kind, "-s") == 0) {
+            ok = pack_shader(&items[i], path);
+        } else if (strcmp(kind, "-v") == 0) {
+            ok = pack_raw(&items[i], path, GLT_BUNDLE_VERTICES);
+        } else if (strcmp(kind, "-i") == 0) {
+            ok = pack_raw(&items[i], path, GLT_BUNDLE_INDICES);
+            items[i].toc.internal_format = GL_UNSIGNED_INT;
+        } else if (strcmp(kind, "-b") == 0) {
+            ok = pack_raw(&items[i], path, GLT_BUNDLE_BLOB);
+        } else {
+            fprintf(stderr, "unknown entry kind '%s'\n", kind);
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "failed to pack '%s' from '%s'\n", name, path);
+        }
+    }
+
+    if (ok) {
+        qsort(items, (size_t) count, sizeof(item_t), compare_items);
+        for (int i = 1; i < count && ok; ++i) {
+            if (strcmp(items[i - 1].toc.name, items[i].toc.name) == 0) {
+                fprintf(stderr, "duplicate name '%s'\n", items[i].toc.name);
+                ok = false;
+            }
+        }
+    }
+
+    if (ok) {
+        ok = write_bundle(argv[1], items, count);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        free(items[i].payload);
+    }
+    free(items);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static bool pack_texture(item_t *item, const char *path) {
+    size_t size = 0;
+    unsigned char *data = glt_texture_read_file(path, &size);
+    if (!data) {
+        return false;
+    }
+
+    item->toc.type = GLT_BUNDLE_TEXTURE;
+
+    if (glt_container_is_known(data, size)) {
+        glt_container_t container;
+        if (!glt_container_parse(data, size, &container)) {
+            free(data);
+            return false;
+        }
+
+        size_t total = 0;
+        for (GLint i = 0; i < container.levels; ++i) {
+            total = (size_t) glt_bundle_align(total + container.level[i].size);
+        }
+        item->payload = calloc(1, total);
+        if (!item->payload) {
+            free(data);
+            return false;
+        }
+
+        size_t offset = 0;
+        for (GLint i = 0; i < container.levels; ++i) {
+            memcpy(item->payload + offset, container.level[i].data, container.level[i].size);
+            offset = (size_t) glt_bundle_align(offset + container.level[i].size);
+        }
+
+        item->payload_size = total;
+        item->toc.internal_format = container.internal_format;
+        item->toc.format = container.format;
+        item->toc.pixel_type = container.type;
+        item->toc.texel_bytes = container.compressed
+                                    ? 0
+                                    : (uint32_t) (container.level[0].size /
+                                                  ((size_t) container.width * (size_t) container.height));
+        item->toc.width = (uint32_t) container.width;
+        item->toc.height = (uint32_t) container.height;
+        item->toc.levels = (uint32_t) container.levels;
+        free(data);
+        return true;
+    }
+
+    // same orientation as glt_texture_load
+    int width = 0, height = 0, channels = 0;
+    unsigned char *pixels = stbi_load_from_memory(data, (int) size, &width, &height, &channels, 4);
+    free(data);
+    if (!pixels) {
+        fprintf(stderr, "%s: %s\n", path, stbi_failure_reason());
+        return false;
+    }
+    glt_image_flip_vertical(pixels, width, height, 4);
+
+    int levels = 0;
+    item->payload = build_rgba_chain(pixels, width, height, &levels, &item->payload_size);
+    stbi_image_free(pixels);
+    if (!item->payload) {
+        return false;
+    }
+
+    item->toc.internal_format = GL_RGBA8;
+    item->toc.format = GL_RGBA;
+    item->toc.pixel_type = GL_UNSIGNED_BYTE;
+    item->toc.texel_bytes = 4;
+    item->toc.width = (uint32_t) width;
+    item->toc.height = (uint32_t) height;
+    item->toc.levels = (uint32_t) levels;
+    return true;
+}
+
+static bool pack_shader(item_t *item, const char *path) {
+    static const struct {
+        const char *ext;
+        GLenum stage;
+    } stages[] = {
+        {".vert", GL_VERTEX_SHADER},
+        {".frag", GL_FRAGMENT_SHADER},
+        {".geom", GL_GEOMETRY_SHADER},
+        {".comp", GL_COMPUTE_SHADER},
+        {".tesc", GL_TESS_CONTROL_SHADER},
+        {".tese", GL_TESS_EVALUATION_SHADER},
+    };
+
+    const char *ext = strrchr(path, '.');
+    GLenum stage = 0;
+    for (size_t i = 0; ext && i < sizeof(stages) / sizeof(stages[0]); ++i) {
+        if (strcmp(ext, stages[i].ext) == 0) {
+            stage = stages[i].stage;
+        }
+    }
+    if (!stage) {
+        fprintf(stderr, "%s: can't tell the shader stage from the extension\n", path);
+        return false;
+    }
+
+    size_t size = 0;
+    item->payload = glt_texture_read_file(path, &size);
+    if (!item->payload) {
+        return false;
+    }
+
+    // stored with its terminator so it compiles straight from the mapping
+    item->payload_size = size + 1;
+    item->toc.type = GLT_BUNDLE_SHADER;
+    item->toc.internal_format = stage;
+    return true;
+}
+
+static bool pack_raw(item_t *item, const char *path, glt_bundle_entry_type_e type) {
+    size_t size = 0;
+    item->payload = glt_texture_read_file(path, &size);
+    if (!item->payload) {
+        return false;
+    }
+    item->payload_size = size;
+    item->toc.type = type;
+    return true;
+}
+
+static unsigned char *build_rgba_chain(const unsigned char *pixels, int width, int height, int *levels, size_t *size) {
+    int count = 1;
+    size_t total = (size_t) glt_bundle_align((uint64_t) width * (uint64_t) height * 4);
+    for (int w = width, h = height; (w > 1 || h > 1) && count < GLT_CONTAINER_MAX_LEVELS; ++count) {
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+        total += (size_t) glt_bundle_align((uint64_t) w * (uint64_t) h * 4);
+    }
+
+    unsigned char *chain = calloc(1, total);
+    if (!chain) {
+        return NULL;
+    }
+    memcpy(chain, pixels, (size_t) width * (size_t) height * 4);
+
+    // 2x2 box filter, odd edges repeat their last texel
+    size_t offset = 0;
+    int w = width, h = height;
+    for (int level = 1; level < count; ++level) {
+        const unsigned char *src = chain + offset;
+        const int nw = w > 1 ? w / 2 : 1;
+        const int nh = h > 1 ? h / 2 : 1;
+        offset += (size_t) glt_bundle_align((uint64_t) w * (uint64_t) h * 4);
+        unsigned char *dst = chain + offset;
+
+        for (int y = 0; y < nh; ++y) {
+            const int y0 = y * 2 < h ? y * 2 : h - 1;
+            const int y1 = y * 2 + 1 < h ? y * 2 + 1 : h - 1;
+            for (int x = 0; x < nw; ++x) {
+                const int x0 = x * 2 < w ? x * 2 : w - 1;
+                const int x1 = x * 2 + 1 < w ? x * 2 + 1 : w - 1;
+                for (int c = 0; c < 4; ++c) {
+                    const int sum = src[((size_t) y0 * w + x0) * 4 + c] + src[((size_t) y0 * w + x1) * 4 + c] +
+                                    src[((size_t) y1 * w + x0) * 4 + c] + src[((size_t) y1 * w + x1) * 4 + c];
+                    dst[((size_t) y * nw + x) * 4 + c] = (unsigned char) ((sum + 2) / 4);
+                }
+            }
+        }
+        w = nw;
+        h = nh;
+    }
+
+    *levels = count;
+    *size = total;
+    return chain;
+}
+
+static int compare_items(const void *a, const void *b) {
+    return strcmp(((const item_t *) a)->toc.name, ((const item_t *) b)->toc.name);
+}
+
+static bool write_bundle(const char *path, item_t *items, int count) {
+    uint64_t offset = glt_bundle_align(sizeof(glt_bundle_header_t));
+    for (int i = 0; i < count; ++i) {
+        items[i].toc.offset = offset;
+        items[i].toc.size = items[i].payload_size;
+        offset = glt_bundle_align(offset + items[i].payload_size);
+    }
+
+    glt_bundle_header_t header = {0};
+    memcpy(header.magic, GLT_BUNDLE_MAGIC, 4);
+    header.version = GLT_BUNDLE_VERSION;
+    header.entry_count = (uint32_t) count;
+    header.toc_offset = offset;
+    header.file_size = offset + (uint64_t) count * sizeof(glt_bundle_toc_entry_t);
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "can't open '%s' for writing\n", path);
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    uint64_t pos = sizeof(header);
+    for (int i = 0; i < count && ok; ++i) {
+        ok = write_padding(f, pos, items[i].toc.offset) &&
+             fwrite(items[i].payload, 1, items[i].payload_size, f) == items[i].payload_size;
+        pos = items[i].toc.offset + items[i].payload_size;
+    }
+    ok = ok && write_padding(f, pos, header.toc_offset);
+    for (int i = 0; i < count && ok; ++i) {
+        ok = fwrite(&items[i].toc, sizeof(glt_bundle_toc_entry_t), 1, f) == 1;
+    }
+
+    if (fclose(f) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        fprintf(stderr, "failed to write '%s'\n", path);
+        remove(path);
+    }
+    return ok;
+}
+
+static bool write_padding(FILE *f, uint64_t from, uint64_t to) {
+    static const unsigned char zeros[GLT_BUNDLE_ALIGNMENT] = {0};
+    while (from < to) {
+        const size_t n = to - from < sizeof(zeros) ? (size_t) (to - from) : sizeof(zeros);
+        if (fwrite(zeros, 1, n, f) != n) {
+            return false;
+        }
+        from += n;
+    }
+    return true;
+}